@@ -0,0 +1,259 @@
+#include "BookSignalEngine.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace glora {
+namespace core {
+
+namespace {
+
+struct SignalMetrics {
+  Counter& samples;
+  Histogram& computeUs;
+};
+
+SignalMetrics& signalMetrics() {
+  auto& registry = MetricsRegistry::getInstance();
+  static SignalMetrics metrics{
+    registry.counter("glora_book_signal_samples_total", "Order book signal samples computed"),
+    registry.histogram("glora_book_signal_compute_us", "Time to apply a book update and compute its signals",
+                       MetricsRegistry::durationBucketsUs()),
+  };
+  return metrics;
+}
+
+// Top of one side, zero padded to kLevels so every loop is full width
+struct alignas(32) SideLevels {
+  double price[BookSignalEngine::kLevels] = {};
+  double qty[BookSignalEngine::kLevels] = {};
+  double distance[BookSignalEngine::kLevels] = {};    // From mid
+  double cumulative[BookSignalEngine::kLevels] = {};  // Size up to and including the level
+};
+
+static_assert(BookSignalEngine::kLevels % 4 == 0, "kLevels must fill whole 4-wide vectors");
+
+double dot(const double* a, const double* b) {
+#if defined(__AVX__)
+  __m256d acc = _mm256_setzero_pd();
+  for (size_t i = 0; i < BookSignalEngine::kLevels; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_load_pd(a + i), _mm256_load_pd(b + i)));
+  }
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+#else
+  double sum = 0.0;
+  for (size_t i = 0; i < BookSignalEngine::kLevels; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+#endif
+}
+
+double total(const double* a) {
+#if defined(__AVX__)
+  __m256d acc = _mm256_setzero_pd();
+  for (size_t i = 0; i < BookSignalEngine::kLevels; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_load_pd(a + i));
+  }
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+#else
+  double sum = 0.0;
+  for (size_t i = 0; i < BookSignalEngine::kLevels; ++i) {
+    sum += a[i];
+  }
+  return sum;
+#endif
+}
+
+template <typename Book>
+void copyTop(const Book& book, double mid, SideLevels& side) {
+  size_t i = 0;
+  double cumulative = 0.0;
+  for (auto it = book.begin(); it != book.end() && i < BookSignalEngine::kLevels; ++it, ++i) {
+    cumulative += it->second;
+    side.price[i] = it->first;
+    side.qty[i] = it->second;
+    side.distance[i] = std::abs(it->first - mid);
+    side.cumulative[i] = cumulative;
+  }
+}
+
+// Least squares through the origin of cumulative size on distance
+double slope(const SideLevels& side) {
+  double spread = dot(side.distance, side.distance);
+  return spread > 0.0 ? dot(side.distance, side.cumulative) / spread : 0.0;
+}
+
+} // namespace
+
+void BookSignalEngine::RollingSum::add(uint64_t timeMs, double value) {
+  entries.emplace_back(timeMs, value);
+  sum += value;
+}
+
+double BookSignalEngine::RollingSum::at(uint64_t timeMs) {
+  while (!entries.empty() && entries.front().first + kFlowWindowMs <= timeMs) {
+    sum -= entries.front().second;
+    entries.pop_front();
+  }
+  if (entries.empty()) sum = 0.0;  // Drop accumulated rounding
+  return std::max(sum, 0.0);
+}
+
+void BookSignalEngine::onBook(const std::string& symbol, const Levels& bids, const Levels& asks, uint64_t timeMs) {
+  auto& metrics = signalMetrics();
+  auto start = std::chrono::steady_clock::now();
+
+  BookSignals signals;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& state = states_[symbol];
+    for (const auto& [price, qty] : bids) {
+      if (qty == 0.0) state.bids.erase(price);
+      else state.bids[price] = qty;
+    }
+    for (const auto& [price, qty] : asks) {
+      if (qty == 0.0) state.asks.erase(price);
+      else state.asks[price] = qty;
+    }
+    if (state.bids.empty() || state.asks.empty()) return;
+
+    trackDepletion(state, timeMs);
+    signals = compute(state, timeMs);
+    state.latest = signals;
+  }
+
+  metrics.samples.inc();
+  metrics.computeUs.observe(std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count());
+
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  for (const auto& [id, listener] : listeners_) {
+    listener(symbol, signals);
+  }
+}
+
+void BookSignalEngine::onTrade(const std::string& symbol, const Tick& tick, uint64_t timeMs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& state = states_[symbol];
+  // Buyer as maker: a seller hit the bid
+  (tick.is_buyer_maker ? state.sellVolume : state.buyVolume).add(timeMs, tick.quantity);
+}
+
+void BookSignalEngine::clear(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  states_.erase(symbol);
+}
+
+std::optional<BookSignals> BookSignalEngine::latest(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = states_.find(symbol);
+  if (it == states_.end() || it->second.latest.timeMs == 0) return std::nullopt;
+  return it->second.latest;
+}
+
+size_t BookSignalEngine::addListener(Listener listener) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  size_t id = nextListenerId_++;
+  listeners_.emplace_back(id, std::move(listener));
+  return id;
+}
+
+void BookSignalEngine::removeListener(size_t id) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                  [id](const auto& entry) { return entry.first == id; }),
+                   listeners_.end());
+}
+
+void BookSignalEngine::trackDepletion(State& state, uint64_t timeMs) const {
+  auto [bid, bidQty] = *state.bids.begin();
+  auto [ask, askQty] = *state.asks.begin();
+
+  // Size that left the touch: a smaller queue at the same price, or the
+  // whole queue when the touch moved away from the spread
+  if (state.touchBid > 0.0) {
+    if (bid == state.touchBid && bidQty < state.touchBidQty) {
+      state.bidDepleted.add(timeMs, state.touchBidQty - bidQty);
+    } else if (bid < state.touchBid) {
+      state.bidDepleted.add(timeMs, state.touchBidQty);
+    }
+  }
+  if (state.touchAsk > 0.0) {
+    if (ask == state.touchAsk && askQty < state.touchAskQty) {
+      state.askDepleted.add(timeMs, state.touchAskQty - askQty);
+    } else if (ask > state.touchAsk) {
+      state.askDepleted.add(timeMs, state.touchAskQty);
+    }
+  }
+
+  state.touchBid = bid;
+  state.touchBidQty = bidQty;
+  state.touchAsk = ask;
+  state.touchAskQty = askQty;
+}
+
+BookSignals BookSignalEngine::compute(State& state, uint64_t timeMs) const {
+  BookSignals s;
+  s.timeMs = timeMs;
+  s.bestBid = state.touchBid;
+  s.bestAsk = state.touchAsk;
+  s.spread = s.bestAsk - s.bestBid;
+  s.mid = (s.bestBid + s.bestAsk) / 2.0;
+
+  double touchSize = state.touchBidQty + state.touchAskQty;
+  s.microprice = touchSize > 0.0
+      ? (s.bestBid * state.touchAskQty + s.bestAsk * state.touchBidQty) / touchSize
+      : s.mid;
+
+  SideLevels bids;
+  SideLevels asks;
+  copyTop(state.bids, s.mid, bids);
+  copyTop(state.asks, s.mid, asks);
+
+  double bidSize = total(bids.qty);
+  double askSize = total(asks.qty);
+  double size = bidSize + askSize;
+  if (size > 0.0) {
+    s.imbalance = (bidSize - askSize) / size;
+    s.weightedMid = (dot(bids.price, bids.qty) + dot(asks.price, asks.qty)) / size;
+  } else {
+    s.weightedMid = s.mid;
+  }
+  s.bidSlope = slope(bids);
+  s.askSlope = slope(asks);
+
+  double windowSeconds = kFlowWindowMs / 1000.0;
+  s.bidDepletionRate = state.bidDepleted.at(timeMs) / windowSeconds;
+  s.askDepletionRate = state.askDepleted.at(timeMs) / windowSeconds;
+  double buy = state.buyVolume.at(timeMs);
+  double sell = state.sellVolume.at(timeMs);
+  s.tradeImbalance = buy + sell > 0.0 ? (buy - sell) / (buy + sell) : 0.0;
+
+  // Spread ring: replace the oldest once full
+  if (state.spreads.size() < kSpreadWindow) {
+    state.spreads.push_back(s.spread);
+  } else {
+    double oldest = state.spreads[state.spreadHead];
+    state.spreadSum -= oldest;
+    state.spreadSumSq -= oldest * oldest;
+    state.spreads[state.spreadHead] = s.spread;
+    state.spreadHead = (state.spreadHead + 1) % kSpreadWindow;
+  }
+  state.spreadSum += s.spread;
+  state.spreadSumSq += s.spread * s.spread;
+  double n = static_cast<double>(state.spreads.size());
+  s.spreadMean = state.spreadSum / n;
+  s.spreadStdDev = std::sqrt(std::max(state.spreadSumSq / n - s.spreadMean * s.spreadMean, 0.0));
+  return s;
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "DataModels.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// One sample of order book microstructure, computed on every book update
+struct BookSignals {
+  uint64_t timeMs = 0;
+  double bestBid = 0.0;
+  double bestAsk = 0.0;
+  double spread = 0.0;
+  double mid = 0.0;
+  double microprice = 0.0;       // Touch prices weighted by the opposite queue
+  double weightedMid = 0.0;      // Size-weighted price of the top levels
+  double imbalance = 0.0;        // (bid - ask) / (bid + ask) over the top levels, -1..1
+  double bidSlope = 0.0;         // Cumulative size per unit of distance from mid
+  double askSlope = 0.0;
+  double bidDepletionRate = 0.0; // Size leaving the best bid per second (trades and cancels)
+  double askDepletionRate = 0.0;
+  double tradeImbalance = 0.0;   // (aggressive buy - sell) / total over the flow window
+  double spreadMean = 0.0;       // Over the last kSpreadWindow updates
+  double spreadStdDev = 0.0;
+};
+
+// Order book microstructure signals per symbol, fed by L2 updates and trades.
+//
+// The engine keeps its own price-ordered copy of each book. After every
+// update the top kLevels of each side are copied into fixed arrays and the
+// size sums, weighted prices and pressure slopes are dot products over them
+// (AVX when the build targets it). Depletion, trade flow and spread
+// statistics are running sums over rolling windows, so a sample is O(1) in
+// history and O(kLevels) in the book.
+//
+// Listeners get every sample at full update rate on the updating thread, for
+// alerts, backtests and the chart publisher.
+class BookSignalEngine {
+public:
+  static constexpr size_t kLevels = 16;
+  static constexpr uint64_t kFlowWindowMs = 5000;
+  static constexpr size_t kSpreadWindow = 256;
+
+  using Levels = std::vector<std::pair<double, double>>;
+  using Listener = std::function<void(const std::string& symbol, const BookSignals& signals)>;
+
+  // Apply bid/ask changes (quantity 0 removes the level) and compute a sample
+  void onBook(const std::string& symbol, const Levels& bids, const Levels& asks, uint64_t timeMs);
+
+  // Count an aggressive trade into the flow window. timeMs must be on the
+  // same clock as onBook's, since the window is evaluated at book times.
+  void onTrade(const std::string& symbol, const Tick& tick, uint64_t timeMs);
+
+  void clear(const std::string& symbol);
+
+  std::optional<BookSignals> latest(const std::string& symbol) const;
+
+  // Returns an id for removeListener
+  size_t addListener(Listener listener);
+  void removeListener(size_t id);
+
+private:
+  // Sum of values added within the last kFlowWindowMs
+  struct RollingSum {
+    std::deque<std::pair<uint64_t, double>> entries;
+    double sum = 0.0;
+
+    void add(uint64_t timeMs, double value);
+    double at(uint64_t timeMs);
+  };
+
+  struct State {
+    std::map<double, double, std::greater<double>> bids;
+    std::map<double, double> asks;
+    double touchBid = 0.0;
+    double touchBidQty = 0.0;
+    double touchAsk = 0.0;
+    double touchAskQty = 0.0;
+    RollingSum bidDepleted;
+    RollingSum askDepleted;
+    RollingSum buyVolume;
+    RollingSum sellVolume;
+    std::vector<double> spreads;  // Ring of kSpreadWindow
+    size_t spreadHead = 0;
+    double spreadSum = 0.0;
+    double spreadSumSq = 0.0;
+    BookSignals latest;
+  };
+
+  BookSignals compute(State& state, uint64_t timeMs) const;
+  void trackDepletion(State& state, uint64_t timeMs) const;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, State> states_;
+
+  std::mutex listenersMutex_;
+  std::vector<std::pair<size_t, Listener>> listeners_;
+  size_t nextListenerId_ = 1;
+};
+
+} // namespace core
+} // namespace glora
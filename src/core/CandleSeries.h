@@ -0,0 +1,291 @@
+#pragma once
+
+#include "DataModels.h"
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Time-ordered candle storage in fixed-size pages.
+//
+// Candles live in pages of kPageSize slots that are allocated once and never
+// reallocated, so appending never moves existing candles and trimming the
+// oldest history releases whole pages instead of shifting the series. Older
+// history is prepended the same way: into the free slots before the front
+// page's first candle, then into new pages pushed in front.
+// Footprint levels are allocated from a pool owned by the series, which keeps
+// them together in memory and recycles the storage of trimmed candles.
+//
+// Not thread safe; the owner guards it like any other container.
+class CandleSeries {
+public:
+  static constexpr size_t kPageSize = 4096;
+
+  template <bool Const>
+  class Iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Candle;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Candle*, Candle*>;
+    using reference = std::conditional_t<Const, const Candle&, Candle&>;
+    using Series = std::conditional_t<Const, const CandleSeries, CandleSeries>;
+
+    Iterator() = default;
+    Iterator(Series* series, size_t index) : series_(series), index_(index) {}
+    operator Iterator<true>() const { return Iterator<true>(series_, index_); }
+
+    reference operator*() const { return (*series_)[index_]; }
+    pointer operator->() const { return &(*series_)[index_]; }
+    reference operator[](difference_type n) const { return (*series_)[index_ + n]; }
+
+    Iterator& operator++() { ++index_; return *this; }
+    Iterator operator++(int) { Iterator tmp = *this; ++index_; return tmp; }
+    Iterator& operator--() { --index_; return *this; }
+    Iterator operator--(int) { Iterator tmp = *this; --index_; return tmp; }
+    Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+    Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(series_, index_ + n); }
+    Iterator operator-(difference_type n) const { return Iterator(series_, index_ - n); }
+    friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+    difference_type operator-(const Iterator& other) const {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const Iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+    bool operator<(const Iterator& other) const { return index_ < other.index_; }
+    bool operator>(const Iterator& other) const { return index_ > other.index_; }
+    bool operator<=(const Iterator& other) const { return index_ <= other.index_; }
+    bool operator>=(const Iterator& other) const { return index_ >= other.index_; }
+
+  private:
+    Series* series_ = nullptr;
+    size_t index_ = 0;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  CandleSeries() : footprintPool_(std::make_unique<std::pmr::unsynchronized_pool_resource>()) {}
+
+  // Candles hold pointers into the pool, which moves with the series
+  CandleSeries(CandleSeries&& other) noexcept
+      : footprintPool_(std::move(other.footprintPool_)),
+        pages_(std::move(other.pages_)),
+        head_(std::exchange(other.head_, 0)),
+        size_(std::exchange(other.size_, 0)) {}
+  CandleSeries& operator=(CandleSeries&& other) noexcept {
+    if (this != &other) {
+      clear();  // Our candles must go before the pool they allocate from
+      footprintPool_ = std::move(other.footprintPool_);
+      pages_ = std::move(other.pages_);
+      head_ = std::exchange(other.head_, 0);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+  CandleSeries(const CandleSeries&) = delete;
+  CandleSeries& operator=(const CandleSeries&) = delete;
+
+  ~CandleSeries() { clear(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  Candle& operator[](size_t index) {
+    size_t slot = head_ + index;
+    return pages_[slot / kPageSize]->candles[slot % kPageSize];
+  }
+  const Candle& operator[](size_t index) const {
+    size_t slot = head_ + index;
+    return pages_[slot / kPageSize]->candles[slot % kPageSize];
+  }
+
+  Candle& front() { return (*this)[0]; }
+  const Candle& front() const { return (*this)[0]; }
+  Candle& back() { return (*this)[size_ - 1]; }
+  const Candle& back() const { return (*this)[size_ - 1]; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size_); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+
+  // Append a candle; its footprint is copied into the series pool
+  void push_back(const Candle& candle) { emplaceSlot() = candle; ++size_; }
+
+  // Append a candle; footprint storage is adopted when it already lives in
+  // the series pool and copied into it otherwise
+  void push_back(Candle&& candle) { emplaceSlot() = std::move(candle); ++size_; }
+
+  // Drop the newest candle
+  void pop_back() {
+    if (size_ == 0) return;
+    --size_;
+    size_t slot = head_ + size_;
+    Page& page = *pages_[slot / kPageSize];
+    page.candles.pop_back();
+    if (page.candles.empty()) {
+      pages_.pop_back();
+      if (pages_.empty()) head_ = 0;
+    }
+  }
+
+  // Keep only the newest `count` candles. Whole pages are released at once,
+  // so the cost is independent of the number of candles kept.
+  void trimFront(size_t count) {
+    if (size_ <= count) return;
+    size_t drop = size_ - count;
+
+    while (!pages_.empty() && head_ + drop >= pages_.front()->candles.size()) {
+      size_t pageLive = pages_.front()->candles.size() - head_;
+      drop -= pageLive;
+      size_ -= pageLive;
+      pages_.pop_front();
+      head_ = 0;
+    }
+
+    if (drop > 0) {
+      // Dead slots stay until their page goes, but give their levels back now
+      Page& page = *pages_.front();
+      for (size_t i = head_; i < head_ + drop; ++i) {
+        page.candles[i].footprint_profile.release();
+      }
+      head_ += drop;
+      size_ -= drop;
+    }
+  }
+
+  // Keep only the oldest `count` candles
+  void truncate(size_t count) {
+    while (size_ > count) {
+      pop_back();
+    }
+  }
+
+  void clear() {
+    pages_.clear();
+    head_ = 0;
+    size_ = 0;
+  }
+
+  // Merge time-sorted candles in. Candles with an existing start time replace
+  // the stored ones. Only the tail from the first affected candle onwards is
+  // rewritten: O(k + m) for k affected candles and m new ones.
+  void mergeSorted(std::vector<Candle>&& incoming) {
+    if (incoming.empty()) return;
+
+    // Fast path: everything is newer than what we hold
+    if (empty() || incoming.front().start_time_ms > back().start_time_ms) {
+      for (auto& candle : incoming) {
+        push_back(std::move(candle));
+      }
+      return;
+    }
+
+    uint64_t firstTime = incoming.front().start_time_ms;
+    auto split = std::lower_bound(begin(), end(), firstTime,
+                                  [](const Candle& c, uint64_t time) { return c.start_time_ms < time; });
+    size_t splitIndex = static_cast<size_t>(split - begin());
+
+    // Stored candles from the split point, copied out before truncating
+    std::vector<Candle> tail;
+    tail.reserve(size_ - splitIndex);
+    for (size_t i = splitIndex; i < size_; ++i) {
+      tail.push_back((*this)[i]);
+    }
+    truncate(splitIndex);
+
+    auto existing = tail.begin();
+    auto added = incoming.begin();
+    while (existing != tail.end() && added != incoming.end()) {
+      if (existing->start_time_ms < added->start_time_ms) {
+        push_back(std::move(*existing++));
+      } else if (added->start_time_ms < existing->start_time_ms) {
+        push_back(std::move(*added++));
+      } else {
+        push_back(std::move(*added++));
+        ++existing;
+      }
+    }
+    for (; existing != tail.end(); ++existing) push_back(std::move(*existing));
+    for (; added != incoming.end(); ++added) push_back(std::move(*added));
+  }
+
+  // Put time-sorted candles older than front() before it without touching
+  // the stored ones. Candles at or after front() are ignored.
+  void prependSorted(std::vector<Candle>&& older) {
+    if (empty()) {
+      mergeSorted(std::move(older));
+      return;
+    }
+
+    uint64_t frontTime = front().start_time_ms;
+    size_t i = static_cast<size_t>(
+        std::lower_bound(older.begin(), older.end(), frontTime,
+                         [](const Candle& c, uint64_t time) { return c.start_time_ms < time; }) -
+        older.begin());
+    while (i > 0) {
+      if (head_ == 0) {
+        // A full page of free slots, filled from the back
+        auto page = std::make_unique<Page>();
+        page->candles.reserve(kPageSize);
+        for (size_t slot = 0; slot < kPageSize; ++slot) {
+          page->candles.emplace_back(footprintPool_.get());
+        }
+        pages_.push_front(std::move(page));
+        head_ = kPageSize;
+      }
+      pages_.front()->candles[--head_] = std::move(older[--i]);
+      ++size_;
+    }
+  }
+
+  // Replace the contents with time-sorted candles
+  void assign(const std::vector<Candle>& candles) {
+    clear();
+    for (const auto& candle : candles) {
+      push_back(candle);
+    }
+  }
+
+  // Number of allocated pages (for diagnostics)
+  size_t pageCount() const { return pages_.size(); }
+
+private:
+  struct Page {
+    // Reserved to kPageSize up front and never grown past it, so candle
+    // addresses stay stable for the lifetime of the page
+    std::vector<Candle> candles;
+  };
+
+  // Construct the next slot with the series pool and return it
+  Candle& emplaceSlot() {
+    if (!footprintPool_) {
+      footprintPool_ = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+    }
+    if (pages_.empty() || pages_.back()->candles.size() == kPageSize) {
+      auto page = std::make_unique<Page>();
+      page->candles.reserve(kPageSize);
+      pages_.push_back(std::move(page));
+    }
+    return pages_.back()->candles.emplace_back(footprintPool_.get());
+  }
+
+  // Declared first so it outlives the pages that allocate from it
+  std::unique_ptr<std::pmr::unsynchronized_pool_resource> footprintPool_;
+  std::deque<std::unique_ptr<Page>> pages_;
+  size_t head_ = 0;  // Logically removed slots at the start of the front page
+  size_t size_ = 0;
+};
+
+} // namespace core
+} // namespace glora
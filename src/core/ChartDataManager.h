@@ -1,6 +1,8 @@
 #pragma once
 
 #include "DataModels.h"
+#include "CandleSeries.h"
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
@@ -22,20 +24,31 @@ enum class Timeframe {
 
 class ChartDataManager {
 public:
+  // History eviction never shrinks the series below this
+  static constexpr size_t kMinResidentCandles = 2000;
+
   ChartDataManager(Timeframe timeframe = Timeframe::M1)
       : timeframe_(static_cast<uint64_t>(timeframe)) {}
 
   // Add a tick and return the current candle
   void addTick(const Tick &tick);
 
-  // Get all candles
-  const std::vector<Candle> &getCandles() const { return candles_; }
+  // Ticks are added on another thread: hold this lock for as long as
+  // references from getCandles()/getCurrentCandle() are in use, and don't
+  // call the other (locking) members meanwhile
+  std::unique_lock<std::mutex> lockCandles() const {
+    return std::unique_lock<std::mutex>(mutex_);
+  }
+
+  // Get all candles (under lockCandles())
+  const CandleSeries &getCandles() const { return candles_; }
 
-  // Get the current (in-progress) candle
+  // Get the current (in-progress) candle (under lockCandles())
   const Candle &getCurrentCandle() const { return currentCandle_; }
 
   // Set timeframe
   void setTimeframe(Timeframe timeframe) {
+    std::lock_guard<std::mutex> lock(mutex_);
     timeframe_ = static_cast<uint64_t>(timeframe);
     // Reset candles when timeframe changes
     candles_.clear();
@@ -51,9 +64,21 @@ public:
   // Initialize with historical data
   void setHistoricalData(const std::vector<Tick> &ticks);
 
+  // Put an older page of candles (current timeframe, time-sorted) in front
+  // of the series; stored candles are not moved or copied
+  void prependHistory(std::vector<Candle> older);
+
+  // Start of the oldest candle held, 0 when empty
+  uint64_t getOldestTime() const;
+
+  // Drop candles starting before `time`, keeping kMinResidentCandles
+  void evictBefore(uint64_t time);
+
+  uint64_t getTimeframeMs() const { return timeframe_; }
+
 private:
   uint64_t timeframe_;
-  std::vector<Candle> candles_;
+  CandleSeries candles_;
   Candle currentCandle_;
   mutable std::mutex mutex_;
 };
@@ -97,6 +122,36 @@ inline void ChartDataManager::setHistoricalData(const std::vector<Tick> &ticks)
   }
 }
 
+inline void ChartDataManager::prependHistory(std::vector<Candle> older) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // The in-progress candle is built from ticks and isn't in candles_ yet
+  if (candles_.empty() && currentCandle_.start_time_ms != 0) {
+    older.erase(std::remove_if(older.begin(), older.end(),
+                               [this](const Candle &c) {
+                                 return c.start_time_ms >= currentCandle_.start_time_ms;
+                               }),
+                older.end());
+  }
+  candles_.prependSorted(std::move(older));
+}
+
+inline uint64_t ChartDataManager::getOldestTime() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!candles_.empty()) return candles_.front().start_time_ms;
+  return currentCandle_.start_time_ms;
+}
+
+inline void ChartDataManager::evictBefore(uint64_t time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (candles_.size() <= kMinResidentCandles) return;
+
+  auto first = std::lower_bound(candles_.begin(), candles_.end(), time,
+                                [](const Candle &c, uint64_t t) { return c.start_time_ms < t; });
+  size_t keep = static_cast<size_t>(candles_.end() - first);
+  candles_.trimFront(std::max(keep, kMinResidentCandles));
+}
+
 inline std::pair<double, double> ChartDataManager::getPriceRange() const {
   std::lock_guard<std::mutex> lock(mutex_);
 
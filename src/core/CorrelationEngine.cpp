@@ -0,0 +1,205 @@
+#include "CorrelationEngine.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace glora {
+namespace core {
+
+namespace {
+
+// out[j] += a * x[j] - b * y[j] for j < n
+void rankOneUpdate(double* out, double a, const double* x, double b, const double* y, size_t n) {
+  size_t j = 0;
+#if defined(__AVX__)
+  __m256d va = _mm256_set1_pd(a);
+  __m256d vb = _mm256_set1_pd(b);
+  for (; j + 4 <= n; j += 4) {
+    __m256d acc = _mm256_loadu_pd(out + j);
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(va, _mm256_loadu_pd(x + j)));
+    acc = _mm256_sub_pd(acc, _mm256_mul_pd(vb, _mm256_loadu_pd(y + j)));
+    _mm256_storeu_pd(out + j, acc);
+  }
+#endif
+  for (; j < n; ++j) {
+    out[j] += a * x[j] - b * y[j];
+  }
+}
+
+} // namespace
+
+CorrelationEngine::CorrelationEngine(uint64_t stepMs, size_t window)
+    : stepMs_(std::max<uint64_t>(stepMs, 1)), window_(std::max<size_t>(window, 2)) {}
+
+void CorrelationEngine::setSymbols(const std::vector<std::string>& symbols) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  symbols_.clear();
+  columns_.clear();
+  for (const auto& symbol : symbols) {
+    if (symbols_.size() >= kMaxSymbols) break;
+    if (columns_.emplace(symbol, symbols_.size()).second) {
+      symbols_.push_back(symbol);
+    }
+  }
+
+  size_t n = symbols_.size();
+  lastPrice_.assign(n, 0.0);
+  stepPrice_.assign(n, 0.0);
+  step_ = 0;
+  returns_.assign(window_ * n, 0.0);
+  head_ = 0;
+  rows_ = 0;
+  rowsSinceRebuild_ = 0;
+  sums_.assign(n, 0.0);
+  crossSums_.assign(n * n, 0.0);
+}
+
+std::vector<std::string> CorrelationEngine::symbols() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return symbols_;
+}
+
+void CorrelationEngine::update(const std::string& symbol, uint64_t timeMs, double price) {
+  if (price <= 0.0) return;
+  uint64_t step = timeMs / stepMs_ + 1;
+
+  Matrix matrix;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = columns_.find(symbol);
+    if (it == columns_.end()) return;
+
+    bool closed = step_ != 0 && step > step_;
+    if (closed) {
+      closeSteps(step);
+    } else if (step_ == 0) {
+      step_ = step;
+    }
+    lastPrice_[it->second] = price;
+    if (!closed) return;
+    matrix = snapshotLocked();
+  }
+
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  for (const auto& [id, listener] : listeners_) {
+    listener(matrix);
+  }
+}
+
+void CorrelationEngine::closeSteps(uint64_t step) {
+  size_t n = symbols_.size();
+  std::vector<double> row(n, 0.0);
+  for (size_t i = 0; i < n; ++i) {
+    if (stepPrice_[i] > 0.0 && lastPrice_[i] > 0.0) {
+      row[i] = std::log(lastPrice_[i] / stepPrice_[i]);
+    }
+    if (lastPrice_[i] > 0.0) {
+      stepPrice_[i] = lastPrice_[i];
+    }
+  }
+  pushRow(row.data());
+
+  // Steps nobody traded in are flat; more than a window of them is just a reset
+  std::fill(row.begin(), row.end(), 0.0);
+  uint64_t idle = std::min<uint64_t>(step - step_ - 1, window_);
+  for (uint64_t i = 0; i < idle; ++i) {
+    pushRow(row.data());
+  }
+  step_ = step;
+}
+
+void CorrelationEngine::pushRow(const double* row) {
+  size_t n = symbols_.size();
+  double* slot = returns_.data() + head_ * n;
+
+  // Oldest row leaves the window as the new one arrives
+  std::vector<double> zeros;
+  const double* oldest = slot;
+  if (rows_ < window_) {
+    zeros.assign(n, 0.0);
+    oldest = zeros.data();
+  }
+  for (size_t i = 0; i < n; ++i) {
+    rankOneUpdate(crossSums_.data() + i * n, row[i], row, oldest[i], oldest, n);
+    sums_[i] += row[i] - oldest[i];
+  }
+
+  std::copy(row, row + n, slot);
+  head_ = (head_ + 1) % window_;
+  rows_ = std::min(rows_ + 1, window_);
+
+  // Add-then-subtract leaves rounding behind; once per window, start the
+  // sums over from the rows themselves
+  if (++rowsSinceRebuild_ >= window_) {
+    rowsSinceRebuild_ = 0;
+    std::fill(sums_.begin(), sums_.end(), 0.0);
+    std::fill(crossSums_.begin(), crossSums_.end(), 0.0);
+    std::vector<double> none(n, 0.0);
+    for (size_t r = 0; r < rows_; ++r) {
+      const double* values = returns_.data() + r * n;
+      for (size_t i = 0; i < n; ++i) {
+        rankOneUpdate(crossSums_.data() + i * n, values[i], values, 0.0, none.data(), n);
+        sums_[i] += values[i];
+      }
+    }
+  }
+}
+
+CorrelationEngine::Matrix CorrelationEngine::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return snapshotLocked();
+}
+
+CorrelationEngine::Matrix CorrelationEngine::snapshotLocked() const {
+  Matrix matrix;
+  size_t n = symbols_.size();
+  matrix.symbols = symbols_;
+  matrix.stepMs = stepMs_;
+  matrix.endTime = step_ > 0 ? (step_ - 1) * stepMs_ : 0;
+  matrix.samples = rows_;
+  matrix.correlation.assign(n * n, 0.0f);
+  matrix.covariance.assign(n * n, 0.0f);
+  matrix.beta.assign(n, 0.0f);
+  if (rows_ < 2) return matrix;
+
+  double count = static_cast<double>(rows_);
+  std::vector<double> cov(n * n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      cov[i * n + j] = (crossSums_[i * n + j] - sums_[i] * sums_[j] / count) / (count - 1.0);
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    double varI = std::max(cov[i * n + i], 0.0);
+    for (size_t j = 0; j < n; ++j) {
+      double varJ = std::max(cov[j * n + j], 0.0);
+      double denom = std::sqrt(varI * varJ);
+      double corr = denom > 0.0 ? std::clamp(cov[i * n + j] / denom, -1.0, 1.0) : 0.0;
+      matrix.correlation[i * n + j] = static_cast<float>(corr);
+      matrix.covariance[i * n + j] = static_cast<float>(cov[i * n + j]);
+    }
+    double benchmarkVar = cov[0];
+    matrix.beta[i] = benchmarkVar > 0.0 ? static_cast<float>(cov[i * n] / benchmarkVar) : 0.0f;
+  }
+  return matrix;
+}
+
+size_t CorrelationEngine::addListener(Listener listener) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  size_t id = nextListenerId_++;
+  listeners_.emplace_back(id, std::move(listener));
+  return id;
+}
+
+void CorrelationEngine::removeListener(size_t id) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                  [id](const auto& entry) { return entry.first == id; }),
+                   listeners_.end());
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Rolling correlation, covariance and beta across a set of tracked symbols.
+//
+// Prices from the tick and miniTicker streams are sampled on a fixed step
+// (1s by default). When a step closes, every tracked symbol's log return for
+// it becomes one row of a contiguous returns ring of `window` rows x N
+// columns; a symbol that did not trade contributes 0. The N x N cross
+// product sums and per-symbol sums are updated incrementally: the new row
+// is added and the row leaving the window subtracted, two rank-one updates,
+// so a step is O(N^2) (vectorised with AVX when the build targets it) no
+// matter how long the window.
+//
+// The first symbol of setSymbols() is the benchmark that betas are measured
+// against. Listeners get a fresh Matrix after every step, on the updating
+// thread, for spread and decorrelation alerts.
+class CorrelationEngine {
+public:
+  static constexpr size_t kMaxSymbols = 64;
+  static constexpr uint64_t kDefaultStepMs = 1000;
+  static constexpr size_t kDefaultWindow = 300;
+
+  struct Matrix {
+    std::vector<std::string> symbols;  // Benchmark first
+    uint64_t stepMs = 0;
+    uint64_t endTime = 0;              // End of the newest step
+    size_t samples = 0;                // Steps in the window so far
+    std::vector<float> correlation;    // symbols.size() x symbols.size(), row major
+    std::vector<float> covariance;     // Of log returns per step, same layout
+    std::vector<float> beta;           // To the benchmark, per symbol
+  };
+
+  using Listener = std::function<void(const Matrix& matrix)>;
+
+  explicit CorrelationEngine(uint64_t stepMs = kDefaultStepMs, size_t window = kDefaultWindow);
+
+  // Track these symbols (at most kMaxSymbols, benchmark first); restarts the window
+  void setSymbols(const std::vector<std::string>& symbols);
+  std::vector<std::string> symbols() const;
+
+  void update(const std::string& symbol, uint64_t timeMs, double price);
+
+  Matrix snapshot() const;
+
+  // Returns an id for removeListener
+  size_t addListener(Listener listener);
+  void removeListener(size_t id);
+
+private:
+  void closeSteps(uint64_t step);
+  void pushRow(const double* row);
+  Matrix snapshotLocked() const;
+
+  const uint64_t stepMs_;
+  const size_t window_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::string> symbols_;
+  std::unordered_map<std::string, size_t> columns_;
+  std::vector<double> lastPrice_;   // Latest price per column
+  std::vector<double> stepPrice_;   // Price at the end of the previous step
+  uint64_t step_ = 0;               // Step being filled, 0 before the first price
+  std::vector<double> returns_;     // window_ x N ring, row major
+  size_t head_ = 0;                 // Next row to write
+  size_t rows_ = 0;
+  size_t rowsSinceRebuild_ = 0;
+  std::vector<double> sums_;        // Per column
+  std::vector<double> crossSums_;   // N x N
+
+  std::mutex listenersMutex_;
+  std::vector<std::pair<size_t, Listener>> listeners_;
+  size_t nextListenerId_ = 1;
+};
+
+} // namespace core
+} // namespace glora
@@ -1,4 +1,11 @@
 #include "DataManager.h"
+#include "Tracing.h"
+#include "ThreadAffinity.h"
+#include "Metrics.h"
+#include "OverloadController.h"
+#include "../network/RequestGovernor.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -6,9 +13,18 @@
 namespace glora {
 namespace core {
 
-DataManager::DataManager() {}
+DataManager::DataManager()
+    : workerPool_(std::make_shared<ThreadPool>(
+          threadCountForRole(settings::ThreadRole::AGGREGATE, std::thread::hardware_concurrency()),
+          [](size_t index) {
+            std::string name = "glora-agg-" + std::to_string(index);
+            applyThreadRole(settings::ThreadRole::AGGREGATE, name.c_str());
+          })),
+      footprintBuilder_(workerPool_) {}
 
-DataManager::~DataManager() {}
+DataManager::~DataManager() {
+  stopSymbolRefresh();
+}
 
 bool DataManager::initialize(const settings::AppSettings& settings) {
   settings_ = settings;
@@ -24,9 +40,18 @@ void DataManager::setNetworkClient(std::shared_ptr<network::BinanceClient> clien
 
 void DataManager::setDatabase(std::shared_ptr<database::Database> db) {
   database_ = db;
+  
+  // Spans the tick index doesn't hold are paged in from the tick archive
+  tickIndex_.setLoader([db](const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                            std::vector<Tick>& out) {
+    if (db && endTime > startTime) {
+      out = db->getTicks(symbol, startTime, endTime - 1);  // getTicks is inclusive
+    }
+  });
 }
 
 void DataManager::loadSymbolData(const std::string& symbol) {
+  GLORA_TRACE_SCOPE("data", "loadSymbolData");
   if (!isInitialized_) {
     std::cerr << "DataManager not initialized" << std::endl;
     return;
@@ -37,6 +62,7 @@ void DataManager::loadSymbolData(const std::string& symbol) {
   
   // Detect and fill gaps in a background thread
   std::thread gapThread([this]() {
+    applyThreadRole(settings::ThreadRole::DECODE, "glora-gapfill");
     detectAndFillGaps();
   });
   gapThread.join(); // Properly join the thread instead of detaching
@@ -63,14 +89,19 @@ void DataManager::loadFromDatabase() {
   
   // Load candles from DB
   auto candles = database_->getCandles(currentSymbol_, startTime, now);
-  candlesBySymbol_[currentSymbol_] = candles;
+  candlesBySymbol_[currentSymbol_].assign(candles);
+  warmSymbols_.insert(currentSymbol_);
   
   std::cout << "Loaded " << candles.size() << " candles from database" << std::endl;
 }
 
 void DataManager::detectAndFillGaps() {
+  GLORA_TRACE_SCOPE("data", "detectAndFillGaps");
   if (!database_ || !networkClient_) return;
   
+  // Backfill yields REST budget to requests for what the user is looking at
+  network::ScopedRequestPriority priority(network::RequestPriority::Background);
+  
   isLoadingHistory_ = true;
   
   uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -98,8 +129,29 @@ void DataManager::detectAndFillGaps() {
     // Missing data at the beginning
     std::cout << "Fetching historical data from beginning..." << std::endl;
     fetchMissingData(startTime, latestTime.value());
+  } else if (database_->hasTradeIds(currentSymbol_, startTime, latestTime.value())) {
+    // Consecutive aggTrades have consecutive IDs, so any jump is exactly the
+    // set of missing trades - no time threshold, no quiet-market false positives
+    auto gaps = database_->detectIdGaps(currentSymbol_, startTime, latestTime.value());
+    
+    if (!gaps.empty()) {
+      std::cout << "Found " << gaps.size() << " trade ID gaps in data" << std::endl;
+      for (const auto& gap : gaps) {
+        std::cout << "Gap: trades " << gap.firstMissingId << " - " << gap.lastMissingId << std::endl;
+        fetchMissingTrades(gap);
+      }
+    } else {
+      std::cout << "No gaps found in data" << std::endl;
+    }
+    
+    if (latestTime.value() < now - 300000) { // More than 5 minutes ago
+      std::cout << "Fetching latest missing data (gap > 5 min)..." << std::endl;
+      fetchMissingData(latestTime.value(), now);
+    } else {
+      std::cout << "Data is recent enough, relying on live data stream" << std::endl;
+    }
   } else {
-    // Check for gaps in the middle
+    // Legacy rows without trade IDs: fall back to time spacing
     auto gaps = database_->detectGaps(currentSymbol_, startTime, latestTime.value());
     
     if (!gaps.empty()) {
@@ -139,6 +191,7 @@ void DataManager::detectAndFillGaps() {
 }
 
 void DataManager::fetchMissingData(uint64_t startTime, uint64_t endTime) {
+  GLORA_TRACE_SCOPE("data", "fetchMissingData");
   if (!networkClient_) return;
   
   std::cout << "Fetching data from " << startTime << " to " << endTime << std::endl;
@@ -173,31 +226,49 @@ void DataManager::fetchMissingData(uint64_t startTime, uint64_t endTime) {
   }
 }
 
-void DataManager::processTicksToCandles(const std::vector<Tick>& ticks) {
-  if (ticks.empty()) return;
-  
-  // Group ticks into candles (1-minute candles for now)
-  const uint64_t candleInterval = 60000; // 1 minute
+void DataManager::fetchMissingTrades(const database::DataGap& gap) {
+  GLORA_TRACE_SCOPE("data", "fetchMissingTrades");
+  if (!networkClient_ || gap.lastMissingId < gap.firstMissingId) return;
   
-  std::map<uint64_t, std::vector<Tick>> ticksByCandle;
+  std::vector<Tick> fetchedTicks;
+  networkClient_->fetchAggTradesById(
+    currentSymbol_,
+    gap.firstMissingId,
+    gap.lastMissingId,
+    [&fetchedTicks](const std::vector<Tick>& ticks) {
+      fetchedTicks = ticks;
+    }
+  );
   
-  for (const auto& tick : ticks) {
-    uint64_t candleStart = (tick.timestamp_ms / candleInterval) * candleInterval;
-    ticksByCandle[candleStart].push_back(tick);
+  if (!fetchedTicks.empty()) {
+    if (database_) {
+      database_->insertTicks(currentSymbol_, fetchedTicks);
+    }
+    processTicksToCandles(fetchedTicks);
+    
+    if (onGapFilled_) {
+      onGapFilled_(gap.startTime, gap.endTime);
+    }
   }
+}
+
+void DataManager::processTicksToCandles(const std::vector<Tick>& ticks) {
+  if (ticks.empty()) return;
   
-  std::vector<Candle> candles;
+  // 1-minute candles, built in parallel on the worker pool
+  BarSpec spec;
+  spec.type = BarType::TIME;
+  spec.size = 60000;
   
-  for (const auto& [startTime, candleTicks] : ticksByCandle) {
-    Candle candle;
-    candle.start_time_ms = startTime;
-    candle.end_time_ms = startTime + candleInterval;
-    
-    for (const auto& tick : candleTicks) {
-      candle.add_tick(tick);
-    }
-    
-    candles.push_back(candle);
+  std::vector<Candle> candles;
+  if (std::is_sorted(ticks.begin(), ticks.end(),
+                     [](const Tick& a, const Tick& b) { return a.timestamp_ms < b.timestamp_ms; })) {
+    candles = footprintBuilder_.build(ticks, spec);
+  } else {
+    std::vector<Tick> sorted = ticks;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Tick& a, const Tick& b) { return a.timestamp_ms < b.timestamp_ms; });
+    candles = footprintBuilder_.build(sorted, spec);
   }
   
   // Save candles to database
@@ -205,41 +276,138 @@ void DataManager::processTicksToCandles(const std::vector<Tick>& ticks) {
     database_->insertCandles(currentSymbol_, candles);
   }
   
+  // The archive changed under these spans; page them in again on next use
+  auto [minTick, maxTick] = std::minmax_element(ticks.begin(), ticks.end(),
+      [](const Tick& a, const Tick& b) { return a.timestamp_ms < b.timestamp_ms; });
+  tickIndex_.invalidateRange(currentSymbol_, minTick->timestamp_ms, maxTick->timestamp_ms + 1);
+  
   // Update cached data
   {
     std::lock_guard<std::mutex> lock(dataMutex_);
-    auto& existingCandles = candlesBySymbol_[currentSymbol_];
-    
-    // Merge new candles with existing
-    for (const auto& newCandle : candles) {
-      bool found = false;
-      for (auto& existing : existingCandles) {
-        if (existing.start_time_ms == newCandle.start_time_ms) {
-          existing = newCandle;
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
-        existingCandles.push_back(newCandle);
-      }
+    candlesBySymbol_[currentSymbol_].mergeSorted(std::move(candles));
+  }
+  invalidateHistory(currentSymbol_);
+}
+
+std::vector<Candle> DataManager::rebuildFootprints(const std::string& symbol, uint64_t startTime,
+                                                   uint64_t endTime, const BarSpec& spec) {
+  GLORA_TRACE_SCOPE("data", "rebuildFootprints");
+  if (!database_) return {};
+  
+  // Ticks come back ordered by timestamp
+  auto ticks = database_->getTicks(symbol, startTime, endTime);
+  if (ticks.empty()) return {};
+  
+  auto buildStart = std::chrono::steady_clock::now();
+  std::vector<Candle> bars = footprintBuilder_.build(ticks, spec);
+  auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - buildStart).count();
+  
+  std::cout << "[DataManager] Rebuilt " << bars.size() << " footprint bars from "
+            << ticks.size() << " ticks in " << buildMs << " ms ("
+            << workerPool_->size() << " workers)" << std::endl;
+  
+  // Only plain 1m time bars (default row size) line up with the cached series
+  if (spec.type == BarType::TIME && spec.size == 60000 && spec.rowSize == 0) {
+    database_->insertCandles(symbol, bars);
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      candlesBySymbol_[symbol].mergeSorted(std::vector<Candle>(bars));
     }
-    
-    // Sort by time
-    std::sort(existingCandles.begin(), existingCandles.end(),
-              [](const Candle& a, const Candle& b) {
-                return a.start_time_ms < b.start_time_ms;
-              });
+    invalidateHistory(symbol);
   }
+  
+  return bars;
+}
+
+size_t DataManager::buildSyntheticHistory(const std::string& name, uint64_t startTime, uint64_t endTime) {
+  GLORA_TRACE_SCOPE("data", "buildSyntheticHistory");
+  if (!database_) return 0;
+  auto definition = synthetics_.definition(name);
+  if (!definition) return 0;
+  
+  // Joined ticks are folded into 1m candles and written a batch at a time.
+  // Batches end on a minute boundary so no candle is split across two.
+  std::vector<Tick> batch;
+  batch.reserve(kSyntheticBatchTicks);
+  std::vector<Candle> recent;  // Newest candles, for memory
+  size_t count = 0;
+  auto flush = [&]() {
+    if (batch.empty()) return;
+    std::vector<Candle> bars = footprintBuilder_.build(batch, BarSpec{});
+    database_->insertTicks(name, batch);
+    database_->insertCandles(name, bars);
+    count += bars.size();
+    for (auto& bar : bars) {
+      recent.push_back(std::move(bar));
+    }
+    if (recent.size() > 2 * kMaxCandlesInMemory) {
+      recent.erase(recent.begin(), recent.end() - kMaxCandlesInMemory);
+    }
+    batch.clear();
+  };
+  synthetics_.buildHistory(*database_, *definition, startTime, endTime, [&](const Tick& tick) {
+    if (batch.size() >= kSyntheticBatchTicks && tick.timestamp_ms / 60000 != batch.back().timestamp_ms / 60000) {
+      flush();
+    }
+    batch.push_back(tick);
+  });
+  flush();
+  if (count == 0) return 0;
+  
+  loadCandles(name, std::move(recent));
+  invalidateHistory(name);
+  return count;
+}
+
+// Live candle builder instrumentation
+struct CandleMetrics {
+  Counter& ticks;
+  Counter& candlesOpened;
+  Histogram& updateUs;
+};
+
+static CandleMetrics& candleMetrics() {
+  auto& registry = MetricsRegistry::getInstance();
+  static CandleMetrics metrics{
+    registry.counter("glora_candle_ticks_total", "Live ticks applied to candles"),
+    registry.counter("glora_candles_opened_total", "New live candles started"),
+    registry.histogram("glora_candle_update_us", "Live tick to candle update, including persistence",
+                       MetricsRegistry::durationBucketsUs()),
+  };
+  return metrics;
 }
 
 void DataManager::addLiveTick(const std::string& symbol, const Tick& tick) {
+  GLORA_TRACE_SCOPE("data", "addLiveTick");
+  applyTick(symbol, tick, false);
+  if (onDataUpdate_) {
+    onDataUpdate_();
+  }
+}
+
+void DataManager::addBackgroundTick(const std::string& symbol, const Tick& tick) {
+  GLORA_TRACE_SCOPE("data", "addBackgroundTick");
+  applyTick(symbol, tick, true);
+}
+
+void DataManager::applyTick(const std::string& symbol, const Tick& tick, bool background) {
+  auto& metrics = candleMetrics();
+  auto updateStart = std::chrono::steady_clock::now();
+  metrics.ticks.inc();
+  
   // Create a single-tick candle for real-time update
   Candle candle;
   candle.add_tick(tick);
   candle.start_time_ms = (tick.timestamp_ms / 60000) * 60000;
   candle.end_time_ms = candle.start_time_ms + 60000;
   
+  auto& overload = OverloadController::getInstance();
+  bool defer = background || overload.atLeast(OverloadController::Tier::DEFERRED);
+  bool opened = false;
+  std::vector<Tick> batch;
+  Candle latest;
+  
   {
     std::lock_guard<std::mutex> lock(dataMutex_);
     auto& candles = candlesBySymbol_[symbol];
@@ -250,33 +418,74 @@ void DataManager::addLiveTick(const std::string& symbol, const Tick& tick) {
       candles.back().add_tick(tick);
       
       // Update candle in database
-      if (database_) {
+      if (database_ && !defer) {
         database_->insertCandles(symbol, {candles.back()});
       }
     } else {
-      candles.push_back(candle);
-      
-      // Insert new candle to database
+      // Insert new candle to database. When writes are deferred the previous
+      // candle's last updates were skipped, so write its final state too.
       if (database_) {
-        database_->insertCandles(symbol, {candle});
+        if (defer && !candles.empty()) {
+          database_->insertCandles(symbol, {candles.back(), candle});
+        } else {
+          database_->insertCandles(symbol, {candle});
+        }
       }
+      
+      candles.push_back(std::move(candle));
+      metrics.candlesOpened.inc();
+      opened = true;
     }
     
-    // Keep only last N candles in memory
-    const size_t maxCandlesInMemory = 10000;
-    if (candles.size() > maxCandlesInMemory) {
-      candles.erase(candles.begin(), candles.end() - maxCandlesInMemory);
+    // Keep only last N candles in memory (drops whole pages)
+    candles.trimFront(kMaxCandlesInMemory);
+    latest = ohlcvOnly(candles.back());
+    
+    if (database_ && background) {
+      // Off-screen symbols write their ticks once a minute or per batch
+      auto& pending = backgroundTicks_[symbol];
+      pending.push_back(tick);
+      if (opened || pending.size() >= kBackgroundTickBatch) {
+        batch.swap(pending);
+      }
+    } else if (database_ && defer) {
+      auto& pending = deferredTicks_[symbol];
+      pending.push_back(tick);
+      overload.countShed(OverloadController::Shed::DEFERRED_WRITE);
+      if (pending.size() >= kDeferredTickBatch) {
+        batch.swap(pending);
+      }
+    } else if (database_ && !deferredTicks_.empty()) {
+      // Recovered: catch the database up before writing live again
+      flushDeferredWritesLocked();
     }
   }
   
   // Save tick to database (for raw tick data)
   if (database_) {
-    database_->insertTicks(symbol, {tick});
+    if (!batch.empty()) {
+      database_->insertTicks(symbol, batch);
+    } else if (!defer) {
+      database_->insertTicks(symbol, {tick});
+    }
   }
+  tickIndex_.append(symbol, tick);
+  sparklines_.update(symbol, tick.timestamp_ms, tick.price);
+  // Correlation steps close on arrival time, the one clock every price
+  // source has (updateSymbolPrice carries no exchange time)
+  correlation_.update(symbol, std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count(), tick.price);
   
-  if (onDataUpdate_) {
-    onDataUpdate_();
+  {
+    std::lock_guard<std::mutex> lock(pyramidMutex_);
+    auto it = pyramids_.find(symbol);
+    if (it != pyramids_.end()) {
+      it->second.update(latest);
+    }
   }
+  
+  metrics.updateUs.observe(std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - updateStart).count());
 }
 
 void DataManager::addLiveTick(const Tick& tick) {
@@ -284,8 +493,30 @@ void DataManager::addLiveTick(const Tick& tick) {
   addLiveTick(currentSymbol_, tick);
 }
 
-const std::vector<Candle>& DataManager::getCandles(const std::string& symbol) const {
-  static std::vector<Candle> empty;
+void DataManager::flushDeferredWrites() {
+  std::lock_guard<std::mutex> lock(dataMutex_);
+  flushDeferredWritesLocked();
+}
+
+void DataManager::flushDeferredWritesLocked() {
+  if (!database_) return;
+  for (auto* pendingBySymbol : {&deferredTicks_, &backgroundTicks_}) {
+    for (auto& [symbol, ticks] : *pendingBySymbol) {
+      if (!ticks.empty()) {
+        database_->insertTicks(symbol, ticks);
+      }
+      // The candle in progress missed its deferred updates
+      auto it = candlesBySymbol_.find(symbol);
+      if (it != candlesBySymbol_.end() && !it->second.empty()) {
+        database_->insertCandles(symbol, {it->second.back()});
+      }
+    }
+    pendingBySymbol->clear();
+  }
+}
+
+const CandleSeries& DataManager::getCandles(const std::string& symbol) const {
+  static const CandleSeries empty;
   auto it = candlesBySymbol_.find(symbol);
   if (it != candlesBySymbol_.end()) {
     return it->second;
@@ -300,6 +531,19 @@ std::vector<Tick> DataManager::getTicks(const std::string& symbol, uint64_t star
   return {};
 }
 
+std::optional<Candle> DataManager::getFootprint(const std::string& symbol, uint64_t startTime, uint64_t endTime) {
+  Candle candle;
+  if (!tickIndex_.buildCandle(symbol, startTime, endTime, candle)) {
+    return std::nullopt;
+  }
+  return candle;
+}
+
+std::vector<Tick> DataManager::getTimeAndSales(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                               double minQuantity, size_t limit) {
+  return tickIndex_.getTrades(symbol, startTime, endTime, minQuantity, limit);
+}
+
 std::optional<uint64_t> DataManager::getLatestTickTime(const std::string& symbol) const {
   if (database_) {
     return database_->getLatestTickTime(symbol);
@@ -324,18 +568,61 @@ void DataManager::refreshData() {
 
 // === Symbol Management ===
 
+namespace {
+
+using SymbolEntries = flat_map<std::string, Symbol, std::less<std::string>>::container_type;
+using AssetIndex = std::unordered_map<std::string, std::vector<std::string>>;
+
+void buildAssetIndexes(const SymbolEntries& entries, AssetIndex& byQuote, AssetIndex& byBase) {
+  for (const auto& [name, sym] : entries) {
+    byQuote[sym.quoteAsset].push_back(name);
+    byBase[sym.baseAsset].push_back(name);
+  }
+}
+
+// Fields maintained by the miniTicker stream rather than exchangeInfo
+void copyLiveFields(const Symbol& from, Symbol& to) {
+  to.lastPrice = from.lastPrice;
+  to.priceChange = from.priceChange;
+  to.priceChangePercent = from.priceChangePercent;
+  to.high24h = from.high24h;
+  to.low24h = from.low24h;
+  to.volume24h = from.volume24h;
+  to.quoteVolume24h = from.quoteVolume24h;
+  to.lastUpdateTime = from.lastUpdateTime;
+}
+
+// Ascending by name with unique names, as assign_sorted into symbols_ requires
+SymbolEntries toSortedEntries(std::vector<Symbol> symbols) {
+  SymbolEntries entries;
+  entries.reserve(symbols.size());
+  for (auto& sym : symbols) {
+    std::string name = sym.symbol;
+    entries.emplace_back(std::move(name), std::move(sym));
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [](const auto& a, const auto& b) { return a.first == b.first; }),
+                entries.end());
+  return entries;
+}
+
+} // namespace
+
 void DataManager::loadSymbols() {
   // First try to load from database
   if (database_) {
     auto dbSymbols = database_->getAllSymbols();
     if (!dbSymbols.empty()) {
+      SymbolEntries entries = toSortedEntries(std::move(dbSymbols));
+      AssetIndex byQuote, byBase;
+      buildAssetIndexes(entries, byQuote, byBase);
+      
       std::lock_guard<std::mutex> lock(symbolMutex_);
-      for (auto& sym : dbSymbols) {
-        symbols_[sym.symbol] = sym;
-        // Build secondary indices
-        symbolsByQuoteAsset_[sym.quoteAsset].push_back(sym.symbol);
-        symbolsByBaseAsset_[sym.baseAsset].push_back(sym.symbol);
-      }
+      symbols_.assign_sorted(std::move(entries));
+      symbolsByQuoteAsset_.swap(byQuote);
+      symbolsByBaseAsset_.swap(byBase);
       std::cout << "[DataManager] Loaded " << symbols_.size() << " symbols from database" << std::endl;
       return;
     }
@@ -351,39 +638,119 @@ void DataManager::fetchExchangeInfoFromApi() {
     return;
   }
   
+  std::lock_guard<std::mutex> refreshLock(symbolRefreshMutex_);
+  network::ScopedRequestPriority priority(network::RequestPriority::Background);
+  
   std::cout << "[DataManager] Fetching exchange info from API..." << std::endl;
   
   networkClient_->fetchExchangeInfo([this](const std::vector<Symbol>& apiSymbols) {
+    // An empty list is a failed fetch, not a delisting of everything
     if (!apiSymbols.empty()) {
-      // Store in database
-      if (database_) {
-        database_->insertSymbols(apiSymbols);
+      applySymbolSnapshot(apiSymbols);
+    }
+  });
+  
+  std::lock_guard<std::mutex> stateLock(refreshStateMutex_);
+  lastSymbolFetch_ = std::chrono::steady_clock::now();
+}
+
+void DataManager::applySymbolSnapshot(const std::vector<Symbol>& apiSymbols) {
+  SymbolEntries next = toSortedEntries(apiSymbols);
+  
+  SymbolEntries current;
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex_);
+    current.assign(symbols_.begin(), symbols_.end());
+  }
+  
+  // Both sides are sorted by name, so one merge pass finds every change
+  SymbolDiff diff;
+  auto cur = current.begin();
+  auto nxt = next.begin();
+  while (cur != current.end() || nxt != next.end()) {
+    if (nxt == next.end() || (cur != current.end() && cur->first < nxt->first)) {
+      diff.removed.push_back(cur->first);
+      ++cur;
+    } else if (cur == current.end() || nxt->first < cur->first) {
+      diff.added.push_back(nxt->second);
+      ++nxt;
+    } else {
+      if (!cur->second.sameMetadata(nxt->second)) {
+        diff.changed.push_back(nxt->second);
       }
-      
-      // Update in-memory storage with flat_map
-      {
-        std::lock_guard<std::mutex> lock(symbolMutex_);
-        symbols_.clear();
-        symbolsByQuoteAsset_.clear();
-        symbolsByBaseAsset_.clear();
-        
-        for (const auto& sym : apiSymbols) {
-          symbols_[sym.symbol] = sym;
-          // Build secondary indices
-          symbolsByQuoteAsset_[sym.quoteAsset].push_back(sym.symbol);
-          symbolsByBaseAsset_[sym.baseAsset].push_back(sym.symbol);
-        }
+      ++cur;
+      ++nxt;
+    }
+  }
+  
+  if (diff.empty()) {
+    std::cout << "[DataManager] Symbol metadata unchanged (" << next.size() << " symbols)" << std::endl;
+    return;
+  }
+  
+  AssetIndex byQuote, byBase;
+  buildAssetIndexes(next, byQuote, byBase);
+  
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex_);
+    // Prices kept streaming while we built; carry them into the new registry
+    auto live = symbols_.begin();
+    for (auto& [name, sym] : next) {
+      while (live != symbols_.end() && live->first < name) ++live;
+      if (live != symbols_.end() && live->first == name) {
+        copyLiveFields(live->second, sym);
       }
-      
-      std::cout << "[DataManager] Loaded " << apiSymbols.size() << " symbols from API" << std::endl;
-      
-      if (onDataUpdate_) {
-        onDataUpdate_();
+    }
+    symbols_.assign_sorted(std::move(next));
+    symbolsByQuoteAsset_.swap(byQuote);
+    symbolsByBaseAsset_.swap(byBase);
+  }
+  
+  if (database_) {
+    database_->applySymbolDiff(diff);
+  }
+  
+  std::cout << "[DataManager] Symbols updated: " << diff.added.size() << " added, "
+            << diff.changed.size() << " changed, " << diff.removed.size() << " removed" << std::endl;
+  
+  if (onDataUpdate_) {
+    onDataUpdate_();
+  }
+}
+
+void DataManager::startSymbolRefresh(std::chrono::minutes interval) {
+  {
+    std::lock_guard<std::mutex> lock(refreshStateMutex_);
+    if (refreshRunning_) return;
+    refreshRunning_ = true;
+  }
+  
+  refreshThread_ = std::thread([this, interval]() {
+    applyThreadRole(settings::ThreadRole::BACKGROUND, "glora-symbols");
+    std::unique_lock<std::mutex> lock(refreshStateMutex_);
+    while (true) {
+      // loadSymbols() may have just fetched; the first refresh waits for it
+      if (refreshCv_.wait_until(lock, lastSymbolFetch_ + interval, [this]() { return !refreshRunning_; })) {
+        break;
       }
+      lock.unlock();
+      fetchExchangeInfoFromApi();
+      lock.lock();
     }
   });
 }
 
+void DataManager::stopSymbolRefresh() {
+  {
+    std::lock_guard<std::mutex> lock(refreshStateMutex_);
+    refreshRunning_ = false;
+  }
+  refreshCv_.notify_all();
+  if (refreshThread_.joinable()) {
+    refreshThread_.join();
+  }
+}
+
 std::vector<Symbol> DataManager::getAllSymbols() const {
   std::lock_guard<std::mutex> lock(symbolMutex_);
   std::vector<Symbol> result;
@@ -468,6 +835,11 @@ void DataManager::updateSymbolPrice(const std::string& symbolName, double price,
     }
   }
   
+  uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  sparklines_.update(symbolName, now, price);
+  correlation_.update(symbolName, now, price);
+  
   // Update in database
   if (database_) {
     database_->updateSymbolPrice(symbolName, price, priceChange, priceChangePercent, 
@@ -479,6 +851,69 @@ void DataManager::updateSymbolPrice(const std::string& symbolName, double price,
   }
 }
 
+void DataManager::applyMiniTickers(const std::vector<MiniTicker>& tickers) {
+  GLORA_TRACE_SCOPE("data", "applyMiniTickers");
+  uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  ).count();
+  
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex_);
+    for (const auto& ticker : tickers) {
+      auto it = symbols_.find(ticker.symbol);
+      if (it == symbols_.end()) continue;
+      auto& sym = it->second;
+      sym.lastPrice = ticker.close;
+      sym.priceChange = ticker.close - ticker.open;
+      sym.priceChangePercent = ticker.open > 0.0 ? (ticker.close - ticker.open) / ticker.open * 100.0 : 0.0;
+      sym.high24h = ticker.high;
+      sym.low24h = ticker.low;
+      sym.volume24h = ticker.volume;
+      sym.quoteVolume24h = ticker.quoteVolume;
+      sym.lastUpdateTime = now;
+    }
+  }
+  
+  for (const auto& ticker : tickers) {
+    uint64_t time = ticker.eventTime ? ticker.eventTime : now;
+    sparklines_.update(ticker.symbol, time, ticker.close);
+    correlation_.update(ticker.symbol, now, ticker.close);
+  }
+  
+  // Stored prices only seed the list on the next start; no need to write
+  // hundreds of rows every second
+  uint64_t lastPersist = lastPricePersistMs_.load();
+  if (database_ && now - lastPersist >= kPricePersistIntervalMs &&
+      lastPricePersistMs_.compare_exchange_strong(lastPersist, now)) {
+    for (const auto& ticker : tickers) {
+      double change = ticker.close - ticker.open;
+      double changePercent = ticker.open > 0.0 ? change / ticker.open * 100.0 : 0.0;
+      database_->updateSymbolPrice(ticker.symbol, ticker.close, change, changePercent,
+                                   ticker.high, ticker.low, ticker.volume, ticker.quoteVolume);
+    }
+  }
+}
+
+SparklineService::Snapshot DataManager::getSparklines(const std::vector<std::string>& symbols) {
+  uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  ).count();
+  
+  if (database_) {
+    for (const auto& symbol : symbols) {
+      if (sparklines_.tracks(symbol)) continue;
+      {
+        std::lock_guard<std::mutex> lock(sparklineSeedMutex_);
+        if (!sparklineSeeded_.insert(symbol).second) continue;
+      }
+      auto candles = database_->getCandles(symbol, now - SparklineService::kDefaultWindowMs, now);
+      sparklines_.seed(symbol, candles);
+    }
+  }
+  
+  return sparklines_.snapshot(symbols, now);
+}
+
 std::vector<std::string> DataManager::getQuoteAssets() const {
   std::lock_guard<std::mutex> lock(symbolMutex_);
   std::vector<std::string> result;
@@ -499,21 +934,220 @@ std::vector<std::string> DataManager::getBaseAssets() const {
   return result;
 }
 
-// Helper function to convert interval string to milliseconds
-static uint64_t intervalToMs(const std::string& interval) {
+uint64_t DataManager::intervalToMs(const std::string& interval) {
+  if (interval == "1s") return 1000;
   if (interval == "1m") return 60 * 1000;
   if (interval == "5m") return 5 * 60 * 1000;
   if (interval == "15m") return 15 * 60 * 1000;
+  if (interval == "30m") return 30 * 60 * 1000;
   if (interval == "1h") return 60 * 60 * 1000;
   if (interval == "4h") return 4 * 60 * 60 * 1000;
   if (interval == "1D") return 24 * 60 * 60 * 1000;
+  // Nominal widths: Binance aligns weeks to Monday and months to the calendar
+  if (interval == "1W") return 7ULL * 24 * 60 * 60 * 1000;
+  if (interval == "1M") return 30ULL * 24 * 60 * 60 * 1000;
   return 60 * 1000; // Default to 1m
 }
 
+CandlePyramid::Result DataManager::getDownsampledHistory(const std::string& symbol, uint64_t startTime,
+                                                       uint64_t endTime, size_t maxPoints, DownsampleMode mode,
+                                                       uint64_t minResolutionMs) {
+  GLORA_TRACE_SCOPE("data", "getDownsampledHistory");
+  // Widening to the old coverage keeps pans from rebuilding, up to this span
+  constexpr uint64_t kMaxPyramidSpanMs = 90ULL * 24 * 60 * 60 * 1000;
+  
+  uint64_t coverStart = startTime;
+  uint64_t coverEnd = endTime;
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(pyramidMutex_);
+    auto it = pyramids_.find(symbol);
+    if (it != pyramids_.end() && it->second.covers(startTime, endTime)) {
+      return it->second.query(startTime, endTime, maxPoints, mode, minResolutionMs);
+    }
+    if (it != pyramids_.end() && !it->second.empty()) {
+      uint64_t unionStart = std::min(coverStart, it->second.coverStart());
+      uint64_t unionEnd = std::max(coverEnd, it->second.coverEnd());
+      if (unionEnd - unionStart <= kMaxPyramidSpanMs) {
+        coverStart = unionStart;
+        coverEnd = unionEnd;
+      }
+    }
+    generation = pyramidGeneration_;
+  }
+  if (!database_) return {};
+  
+  // The read and rebuild can take a while over a long range; live ticks keep
+  // updating the old pyramid meanwhile
+  auto buildStart = std::chrono::steady_clock::now();
+  auto stored = database_->getCandles(symbol, coverStart, coverEnd);
+  
+  // The table also holds other intervals fetched for display; only 1m rows
+  // are the pyramid's base
+  std::vector<Candle> base;
+  base.reserve(stored.size());
+  for (auto& candle : stored) {
+    if (candle.end_time_ms - candle.start_time_ms <= 60000) {
+      base.push_back(std::move(candle));
+    }
+  }
+  if (base.empty()) return {};
+  
+  CandlePyramid pyramid;
+  pyramid.build(base, coverStart, coverEnd);
+  auto result = pyramid.query(startTime, endTime, maxPoints, mode, minResolutionMs);
+  
+  std::cout << "[DataManager] Built candle pyramid for " << symbol << " from " << base.size()
+            << " 1m candles in " << std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - buildStart).count() << " ms" << std::endl;
+  
+  {
+    std::lock_guard<std::mutex> lock(pyramidMutex_);
+    if (pyramidGeneration_ == generation) {
+      pyramids_.insert_or_assign(symbol, std::move(pyramid));
+    }
+  }
+  return result;
+}
+
+std::optional<std::vector<Candle>> DataManager::getHistoryPage(const std::string& symbol,
+                                                               const std::string& interval,
+                                                               uint64_t before, size_t count) {
+  GLORA_TRACE_SCOPE("data", "getHistoryPage");
+  uint64_t intervalMs = intervalToMs(interval);
+  uint64_t endTime = before / intervalMs * intervalMs;  // Pages end on a bucket boundary
+  uint64_t span = intervalMs * count;
+  uint64_t startTime = endTime > span ? endTime - span : 0;
+  if (endTime <= startTime) return std::vector<Candle>{};
+  
+  // Sub-minute intervals cannot be built from the 1m base
+  std::vector<Candle> base;
+  if (database_ && intervalMs >= 60000) {
+    auto stored = database_->getCandles(symbol, startTime, endTime - 1);
+    base.reserve(stored.size());
+    for (auto& candle : stored) {
+      if (candle.end_time_ms - candle.start_time_ms <= 60000) {
+        base.push_back(ohlcvOnly(candle));
+      }
+    }
+  }
+  if (!base.empty()) {
+    return intervalMs == 60000 ? base : mergeCandles(base.data(), base.data() + base.size(), intervalMs);
+  }
+  
+  // Older than anything stored: klines straight at the interval. Only 1m
+  // rows are kept, since the table is the 1m base for everything else.
+  std::vector<Candle> fetched;
+  if (networkClient_) {
+    if (!networkClient_->fetchKlines(symbol, interval, startTime, endTime - 1,
+            [&fetched](const std::vector<Candle>& candles) { fetched = candles; })) {
+      return std::nullopt;
+    }
+    if (!fetched.empty() && intervalMs == 60000 && database_) {
+      database_->insertCandles(symbol, fetched);
+      invalidateHistory(symbol);
+    }
+  }
+  return fetched;
+}
+
+void DataManager::invalidateHistory(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(pyramidMutex_);
+  pyramids_.erase(symbol);
+  ++pyramidGeneration_;
+}
+
+void DataManager::loadCandles(const std::string& symbol, std::vector<Candle> candles) {
+  GLORA_TRACE_SCOPE("data", "loadCandles");
+  if (candles.empty()) return;
+  std::lock_guard<std::mutex> lock(dataMutex_);
+  auto& series = candlesBySymbol_[symbol];
+  
+  // Stored rows may lag the live candle (deferred writes); memory wins from
+  // the candle in progress onwards
+  if (!series.empty()) {
+    uint64_t liveStart = series.back().start_time_ms;
+    candles.erase(std::remove_if(candles.begin(), candles.end(),
+                                 [liveStart](const Candle& c) { return c.start_time_ms >= liveStart; }),
+                  candles.end());
+  }
+  series.mergeSorted(std::move(candles));
+  series.trimFront(kMaxCandlesInMemory);
+  warmSymbols_.insert(symbol);
+}
+
+bool DataManager::warmSymbol(const std::string& symbol, int days) {
+  GLORA_TRACE_SCOPE("data", "warmSymbol");
+  if (!database_) return false;
+  
+  uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  ).count();
+  uint64_t startTime = now - (static_cast<uint64_t>(days) * 24 * 60 * 60 * 1000);
+  
+  auto candles = database_->getCandles(symbol, startTime, now);
+  if (candles.empty() && networkClient_) {
+    // Never ahead of what the user is waiting for
+    network::ScopedRequestPriority priority(network::RequestPriority::Background);
+    networkClient_->fetchKlines(symbol, "1m", startTime, now,
+        [&candles](const std::vector<Candle>& fetched) { candles = fetched; });
+    if (!candles.empty()) {
+      database_->insertCandles(symbol, candles);
+      invalidateHistory(symbol);
+    }
+  }
+  if (candles.empty()) return false;
+  
+  size_t count = candles.size();
+  loadCandles(symbol, std::move(candles));
+  
+  // Recent ticks paged in now so footprint drill-downs don't hit the database
+  size_t ticks = tickIndex_.forEach(symbol, now - kWarmTickSpanMs, now, [](const Tick&) {});
+  
+  std::cout << "[DataManager] Warmed " << symbol << ": " << count << " candles, " << ticks
+            << " ticks" << std::endl;
+  return true;
+}
+
+bool DataManager::isWarm(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(dataMutex_);
+  return warmSymbols_.count(symbol) > 0;
+}
+
+size_t DataManager::residentBytes(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(dataMutex_);
+  auto it = candlesBySymbol_.find(symbol);
+  if (it == candlesBySymbol_.end()) return 0;
+  
+  size_t levels = 0;
+  for (const auto& candle : it->second) {
+    levels += candle.footprint_profile.size();
+  }
+  return it->second.pageCount() * CandleSeries::kPageSize * sizeof(Candle) +
+         levels * sizeof(std::pair<double, PriceNode>);
+}
+
+void DataManager::evictSymbol(const std::string& symbol) {
+  {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (symbol == currentSymbol_) return;
+    if (deferredTicks_.count(symbol) || backgroundTicks_.count(symbol)) {
+      flushDeferredWritesLocked();
+    }
+    candlesBySymbol_.erase(symbol);
+    warmSymbols_.erase(symbol);
+  }
+  invalidateHistory(symbol);
+  tickIndex_.evictSymbol(symbol);
+  std::cout << "[DataManager] Evicted " << symbol << std::endl;
+}
+
 std::vector<Candle> DataManager::aggregateToTimeframe(const std::string& symbol, const std::string& interval) const {
+  GLORA_TRACE_SCOPE("data", "aggregateToTimeframe");
   // If already 1m, just return the candles from memory
   if (interval == "1m") {
-    return getCandles(symbol);
+    const auto& candles = getCandles(symbol);
+    return std::vector<Candle>(candles.begin(), candles.end());
   }
   
   uint64_t targetIntervalMs = intervalToMs(interval);
@@ -570,12 +1204,33 @@ std::vector<Candle> DataManager::aggregateToTimeframe(const std::string& symbol,
 
 void DataManager::updateOrderBook(const std::string& symbol, const std::vector<std::pair<double, double>>& bids, 
                                    const std::vector<std::pair<double, double>>& asks) {
-  std::lock_guard<std::mutex> lock(smartDOMMutex_);
-  
-  auto& smartDOM = smartDOMBySymbol_[symbol];
+  GLORA_TRACE_SCOPE("data", "updateOrderBook");
   uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
     std::chrono::system_clock::now().time_since_epoch()
   ).count();
+  bookSignals_.onBook(symbol, bids, asks, now);
+  
+  double tickSize = 0.0;
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex_);
+    auto it = symbols_.find(symbol);
+    if (it != symbols_.end()) {
+      tickSize = it->second.tickSize;
+    }
+  }
+  icebergs_.onBook(symbol, bids, asks, tickSize, now);
+  
+  std::lock_guard<std::mutex> lock(smartDOMMutex_);
+  auto& smartDOM = smartDOMBySymbol_[symbol];
+  
+  // Drop levels that no longer hold anything so the book stays bounded
+  auto removeIfEmpty = [&smartDOM](double price) {
+    auto it = smartDOM.find(price);
+    if (it != smartDOM.end() && it->second.restingBidQty == 0 && it->second.restingAskQty == 0 &&
+        it->second.aggressiveBuyVol == 0 && it->second.aggressiveSellVol == 0) {
+      smartDOM.erase(it);
+    }
+  };
   
   // Update bids (resting buy orders)
   for (const auto& [price, qty] : bids) {
@@ -583,6 +1238,7 @@ void DataManager::updateOrderBook(const std::string& symbol, const std::vector<s
     bucket.price = price;
     bucket.restingBidQty = qty;
     bucket.lastUpdateTime = now;
+    if (qty == 0) removeIfEmpty(price);
   }
   
   // Update asks (resting sell orders)
@@ -591,16 +1247,23 @@ void DataManager::updateOrderBook(const std::string& symbol, const std::vector<s
     bucket.price = price;
     bucket.restingAskQty = qty;
     bucket.lastUpdateTime = now;
+    if (qty == 0) removeIfEmpty(price);
   }
+  
+  ++smartDOMVersion_[symbol];
 }
 
 void DataManager::processTradeForSmartDOM(const std::string& symbol, const Tick& tick) {
-  std::lock_guard<std::mutex> lock(smartDOMMutex_);
-  
-  auto& smartDOM = smartDOMBySymbol_[symbol];
+  // Book updates carry no exchange time, so trades are stamped on arrival too
   uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
     std::chrono::system_clock::now().time_since_epoch()
   ).count();
+  bookSignals_.onTrade(symbol, tick, now);
+  icebergs_.onTrade(symbol, tick, now);
+  
+  std::lock_guard<std::mutex> lock(smartDOMMutex_);
+  
+  auto& smartDOM = smartDOMBySymbol_[symbol];
   
   // Find or create bucket for this price
   auto& bucket = smartDOM[tick.price];
@@ -615,6 +1278,8 @@ void DataManager::processTradeForSmartDOM(const std::string& symbol, const Tick&
     // Aggressor was buyer - lifted the ask (aggressive buy)
     bucket.aggressiveBuyVol += tick.quantity;
   }
+  
+  ++smartDOMVersion_[symbol];
 }
 
 std::vector<PriceBucket> DataManager::getSmartDOM(const std::string& symbol, int depth) const {
@@ -661,7 +1326,7 @@ bool DataManager::hasDiagonalImbalance(const std::string& symbol, double price,
   const auto& below = belowIt->second;
   
   // Diagonal imbalance: aggressive buy volume at price P >= ratio * aggressive sell volume at P-tickSize
-  return current.aggressiveBuyVol >= (ratio * below.aggressiveSellVol);
+  return current.aggressiveBuyVol > 0 && current.aggressiveBuyVol >= (ratio * below.aggressiveSellVol);
 }
 
 double DataManager::getPointOfControl(const std::string& symbol) const {
@@ -704,5 +1369,96 @@ double DataManager::getVolumeImbalance(const std::string& symbol, double price)
   return bucket.getNetVolume() / totalVol;
 }
 
+DomFrame DataManager::getSmartDOMFrame(const std::string& symbol, int depth, double ratio) const {
+  DomFrame frame;
+  frame.symbol = symbol;
+  
+  // Tick size comes from exchange info; taken first so the two locks never nest
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex_);
+    auto it = symbols_.find(symbol);
+    if (it != symbols_.end()) {
+      frame.tickSize = it->second.tickSize;
+    }
+  }
+  
+  std::lock_guard<std::mutex> lock(smartDOMMutex_);
+  
+  auto versionIt = smartDOMVersion_.find(symbol);
+  frame.version = versionIt != smartDOMVersion_.end() ? versionIt->second : 0;
+  
+  auto it = smartDOMBySymbol_.find(symbol);
+  if (it == smartDOMBySymbol_.end() || it->second.empty()) {
+    return frame;
+  }
+  
+  const auto& smartDOM = it->second;
+  const size_t count = smartDOM.size();
+  auto level = [&smartDOM](size_t i) -> const PriceBucket& { return (smartDOM.begin() + i)->second; };
+  
+  // One pass for the POC, the touch (highest resting bid) and, without exchange
+  // info, the smallest price step in the book
+  double maxVolume = 0.0;
+  size_t touch = count;
+  double minStep = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    const auto& bucket = level(i);
+    double totalVol = bucket.getTotalBidVol() + bucket.getTotalAskVol();
+    if (totalVol > maxVolume) {
+      maxVolume = totalVol;
+      frame.poc = bucket.price;
+    }
+    if (touch == count && bucket.restingBidQty > 0) {
+      touch = i;
+    }
+    if (i > 0) {
+      double step = level(i - 1).price - bucket.price;
+      if (step > 0 && (minStep == 0.0 || step < minStep)) minStep = step;
+    }
+  }
+  if (frame.tickSize <= 0.0) {
+    frame.tickSize = minStep;
+  }
+  if (touch == count) {
+    touch = 0;  // No bids yet: show the top of the book
+  }
+  
+  // Levels are ordered high to low, so the one a tick below is the next entry
+  size_t span = static_cast<size_t>(std::max(depth, 1));
+  size_t first = touch > span ? touch - span : 0;
+  size_t last = std::min(count, touch + span);
+  double halfTick = frame.tickSize * 0.5;
+  
+  frame.levels.reserve(last - first);
+  for (size_t i = first; i < last; ++i) {
+    DomLevel out;
+    out.bucket = level(i);
+    if (i + 1 < count && frame.tickSize > 0.0) {
+      const auto& below = level(i + 1);
+      if (std::abs(out.bucket.price - frame.tickSize - below.price) < halfTick) {
+        out.imbalance = out.bucket.aggressiveBuyVol > 0 &&
+                        out.bucket.aggressiveBuyVol >= ratio * below.aggressiveSellVol;
+      }
+    }
+    frame.levels.push_back(out);
+  }
+  
+  return frame;
+}
+
+uint64_t DataManager::getSmartDOMVersion(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(smartDOMMutex_);
+  auto it = smartDOMVersion_.find(symbol);
+  return it != smartDOMVersion_.end() ? it->second : 0;
+}
+
+void DataManager::clearSmartDOM(const std::string& symbol) {
+  bookSignals_.clear(symbol);
+  icebergs_.clear(symbol);
+  std::lock_guard<std::mutex> lock(smartDOMMutex_);
+  smartDOMBySymbol_.erase(symbol);
+  ++smartDOMVersion_[symbol];
+}
+
 } // namespace core
 } // namespace glora
@@ -1,6 +1,16 @@
 #pragma once
 
 #include "DataModels.h"
+#include "CandleSeries.h"
+#include "Downsampler.h"
+#include "SparklineService.h"
+#include "BookSignalEngine.h"
+#include "IcebergDetector.h"
+#include "CorrelationEngine.h"
+#include "SyntheticInstruments.h"
+#include "FootprintBuilder.h"
+#include "TickIndex.h"
+#include "ThreadPool.h"
 #include "../database/Database.h"
 #include "../network/BinanceClient.h"
 #include "../settings/Settings.h"
@@ -11,6 +21,9 @@
 #include <atomic>
 #include <unordered_map>
 #include <set>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 
 namespace glora {
 namespace core {
@@ -39,18 +52,39 @@ public:
   // Load data for a symbol (from DB + fetch missing)
   void loadSymbolData(const std::string& symbol);
   
-  // Add a live tick (from WebSocket) - with explicit symbol
+  // Add a live tick (from WebSocket) - with explicit symbol. In the DEFERRED
+  // overload tier its database writes are batched; memory is always current.
   void addLiveTick(const std::string& symbol, const Tick& tick);
   
   // Add a live tick using current symbol (backwards compatible)
   void addLiveTick(const Tick& tick);
   
+  // A tick of a symbol that is not on screen (prefetch streams). Memory is
+  // updated as for addLiveTick; database writes are batched per minute and
+  // onDataUpdate is not fired.
+  void addBackgroundTick(const std::string& symbol, const Tick& tick);
+  
+  // Write out ticks and candles postponed by overload (shutdown, recovery)
+  void flushDeferredWrites();
+  
   // Get all candles for a symbol
-  const std::vector<Candle>& getCandles(const std::string& symbol) const;
+  const CandleSeries& getCandles(const std::string& symbol) const;
   
   // Get all ticks for a symbol within time range
   std::vector<Tick> getTicks(const std::string& symbol, uint64_t startTime, uint64_t endTime) const;
   
+  // Footprint bar for [startTime, endTime) from the tick index; any interval.
+  // Returns nullopt when no ticks exist in the span.
+  std::optional<Candle> getFootprint(const std::string& symbol, uint64_t startTime, uint64_t endTime);
+  
+  // Time & sales for [startTime, endTime), newest first. A minQuantity filter
+  // gives the large prints for trade bubbles; limit 0 returns everything.
+  std::vector<Tick> getTimeAndSales(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                    double minQuantity = 0.0, size_t limit = 0);
+  
+  // Interval string ("1m", "5m", "15m", "1h", "4h", "1D") to milliseconds, 1m if unknown
+  static uint64_t intervalToMs(const std::string& interval);
+  
   // Get latest tick time in database
   std::optional<uint64_t> getLatestTickTime(const std::string& symbol) const;
   
@@ -89,9 +123,41 @@ public:
                         double priceChangePercent, double high24h, double low24h,
                         double volume24h, double quoteVolume24h);
   
-  // Fetch exchange info from API and store in DB
+  // Apply one miniTicker batch: live symbol fields and sparklines in memory,
+  // prices persisted at most once per kPricePersistIntervalMs
+  void applyMiniTickers(const std::vector<MiniTicker>& tickers);
+  
+  // === Cross-symbol correlation ===
+  // Rolling correlation and beta over the symbols set on it, fed by the
+  // same tick and miniTicker prices as the sparklines
+  CorrelationEngine& correlation() { return correlation_; }
+  
+  // === Synthetic instruments ===
+  // Ratio/spread/basket definitions; their ticks go through
+  // addBackgroundTick under the synthetic's name like any off-screen symbol
+  SyntheticInstruments& synthetics() { return synthetics_; }
+  
+  // Join the legs' stored ticks over [startTime, endTime] into synthetic
+  // ticks and 1m candles, stored in batches of about kSyntheticBatchTicks
+  // and merged into memory. Returns the number of candles built. Runs for a
+  // while over long ranges; call it off latency-sensitive threads.
+  size_t buildSyntheticHistory(const std::string& name, uint64_t startTime, uint64_t endTime);
+  
+  // === Sparklines ===
+  // 24h sparklines for watchlists (all tracked symbols when `symbols` is
+  // empty). Symbols not seen on a stream yet are seeded once from stored
+  // candles.
+  SparklineService::Snapshot getSparklines(const std::vector<std::string>& symbols);
+  
+  // Fetch exchange info from API and apply only what changed to the
+  // registry and DB. The new registry is built off the lock and swapped in.
   void fetchExchangeInfoFromApi();
   
+  // Refresh symbol metadata in the background every interval, starting now
+  // unless exchangeInfo was fetched less than an interval ago
+  void startSymbolRefresh(std::chrono::minutes interval = std::chrono::minutes(60));
+  void stopSymbolRefresh();
+  
   // Get all quote assets (for filtering)
   std::vector<std::string> getQuoteAssets() const;
   
@@ -100,7 +166,7 @@ public:
   
   // === Smart DOM (Depth of Market) Management ===
   
-  // Update order book from depth stream
+  // Update order book from depth stream (quantity 0 removes the resting level)
   void updateOrderBook(const std::string& symbol, const std::vector<std::pair<double, double>>& bids, 
                        const std::vector<std::pair<double, double>>& asks);
   
@@ -119,15 +185,83 @@ public:
   // Get Volume Imbalance at a price level
   double getVolumeImbalance(const std::string& symbol, double price) const;
   
+  // Snapshot `depth` levels either side of the touch with POC and diagonal
+  // imbalance flags, all under one lock using the symbol's tick size
+  DomFrame getSmartDOMFrame(const std::string& symbol, int depth = 25, double ratio = 3.0) const;
+  
+  // Bumped on every book or trade update; lets publishers skip idle symbols
+  uint64_t getSmartDOMVersion(const std::string& symbol) const;
+  
+  // Drop a symbol's book and traded volume (replay seeks start from empty)
+  void clearSmartDOM(const std::string& symbol);
+  
+  // Microstructure signals computed from the same book and trade updates;
+  // add listeners for every sample
+  BookSignalEngine& bookSignals() { return bookSignals_; }
+  
+  // Iceberg and absorption events from trades joined with book refills
+  IcebergDetector& icebergs() { return icebergs_; }
+  
   // === Multi-timeframe candle aggregation ===
   // Aggregate 1m candles to higher timeframes (5m, 15m, 1h, 4h, 1D)
   std::vector<Candle> aggregateToTimeframe(const std::string& symbol, const std::string& interval) const;
+  
+  // === Downsampled history ===
+  // At most maxPoints candles for [startTime, endTime) from the symbol's
+  // candle pyramid, no finer than minResolutionMs. The pyramid is built from
+  // stored 1m candles on first use and kept current by live ticks. Empty when
+  // nothing is stored for the range.
+  CandlePyramid::Result getDownsampledHistory(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                              size_t maxPoints, DownsampleMode mode,
+                                              uint64_t minResolutionMs = 60000);
+  
+  // Drop a symbol's pyramid after stored candles changed in bulk
+  void invalidateHistory(const std::string& symbol);
+  
+  // Up to `count` candles of `interval` ending at the bucket containing
+  // `before` (exclusive), for scrolling back past the loaded history. Built
+  // from stored 1m candles; klines for the interval when none are stored.
+  // Empty when there is no older history, nullopt when the klines request
+  // failed (worth retrying later).
+  std::optional<std::vector<Candle>> getHistoryPage(const std::string& symbol, const std::string& interval,
+                                     uint64_t before, size_t count);
+  
+  // === Warm symbols (prefetch) ===
+  // Merge stored 1m candles into memory so aggregateToTimeframe serves the
+  // symbol without the database. The candle in progress is kept as live.
+  void loadCandles(const std::string& symbol, std::vector<Candle> candles);
+  
+  // Load the last `days` of 1m candles (klines at background priority when
+  // none are stored) and page the last kWarmTickSpanMs of ticks into the tick
+  // index for footprints. False when nothing could be loaded.
+  bool warmSymbol(const std::string& symbol, int days);
+  
+  // History is resident: a switch to the symbol renders from memory
+  bool isWarm(const std::string& symbol) const;
+  
+  // Approximate heap held by a symbol's candles and footprint levels
+  size_t residentBytes(const std::string& symbol) const;
+  
+  // Release a symbol's candles, pyramid and tick buckets. The current symbol
+  // is never evicted.
+  void evictSymbol(const std::string& symbol);
+  
+  // === Historical footprint rebuild ===
+  // Rebuild bars for a stored tick range on the worker pool and return them
+  // (getFootprint with barType/rowSize). Plain 1m TIME bars are also written
+  // to the candle cache and database.
+  std::vector<Candle> rebuildFootprints(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                        const BarSpec& spec = BarSpec{});
 
 private:
   void loadFromDatabase();
   void detectAndFillGaps();
   void fetchMissingData(uint64_t startTime, uint64_t endTime);
+  void fetchMissingTrades(const database::DataGap& gap);
   void processTicksToCandles(const std::vector<Tick>& ticks);
+  void applySymbolSnapshot(const std::vector<Symbol>& apiSymbols);
+  void applyTick(const std::string& symbol, const Tick& tick, bool background);
+  void flushDeferredWritesLocked();
   
   std::string currentSymbol_;
   std::shared_ptr<network::BinanceClient> networkClient_;
@@ -135,26 +269,73 @@ private:
   settings::AppSettings settings_;
   
   // Cached candles
-  std::map<std::string, std::vector<Candle>> candlesBySymbol_;
+  static constexpr size_t kMaxCandlesInMemory = 10000;
+  static constexpr uint64_t kWarmTickSpanMs = 60 * 60 * 1000;
+  std::map<std::string, CandleSeries> candlesBySymbol_;
+  std::set<std::string> warmSymbols_;  // History loaded, under dataMutex_
+  
+  // Worker pool for bulk candle/footprint builds
+  std::shared_ptr<ThreadPool> workerPool_;
+  FootprintBuilder footprintBuilder_;
+  
+  // Per-bucket tick archive for drill-downs (live ticks + pages from the DB)
+  TickIndex tickIndex_;
   
   // === Smart DOM (Depth of Market) Data ===
   // Using flat_map for cache-friendly price lookups
   std::map<std::string, flat_map<double, PriceBucket, std::greater<double>>> smartDOMBySymbol_;
+  std::map<std::string, uint64_t> smartDOMVersion_;
   mutable std::mutex smartDOMMutex_;
   mutable std::mutex dataMutex_;
   
+  // Watchlist sparklines, fed by miniTicker batches and live ticks
+  SparklineService sparklines_;
+  BookSignalEngine bookSignals_;
+  IcebergDetector icebergs_;
+  CorrelationEngine correlation_;
+  SyntheticInstruments synthetics_;
+  std::set<std::string> sparklineSeeded_;
+  std::mutex sparklineSeedMutex_;
+  static constexpr uint64_t kPricePersistIntervalMs = 60000;
+  std::atomic<uint64_t> lastPricePersistMs_{0};
+  
+  // Downsampling pyramids per symbol. Builds run outside the lock; one that
+  // started before an invalidation is served but not cached.
+  std::map<std::string, CandlePyramid> pyramids_;
+  uint64_t pyramidGeneration_ = 0;
+  std::mutex pyramidMutex_;
+  
+  static constexpr size_t kSyntheticBatchTicks = 50000;
+  
+  // Live writes postponed by the DEFERRED overload tier, under dataMutex_
+  static constexpr size_t kDeferredTickBatch = 5000;
+  std::map<std::string, std::vector<Tick>> deferredTicks_;
+  // Background ticks awaiting their batched write, under dataMutex_
+  static constexpr size_t kBackgroundTickBatch = 1000;
+  std::map<std::string, std::vector<Tick>> backgroundTicks_;
+  
   // Callbacks
   OnDataUpdateCallback onDataUpdate_;
   OnGapFilledCallback onGapFilled_;
   
   // === Symbol Storage with flat_map and secondary indices ===
-  // Using flat_map (sorted vector) for cache locality
-  flat_map<std::string, Symbol> symbols_;
+  // Using flat_map (sorted vector) for cache locality; ascending by name,
+  // the order symbol snapshots are built and merged in
+  flat_map<std::string, Symbol, std::less<std::string>> symbols_;
   // Secondary indices for filtering
   std::unordered_map<std::string, std::vector<std::string>> symbolsByQuoteAsset_;  // quoteAsset -> symbols
   std::unordered_map<std::string, std::vector<std::string>> symbolsByBaseAsset_;    // baseAsset -> symbols
   mutable std::mutex symbolMutex_;
   
+  // Scheduled exchangeInfo refresh; symbolRefreshMutex_ serialises refreshes
+  std::mutex symbolRefreshMutex_;
+  std::thread refreshThread_;
+  std::mutex refreshStateMutex_;
+  std::condition_variable refreshCv_;
+  bool refreshRunning_ = false;
+  std::chrono::steady_clock::time_point lastSymbolFetch_ =
+      std::chrono::steady_clock::time_point::min();  // Under refreshStateMutex_
+  
   // State
   std::atomic<bool> isLoadingHistory_{false};
   std::atomic<bool> isInitialized_{false};
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
 #include <unordered_map>
 
 namespace glora {
@@ -12,84 +14,86 @@ namespace core {
 
 // Custom flat_map for better cache locality - similar to std::flat_map in C++23
 // Uses sorted vectors instead of tree nodes for better memory layout
-template<typename Key, typename Value, typename Compare = std::greater<Key>>
+template<typename Key, typename Value, typename Compare = std::greater<Key>,
+         typename Allocator = std::allocator<std::pair<Key, Value>>>
 class flat_map {
+public:
+    using container_type = std::vector<std::pair<Key, Value>, Allocator>;
+    using allocator_type = Allocator;
+
 private:
-    std::vector<std::pair<Key, Value>> data_;
+    container_type data_;
     Compare comp_;
     
-    void sort() {
-        std::sort(data_.begin(), data_.end(), 
-            [this](const auto& a, const auto& b) {
-                return comp_(a.first, b.first);
-            });
-    }
-    
 public:
-    using iterator = typename std::vector<std::pair<Key, Value>>::iterator;
-    using const_iterator = typename std::vector<std::pair<Key, Value>>::const_iterator;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
     
     flat_map() = default;
+    explicit flat_map(const Allocator& alloc) : data_(alloc) {}
+    
+    allocator_type get_allocator() const { return data_.get_allocator(); }
+    
+    // Keys are kept ordered by Compare, so lookups are a binary search and an
+    // insert shifts the tail once instead of re-sorting
+    iterator lower_bound(const Key& key) {
+        return std::lower_bound(data_.begin(), data_.end(), key,
+            [this](const auto& pair, const Key& k) { return comp_(pair.first, k); });
+    }
+    
+    const_iterator lower_bound(const Key& key) const {
+        return std::lower_bound(data_.begin(), data_.end(), key,
+            [this](const auto& pair, const Key& k) { return comp_(pair.first, k); });
+    }
     
     Value& operator[](const Key& key) {
-        // Find existing key
-        for (auto& pair : data_) {
-            if (!comp_(key, pair.first) && !comp_(pair.first, key)) {
-                return pair.second;
-            }
-        }
-        // Insert new key
-        data_.emplace_back(key, Value{});
-        sort();
-        // Return reference to newly inserted
-        for (auto& pair : data_) {
-            if (!comp_(key, pair.first) && !comp_(pair.first, key)) {
-                return pair.second;
-            }
+        auto it = lower_bound(key);
+        if (it != data_.end() && !comp_(key, it->first)) {
+            return it->second;
         }
-        return data_.back().second; // Fallback
+        return data_.emplace(it, key, Value{})->second;
     }
     
     const Value& operator[](const Key& key) const {
         static Value empty;
-        for (const auto& pair : data_) {
-            if (!comp_(key, pair.first) && !comp_(pair.first, key)) {
-                return pair.second;
-            }
-        }
-        return empty;
+        auto it = find(key);
+        return it != data_.end() ? it->second : empty;
     }
     
     iterator find(const Key& key) {
-        for (auto it = data_.begin(); it != data_.end(); ++it) {
-            if (!comp_(key, it->first) && !comp_(it->first, key)) {
-                return it;
-            }
+        auto it = lower_bound(key);
+        if (it != data_.end() && !comp_(key, it->first)) {
+            return it;
         }
         return data_.end();
     }
     
     const_iterator find(const Key& key) const {
-        for (auto it = data_.begin(); it != data_.end(); ++it) {
-            if (!comp_(key, it->first) && !comp_(it->first, key)) {
-                return it;
-            }
+        auto it = lower_bound(key);
+        if (it != data_.end() && !comp_(key, it->first)) {
+            return it;
         }
         return data_.end();
     }
     
     void erase(const Key& key) {
-        data_.erase(
-            std::remove_if(data_.begin(), data_.end(),
-                [this, &key](const auto& pair) {
-                    return !comp_(key, pair.first) && !comp_(pair.first, key);
-                }),
-            data_.end()
-        );
+        auto it = find(key);
+        if (it != data_.end()) {
+            data_.erase(it);
+        }
     }
     
+    iterator erase(iterator it) { return data_.erase(it); }
+    
     size_t size() const { return data_.size(); }
     bool empty() const { return data_.empty(); }
+    void reserve(size_t n) { data_.reserve(n); }
+    
+    // Bulk build: take ownership of entries already ordered by Compare
+    // with unique keys, skipping the per-insert sort of operator[]
+    void assign_sorted(container_type&& sorted) {
+        data_ = std::move(sorted);
+    }
     
     iterator begin() { return data_.begin(); }
     iterator end() { return data_.end(); }
@@ -97,6 +101,9 @@ public:
     const_iterator end() const { return data_.end(); }
     
     void clear() { data_.clear(); }
+    
+    // Drop all entries and hand the storage back to the allocator
+    void release() { container_type(data_.get_allocator()).swap(data_); }
 };
 
 // Represents a single trade from the exchange
@@ -106,6 +113,19 @@ struct Tick {
   double quantity;       // Execution quantity
   bool is_buyer_maker;   // Determines if the trade was an active SELL (true) or
                          // active BUY (false)
+  int64_t trade_id = 0;  // Exchange aggTrade ID ("a"), 0 when the source has none
+};
+
+// Rolling 24h statistics for one symbol from the miniTicker stream
+struct MiniTicker {
+  std::string symbol;
+  uint64_t eventTime = 0;  // Exchange event time (ms)
+  double open = 0.0;       // Price 24h ago
+  double high = 0.0;
+  double low = 0.0;
+  double close = 0.0;      // Last price
+  double volume = 0.0;     // Base asset volume
+  double quoteVolume = 0.0;
 };
 
 // Symbol metadata from exchange info
@@ -136,6 +156,24 @@ struct Symbol {
   // Filter helpers
   bool isTrading() const { return status == "TRADING"; }
   bool isSpot() const { return permissions.find("SPOT") != std::string::npos; }
+  
+  // Same exchange metadata (status, assets, filters); live price fields are ignored
+  bool sameMetadata(const Symbol& other) const {
+    return symbol == other.symbol && baseAsset == other.baseAsset && quoteAsset == other.quoteAsset &&
+           status == other.status && permissions == other.permissions &&
+           minPrice == other.minPrice && maxPrice == other.maxPrice && tickSize == other.tickSize &&
+           minQty == other.minQty && maxQty == other.maxQty && stepSize == other.stepSize &&
+           minNotional == other.minNotional;
+  }
+};
+
+// Registry changes between two exchangeInfo snapshots
+struct SymbolDiff {
+  std::vector<Symbol> added;
+  std::vector<Symbol> changed;        // Status, permissions or filters differ
+  std::vector<std::string> removed;   // No longer listed in exchangeInfo
+  
+  bool empty() const { return added.empty() && changed.empty() && removed.empty(); }
 };
 
 // Tracks Bid and Ask volume at a specific price level for the Footprint
@@ -146,8 +184,18 @@ struct PriceNode {
 
 // A single candlestick containing OHLCV and Footprint profile
 struct Candle {
-  uint64_t start_time_ms; // Interval start time
-  uint64_t end_time_ms;   // Interval end time
+  // Footprint levels come from a polymorphic allocator so a candle series can
+  // place them in its own pool (see CandleSeries). Copies of a candle always
+  // use the default heap resource.
+  using Footprint = flat_map<double, PriceNode, std::greater<double>,
+                             std::pmr::polymorphic_allocator<std::pair<double, PriceNode>>>;
+
+  Candle() = default;
+  explicit Candle(std::pmr::memory_resource* footprintResource)
+      : footprint_profile(Footprint::allocator_type(footprintResource)) {}
+
+  uint64_t start_time_ms = 0; // Interval start time
+  uint64_t end_time_ms = 0;   // Interval end time
 
   double open = 0.0;
   double high = 0.0;
@@ -157,8 +205,8 @@ struct Candle {
 
   // Footprint Profile: Price -> [Bid Vol, Ask Vol]
   // Using flat_map (sorted vector) instead of std::map for better cache locality
-  // This provides O(n) lookup but with much better memory access patterns
-  flat_map<double, PriceNode, std::greater<double>> footprint_profile;
+  // This provides O(log n) lookup with much better memory access patterns
+  Footprint footprint_profile;
 
   void add_tick(const Tick &tick) {
     // Update OHLC
@@ -199,6 +247,22 @@ struct PriceBucket {
     double getNetVolume() const { return getTotalBidVol() - getTotalAskVol(); }
 };
 
+// One Smart DOM level as published to the frontend
+struct DomLevel {
+    PriceBucket bucket;
+    bool imbalance = false;  // Diagonal imbalance against the level one tick below
+};
+
+// Smart DOM window around the touch, taken under a single lock. POC and
+// imbalance flags are computed once per frame rather than per level.
+struct DomFrame {
+    std::string symbol;
+    uint64_t version = 0;          // Book version the frame was taken at
+    double tickSize = 0.0;         // Exchange tick size, or inferred from the book
+    double poc = 0.0;              // Price with the highest total volume
+    std::vector<DomLevel> levels;  // Highest price first
+};
+
 // Holds the historical and current series of candles for a symbol
 struct SymbolData {
   std::string symbol; // e.g. "BTCUSDT"
@@ -0,0 +1,235 @@
+#include "Downsampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+void mergeInto(Candle& bucket, const Candle& candle, bool first) {
+  if (first) {
+    bucket.open = candle.open;
+    bucket.high = candle.high;
+    bucket.low = candle.low;
+  } else {
+    bucket.high = std::max(bucket.high, candle.high);
+    bucket.low = std::min(bucket.low, candle.low);
+  }
+  bucket.close = candle.close;
+  bucket.volume += candle.volume;
+}
+
+// Candles of a sorted level overlapping [startTime, endTime); a coarse bucket
+// straddling the start is included whole
+std::pair<const Candle*, const Candle*> rangeOf(const std::vector<Candle>& level, uint64_t startTime,
+                                                uint64_t endTime) {
+  auto endsBy = [](const Candle& candle, uint64_t time) { return candle.end_time_ms <= time; };
+  auto startsBefore = [](const Candle& candle, uint64_t time) { return candle.start_time_ms < time; };
+  auto first = std::lower_bound(level.begin(), level.end(), startTime, endsBy);
+  auto last = std::lower_bound(first, level.end(), endTime, startsBefore);
+  return {level.data() + (first - level.begin()), level.data() + (last - level.begin())};
+}
+
+} // namespace
+
+std::optional<DownsampleMode> parseDownsampleMode(const std::string& name) {
+  if (name == "ohlc") return DownsampleMode::OHLC;
+  if (name == "lttb") return DownsampleMode::LTTB;
+  return std::nullopt;
+}
+
+Candle ohlcvOnly(const Candle& candle) {
+  Candle copy;
+  copy.start_time_ms = candle.start_time_ms;
+  copy.end_time_ms = candle.end_time_ms;
+  copy.open = candle.open;
+  copy.high = candle.high;
+  copy.low = candle.low;
+  copy.close = candle.close;
+  copy.volume = candle.volume;
+  return copy;
+}
+
+std::vector<Candle> mergeCandles(const Candle* begin, const Candle* end, uint64_t bucketMs) {
+  std::vector<Candle> merged;
+  for (const Candle* candle = begin; candle != end; ++candle) {
+    uint64_t bucketStart = candle->start_time_ms / bucketMs * bucketMs;
+    bool first = merged.empty() || merged.back().start_time_ms != bucketStart;
+    if (first) {
+      merged.emplace_back();
+      merged.back().start_time_ms = bucketStart;
+      merged.back().end_time_ms = bucketStart + bucketMs;
+    }
+    mergeInto(merged.back(), *candle, first);
+  }
+  return merged;
+}
+
+std::vector<Candle> lttb(const Candle* begin, const Candle* end, size_t threshold) {
+  size_t count = static_cast<size_t>(end - begin);
+  std::vector<Candle> sampled;
+  if (threshold >= count || threshold < 3) {
+    for (const Candle* candle = begin; candle != end; ++candle) {
+      sampled.push_back(ohlcvOnly(*candle));
+    }
+    return sampled;
+  }
+
+  sampled.reserve(threshold);
+  // Times relative to the first candle keep the areas in double precision
+  uint64_t origin = begin->start_time_ms;
+  auto x = [&](size_t i) { return static_cast<double>(begin[i].start_time_ms - origin); };
+  auto y = [&](size_t i) { return begin[i].close; };
+
+  double every = static_cast<double>(count - 2) / static_cast<double>(threshold - 2);
+  size_t selected = 0;
+  sampled.push_back(ohlcvOnly(begin[0]));
+
+  for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+    // Average of the next bucket is the third triangle vertex
+    size_t nextStart = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+    size_t nextEnd = std::min(static_cast<size_t>(std::floor((bucket + 2) * every)) + 1, count);
+    double avgX = 0.0;
+    double avgY = 0.0;
+    for (size_t i = nextStart; i < nextEnd; ++i) {
+      avgX += x(i);
+      avgY += y(i);
+    }
+    double span = static_cast<double>(std::max<size_t>(nextEnd - nextStart, 1));
+    avgX /= span;
+    avgY /= span;
+
+    size_t from = static_cast<size_t>(std::floor(bucket * every)) + 1;
+    size_t to = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+    double maxArea = -1.0;
+    size_t best = from;
+    for (size_t i = from; i < to; ++i) {
+      double area = std::abs((x(selected) - avgX) * (y(i) - y(selected)) -
+                             (x(selected) - x(i)) * (avgY - y(selected)));
+      if (area > maxArea) {
+        maxArea = area;
+        best = i;
+      }
+    }
+    sampled.push_back(ohlcvOnly(begin[best]));
+    selected = best;
+  }
+
+  sampled.push_back(ohlcvOnly(begin[count - 1]));
+  return sampled;
+}
+
+void CandlePyramid::build(const std::vector<Candle>& base, uint64_t coverStart, uint64_t coverEnd) {
+  levels_[0].clear();
+  levels_[0].reserve(base.size());
+  for (const auto& candle : base) {
+    levels_[0].push_back(ohlcvOnly(candle));
+  }
+  for (size_t level = 1; level < kLevelMs.size(); ++level) {
+    const auto& finer = levels_[level - 1];
+    levels_[level] = mergeCandles(finer.data(), finer.data() + finer.size(), kLevelMs[level]);
+  }
+  coverStart_ = coverStart;
+  coverEnd_ = coverEnd;
+  live_ = false;
+}
+
+void CandlePyramid::invalidate() {
+  for (auto& level : levels_) {
+    level.clear();
+  }
+  coverStart_ = 0;
+  coverEnd_ = 0;
+  live_ = false;
+}
+
+void CandlePyramid::update(const Candle& candle) {
+  auto& base = levels_[0];
+  if (base.empty()) return;
+  // A candle past the covered range would leave a hole the pyramid claims to
+  // cover; drop everything and let the next query rebuild from storage
+  if (candle.start_time_ms > coverEnd_) {
+    invalidate();
+    return;
+  }
+  if (base.back().start_time_ms == candle.start_time_ms) {
+    base.back() = ohlcvOnly(candle);
+  } else if (candle.start_time_ms > base.back().start_time_ms) {
+    base.push_back(ohlcvOnly(candle));
+  } else {
+    return;
+  }
+  live_ = true;
+  coverEnd_ = std::max(coverEnd_, candle.end_time_ms);
+
+  // Each level's last bucket from the tail of the level below
+  for (size_t level = 1; level < kLevelMs.size(); ++level) {
+    const auto& finer = levels_[level - 1];
+    auto& coarse = levels_[level];
+    uint64_t bucketStart = candle.start_time_ms / kLevelMs[level] * kLevelMs[level];
+
+    size_t from = finer.size();
+    while (from > 0 && finer[from - 1].start_time_ms >= bucketStart) {
+      --from;
+    }
+    Candle bucket;
+    bucket.start_time_ms = bucketStart;
+    bucket.end_time_ms = bucketStart + kLevelMs[level];
+    for (size_t i = from; i < finer.size(); ++i) {
+      mergeInto(bucket, finer[i], i == from);
+    }
+
+    if (!coarse.empty() && coarse.back().start_time_ms == bucketStart) {
+      coarse.back() = bucket;
+    } else {
+      coarse.push_back(bucket);
+    }
+  }
+}
+
+bool CandlePyramid::covers(uint64_t startTime, uint64_t endTime) const {
+  return !empty() && startTime >= coverStart_ && (live_ || endTime <= coverEnd_);
+}
+
+CandlePyramid::Result CandlePyramid::query(uint64_t startTime, uint64_t endTime, size_t maxPoints,
+                                           DownsampleMode mode, uint64_t minResolutionMs) const {
+  Result result;
+  if (empty() || endTime <= startTime || maxPoints == 0) return result;
+
+  auto [baseBegin, baseEnd] = rangeOf(levels_[0], startTime, endTime);
+  result.sourceCount = static_cast<size_t>(baseEnd - baseBegin);
+
+  size_t level = 0;
+  while (level + 1 < kLevelMs.size() && kLevelMs[level] < minResolutionMs) {
+    ++level;
+  }
+
+  // Finest level within budget (with LTTB's oversampling headroom)
+  size_t budget = mode == DownsampleMode::LTTB ? maxPoints * kLttbOversample : maxPoints;
+  auto [begin, end] = rangeOf(levels_[level], startTime, endTime);
+  while (static_cast<size_t>(end - begin) > budget && level + 1 < kLevelMs.size()) {
+    ++level;
+    std::tie(begin, end) = rangeOf(levels_[level], startTime, endTime);
+  }
+  size_t count = static_cast<size_t>(end - begin);
+  result.resolutionMs = kLevelMs[level];
+
+  if (count <= maxPoints) {
+    result.candles.assign(begin, end);
+  } else if (mode == DownsampleMode::LTTB) {
+    result.candles = lttb(begin, end, maxPoints);
+  } else {
+    // Wider than the coarsest level: merge whole days. Epoch alignment can
+    // add a partial bucket at each end, so widen until it fits.
+    uint64_t factor = (count + maxPoints - 1) / maxPoints;
+    do {
+      result.resolutionMs = kLevelMs[level] * factor++;
+      result.candles = mergeCandles(begin, end, result.resolutionMs);
+    } while (result.candles.size() > maxPoints);
+  }
+  return result;
+}
+
+} // namespace core
+} // namespace glora
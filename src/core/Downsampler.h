@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DataModels.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// How a candle range is reduced to a point budget
+enum class DownsampleMode {
+  OHLC,  // Merge into wider candles: first open, max high, min low, last close
+  LTTB   // Largest-Triangle-Three-Buckets on closes, for line charts
+};
+
+// "ohlc" or "lttb"
+std::optional<DownsampleMode> parseDownsampleMode(const std::string& name);
+
+// Copy of a candle's OHLCV without its footprint
+Candle ohlcvOnly(const Candle& candle);
+
+// Merge time-sorted candles into buckets of bucketMs aligned to the epoch, so
+// the same bucket has the same bounds in every request
+std::vector<Candle> mergeCandles(const Candle* begin, const Candle* end, uint64_t bucketMs);
+
+// Pick `threshold` candles that keep the visual shape of the close line. The
+// first and last candles are always kept.
+std::vector<Candle> lttb(const Candle* begin, const Candle* end, size_t threshold);
+
+// One symbol's 1m candles plus precomputed coarser levels (5m to 1d).
+//
+// A query serves a range from the finest level that fits the point budget,
+// so zooming in refines automatically: the same maxPoints over a narrower
+// range lands on a finer level. Live updates to the last 1m candle only
+// recompute the last bucket of each level.
+class CandlePyramid {
+public:
+  static constexpr std::array<uint64_t, 6> kLevelMs{
+    60'000, 300'000, 900'000, 3'600'000, 14'400'000, 86'400'000};
+
+  // LTTB starts from a level with at most this many candles per output point
+  static constexpr size_t kLttbOversample = 8;
+
+  struct Result {
+    std::vector<Candle> candles;
+    uint64_t resolutionMs = 0;  // Bucket width of the returned candles (source level for LTTB)
+    size_t sourceCount = 0;     // 1m candles in the range
+  };
+
+  // Rebuild from time-sorted 1m candles covering [coverStart, coverEnd)
+  void build(const std::vector<Candle>& base, uint64_t coverStart, uint64_t coverEnd);
+
+  // Apply a new or updated last 1m candle; older candles are left to the
+  // next rebuild. Marks the pyramid live: it then covers any end time. A
+  // candle starting past the covered range invalidates the pyramid instead.
+  void update(const Candle& candle);
+
+  // Drop all levels; empty until the next build()
+  void invalidate();
+
+  bool covers(uint64_t startTime, uint64_t endTime) const;
+  bool empty() const { return levels_[0].empty(); }
+  uint64_t coverStart() const { return coverStart_; }
+  uint64_t coverEnd() const { return coverEnd_; }
+
+  // At most maxPoints candles for [startTime, endTime), no finer than
+  // minResolutionMs
+  Result query(uint64_t startTime, uint64_t endTime, size_t maxPoints, DownsampleMode mode,
+               uint64_t minResolutionMs) const;
+
+private:
+  std::array<std::vector<Candle>, kLevelMs.size()> levels_;
+  uint64_t coverStart_ = 0;
+  uint64_t coverEnd_ = 0;
+  bool live_ = false;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "DataModels.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// How a tick stream is cut into bars
+enum class BarType {
+  TIME,   // Fixed wall-clock interval (size = interval in ms)
+  TICK,   // Fixed number of trades per bar (size = trade count)
+  VOLUME  // Fixed traded quantity per bar (volumeSize)
+};
+
+struct BarSpec {
+  BarType type = BarType::TIME;
+  uint64_t size = 60000;   // Interval ms (TIME) or trade count (TICK)
+  double volumeSize = 0.0; // Quantity per bar (VOLUME)
+  double rowSize = 0.0;    // Footprint row height in price units, 0 = raw trade price
+};
+
+// Bulk footprint builder for historical tick ranges.
+//
+// The input range must be sorted by timestamp. It is first partitioned into
+// bar spans (binary search on bar boundaries for TIME bars), the spans are
+// split into contiguous batches that run on the thread pool, and the results
+// are concatenated in order. Each bar's levels are accumulated in a
+// thread-local arena and sorted once, instead of re-sorting the footprint on
+// every tick as Candle::add_tick does.
+class FootprintBuilder {
+public:
+  explicit FootprintBuilder(std::shared_ptr<ThreadPool> pool = nullptr);
+
+  // Build bars (OHLCV + footprint) for a time-sorted tick range
+  std::vector<Candle> build(const std::vector<Tick>& ticks, const BarSpec& spec) const;
+
+private:
+  using Span = std::pair<size_t, size_t>; // [first, last) tick indices
+
+  std::vector<Span> partition(const std::vector<Tick>& ticks, const BarSpec& spec) const;
+
+  std::shared_ptr<ThreadPool> pool_;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,85 @@
+#include "HistoryPager.h"
+#include "ThreadAffinity.h"
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+HistoryPager::HistoryPager(Loader loader) : loader_(std::move(loader)) {
+  thread_ = std::thread([this]() {
+    applyThreadRole(settings::ThreadRole::DECODE, "glora-pager");
+    run();
+  });
+}
+
+HistoryPager::~HistoryPager() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool HistoryPager::request(const std::string& symbol, uint64_t intervalMs, uint64_t before, size_t count) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inFlight_ || ready_ || exhausted_.count({symbol, intervalMs})) return false;
+    if (std::chrono::steady_clock::now() < retryAfter_) return false;
+    pending_ = Request{symbol, intervalMs, before, count};
+    inFlight_ = true;
+  }
+  cv_.notify_one();
+  return true;
+}
+
+std::optional<HistoryPager::Page> HistoryPager::poll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::optional<Page> page = std::move(ready_);
+  ready_.reset();
+  return page;
+}
+
+bool HistoryPager::exhausted(const std::string& symbol, uint64_t intervalMs) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return exhausted_.count({symbol, intervalMs}) > 0;
+}
+
+void HistoryPager::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return !running_ || pending_; });
+    if (!running_) return;
+
+    Request request = std::move(*pending_);
+    pending_.reset();
+    lock.unlock();
+
+    std::optional<std::vector<Candle>> candles;
+    if (loader_) {
+      candles = loader_(request.symbol, request.intervalMs, request.before, request.count);
+    }
+    if (candles) {
+      std::cout << "[HistoryPager] " << request.symbol << ": " << candles->size()
+                << " candles before " << request.before << std::endl;
+    } else {
+      std::cerr << "[HistoryPager] " << request.symbol << ": page before " << request.before
+                << " failed, retrying in " << kRetryDelayMs << " ms" << std::endl;
+    }
+
+    lock.lock();
+    if (!candles) {
+      retryAfter_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(kRetryDelayMs);
+    } else if (candles->empty()) {
+      exhausted_.insert({request.symbol, request.intervalMs});
+    } else {
+      ready_ = Page{request.symbol, request.intervalMs, request.before, std::move(*candles)};
+    }
+    inFlight_ = false;
+  }
+}
+
+} // namespace core
+} // namespace glora
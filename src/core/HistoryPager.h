@@ -0,0 +1,84 @@
+#pragma once
+
+#include "DataModels.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Loads older candle pages for a chart off the render thread.
+//
+// The chart asks for the page before its oldest candle when the camera nears
+// it. One page is in flight at a time; asks while it loads (or before its
+// result is picked up with poll()) are ignored, so a chart held at the edge
+// requests exactly one page per frame it is still near. A page that comes
+// back empty marks that symbol and interval exhausted; a failed load only
+// holds further requests off for kRetryDelayMs.
+class HistoryPager {
+public:
+  static constexpr size_t kDefaultPageSize = 500;
+  static constexpr int64_t kRetryDelayMs = 5000;
+
+  // `count` candles of intervalMs ending before `before`, time-sorted;
+  // nullopt when the page could not be loaded
+  using Loader = std::function<std::optional<std::vector<Candle>>(const std::string& symbol, uint64_t intervalMs,
+                                                                  uint64_t before, size_t count)>;
+
+  struct Page {
+    std::string symbol;
+    uint64_t intervalMs = 0;
+    uint64_t before = 0;
+    std::vector<Candle> candles;
+  };
+
+  explicit HistoryPager(Loader loader);
+  ~HistoryPager();
+
+  HistoryPager(const HistoryPager&) = delete;
+  HistoryPager& operator=(const HistoryPager&) = delete;
+
+  // False when a page is already loading or waiting, a failed load is
+  // backing off, or the history is exhausted
+  bool request(const std::string& symbol, uint64_t intervalMs, uint64_t before,
+               size_t count = kDefaultPageSize);
+
+  // The finished page, once
+  std::optional<Page> poll();
+
+  bool exhausted(const std::string& symbol, uint64_t intervalMs) const;
+
+private:
+  struct Request {
+    std::string symbol;
+    uint64_t intervalMs;
+    uint64_t before;
+    size_t count;
+  };
+
+  void run();
+
+  Loader loader_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::optional<Request> pending_;
+  std::optional<Page> ready_;
+  bool inFlight_ = false;
+  bool running_ = true;
+  std::chrono::steady_clock::time_point retryAfter_{};
+  std::set<std::pair<std::string, uint64_t>> exhausted_;
+  std::thread thread_;
+};
+
+} // namespace core
+} // namespace glora
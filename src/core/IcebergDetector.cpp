@@ -0,0 +1,177 @@
+#include "IcebergDetector.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+Counter& eventCounter(LiquidityEvent::Kind kind) {
+  auto& registry = MetricsRegistry::getInstance();
+  static Counter& icebergs = registry.counter("glora_liquidity_events_total", "Hidden liquidity events detected",
+                                              "kind=\"iceberg\"");
+  static Counter& absorptions = registry.counter("glora_liquidity_events_total", "Hidden liquidity events detected",
+                                                 "kind=\"absorption\"");
+  return kind == LiquidityEvent::Kind::ICEBERG ? icebergs : absorptions;
+}
+
+// Smallest positive gap between prices of one update, as a tick size guess
+double smallestStep(const IcebergDetector::Levels& bids, const IcebergDetector::Levels& asks) {
+  std::vector<double> prices;
+  prices.reserve(bids.size() + asks.size());
+  for (const auto& level : bids) prices.push_back(level.first);
+  for (const auto& level : asks) prices.push_back(level.first);
+  std::sort(prices.begin(), prices.end());
+  double step = 0.0;
+  for (size_t i = 1; i < prices.size(); ++i) {
+    double gap = prices[i] - prices[i - 1];
+    if (gap > 0.0 && (step == 0.0 || gap < step)) step = gap;
+  }
+  return step;
+}
+
+} // namespace
+
+const char* liquidityEventKindName(LiquidityEvent::Kind kind) {
+  return kind == LiquidityEvent::Kind::ICEBERG ? "iceberg" : "absorption";
+}
+
+IcebergDetector::Level& IcebergDetector::levelAt(Book& book, double price, uint64_t timeMs) {
+  int64_t tick = std::llround(price / book.tickSize);
+  Level& level = book.levels[static_cast<uint64_t>(tick) & (kSlots - 1)];
+  if (level.tick != tick || timeMs >= level.windowStart + kWindowMs) {
+    // New owner or an expired window; the displayed size is still current
+    double displayed = level.tick == tick ? level.displayed : 0.0;
+    bool bidSide = level.tick == tick ? level.bidSide : true;
+    level = Level{};
+    level.tick = tick;
+    level.windowStart = timeMs;
+    level.displayed = displayed;
+    level.peakDisplayed = displayed;
+    level.bidSide = bidSide;
+  }
+  return level;
+}
+
+void IcebergDetector::check(const Level& level, double price, uint64_t timeMs,
+                            std::vector<LiquidityEvent>& events) {
+  if (level.executed <= 0.0 || level.peakDisplayed <= 0.0) return;
+  double ratio = level.executed / level.peakDisplayed;
+
+  auto emit = [&](LiquidityEvent::Kind kind) {
+    LiquidityEvent event;
+    event.kind = kind;
+    event.price = price;
+    event.bidSide = level.bidSide;
+    event.executed = level.executed;
+    event.displayed = level.peakDisplayed;
+    event.refills = level.refills;
+    event.timeMs = timeMs;
+    events.push_back(event);
+  };
+  if (!level.icebergReported && level.refills >= kMinRefills && ratio >= kIcebergRatio) {
+    emit(LiquidityEvent::Kind::ICEBERG);
+  }
+  if (!level.absorptionReported && level.displayed > 0.0 && ratio >= kAbsorptionRatio) {
+    emit(LiquidityEvent::Kind::ABSORPTION);
+  }
+}
+
+void IcebergDetector::applySide(Book& book, const Levels& side, bool bidSide, uint64_t timeMs,
+                                std::vector<LiquidityEvent>& events) {
+  for (const auto& [price, qty] : side) {
+    Level& level = levelAt(book, price, timeMs);
+    // Grew back against its last reported size after being traded into
+    if (qty > level.displayed && level.executedSinceRefill > 0.0) {
+      ++level.refills;
+      level.executedSinceRefill = 0.0;
+    }
+    level.displayed = qty;
+    level.peakDisplayed = std::max(level.peakDisplayed, qty);
+    if (qty > 0.0) level.bidSide = bidSide;
+
+    size_t before = events.size();
+    check(level, price, timeMs, events);
+    for (size_t i = before; i < events.size(); ++i) {
+      (events[i].kind == LiquidityEvent::Kind::ICEBERG ? level.icebergReported : level.absorptionReported) = true;
+    }
+  }
+}
+
+void IcebergDetector::onBook(const std::string& symbol, const Levels& bids, const Levels& asks,
+                             double tickSize, uint64_t timeMs) {
+  std::vector<LiquidityEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& book = books_[symbol];
+    if (book.tickSize <= 0.0) {
+      book.tickSize = tickSize > 0.0 ? tickSize : smallestStep(bids, asks);
+      if (book.tickSize <= 0.0) {
+        books_.erase(symbol);
+        return;
+      }
+      book.levels.assign(kSlots, Level{});
+    }
+    applySide(book, bids, true, timeMs, events);
+    applySide(book, asks, false, timeMs, events);
+  }
+  notify(symbol, events);
+}
+
+void IcebergDetector::onTrade(const std::string& symbol, const Tick& tick, uint64_t timeMs) {
+  std::vector<LiquidityEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = books_.find(symbol);
+    if (it == books_.end()) return;
+
+    Level& level = levelAt(it->second, tick.price, timeMs);
+    // Buyer as maker: a seller hit a resting bid
+    level.bidSide = tick.is_buyer_maker;
+    level.executed += tick.quantity;
+    level.executedSinceRefill += tick.quantity;
+
+    check(level, tick.price, timeMs, events);
+    for (const auto& event : events) {
+      (event.kind == LiquidityEvent::Kind::ICEBERG ? level.icebergReported : level.absorptionReported) = true;
+    }
+  }
+  notify(symbol, events);
+}
+
+void IcebergDetector::clear(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  books_.erase(symbol);
+}
+
+size_t IcebergDetector::addListener(Listener listener) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  size_t id = nextListenerId_++;
+  listeners_.emplace_back(id, std::move(listener));
+  return id;
+}
+
+void IcebergDetector::removeListener(size_t id) {
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                  [id](const auto& entry) { return entry.first == id; }),
+                   listeners_.end());
+}
+
+void IcebergDetector::notify(const std::string& symbol, const std::vector<LiquidityEvent>& events) {
+  if (events.empty()) return;
+  for (const auto& event : events) {
+    eventCounter(event.kind).inc();
+  }
+  std::lock_guard<std::mutex> lock(listenersMutex_);
+  for (const auto& [id, listener] : listeners_) {
+    for (const auto& event : events) {
+      listener(symbol, event);
+    }
+  }
+}
+
+} // namespace core
+} // namespace glora
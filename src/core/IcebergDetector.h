@@ -0,0 +1,106 @@
+#pragma once
+
+#include "DataModels.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Hidden liquidity seen at one price level
+struct LiquidityEvent {
+  enum class Kind { ICEBERG, ABSORPTION };
+
+  Kind kind = Kind::ICEBERG;
+  double price = 0.0;
+  bool bidSide = true;      // Resting side that took the executions
+  double executed = 0.0;    // Volume traded into the level this window
+  double displayed = 0.0;   // Largest size the book showed this window
+  uint32_t refills = 0;     // Times the level grew back after executions
+  uint64_t timeMs = 0;
+};
+
+const char* liquidityEventKindName(LiquidityEvent::Kind kind);
+
+// Joins the trade stream with book deltas at the same price to find hidden
+// liquidity: levels where executed volume far exceeds the displayed size.
+//
+// Levels live in a direct-mapped array of kSlots indexed by price in ticks,
+// so every trade and every book delta is O(1) and prices within kSlots ticks
+// of each other never share a slot; a slot reused by a far price starts over.
+// Each level counts executions, its peak displayed size and refills (the
+// book reporting a larger size than before after the level was traded into)
+// over a window of kWindowMs from its first activity. Displayed sizes are
+// only ever what the book reported; trades do not adjust them.
+//
+// - ICEBERG: at least kMinRefills refills and executed >= kIcebergRatio x peak displayed
+// - ABSORPTION: executed >= kAbsorptionRatio x peak displayed with the level still resting
+//
+// Each kind is reported at most once per level and window, to listeners on
+// the thread that applied the update. Symbols without a book are ignored.
+class IcebergDetector {
+public:
+  static constexpr size_t kSlots = 8192;
+  static constexpr uint64_t kWindowMs = 60 * 1000;
+  static constexpr uint32_t kMinRefills = 2;
+  static constexpr double kIcebergRatio = 3.0;
+  static constexpr double kAbsorptionRatio = 5.0;
+
+  using Levels = std::vector<std::pair<double, double>>;
+  using Listener = std::function<void(const std::string& symbol, const LiquidityEvent& event)>;
+
+  // Book deltas (quantity 0 removes the level). Without a tick size the
+  // smallest step in the first update is used.
+  void onBook(const std::string& symbol, const Levels& bids, const Levels& asks, double tickSize, uint64_t timeMs);
+
+  // timeMs must be on the same clock as onBook's, which drives the windows
+  void onTrade(const std::string& symbol, const Tick& tick, uint64_t timeMs);
+
+  void clear(const std::string& symbol);
+
+  // Returns an id for removeListener
+  size_t addListener(Listener listener);
+  void removeListener(size_t id);
+
+private:
+  static constexpr int64_t kEmptySlot = INT64_MIN;
+
+  struct Level {
+    int64_t tick = kEmptySlot;  // Which price owns the slot
+    uint64_t windowStart = 0;
+    double displayed = 0.0;       // Last size the book reported
+    double peakDisplayed = 0.0;
+    double executed = 0.0;
+    double executedSinceRefill = 0.0;
+    uint32_t refills = 0;
+    bool bidSide = true;
+    bool icebergReported = false;
+    bool absorptionReported = false;
+  };
+
+  struct Book {
+    double tickSize = 0.0;
+    std::vector<Level> levels;
+  };
+
+  Level& levelAt(Book& book, double price, uint64_t timeMs);
+  void check(const Level& level, double price, uint64_t timeMs, std::vector<LiquidityEvent>& events);
+  void applySide(Book& book, const Levels& side, bool bidSide, uint64_t timeMs, std::vector<LiquidityEvent>& events);
+  void notify(const std::string& symbol, const std::vector<LiquidityEvent>& events);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Book> books_;
+
+  std::mutex listenersMutex_;
+  std::vector<std::pair<size_t, Listener>> listeners_;
+  size_t nextListenerId_ = 1;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,225 @@
+#include "MemoryArena.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+constexpr size_t kSubsystemCount = static_cast<size_t>(AllocSubsystem::Count);
+
+struct SubsystemCounters {
+  std::atomic<uint64_t> heapAllocs{0};
+  std::atomic<uint64_t> heapFrees{0};
+  std::atomic<uint64_t> heapBytes{0};
+  std::atomic<uint64_t> arenaBlocks{0};
+  std::atomic<uint64_t> arenaBytes{0};
+};
+
+// Constant-initialized so they are usable from operator new during static init
+SubsystemCounters g_counters[kSubsystemCount];
+thread_local AllocSubsystem t_subsystem = AllocSubsystem::General;
+
+SubsystemCounters& countersFor(AllocSubsystem subsystem) {
+  return g_counters[static_cast<size_t>(subsystem)];
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Offset at or after `offset` whose address in `data` is `alignment` aligned.
+// Blocks are only max_align_t aligned, so over-aligned requests need the address.
+size_t alignOffset(const std::byte* data, size_t offset, size_t alignment) {
+  auto address = reinterpret_cast<uintptr_t>(data) + offset;
+  return offset + (alignUp(address, alignment) - address);
+}
+
+} // namespace
+
+const char* allocSubsystemName(AllocSubsystem subsystem) {
+  switch (subsystem) {
+    case AllocSubsystem::General: return "general";
+    case AllocSubsystem::Frame: return "frame";
+    case AllocSubsystem::Request: return "request";
+    case AllocSubsystem::RestPage: return "restPage";
+    case AllocSubsystem::Tick: return "tick";
+    default: return "unknown";
+  }
+}
+
+AllocStats allocStats(AllocSubsystem subsystem) {
+  const auto& counters = countersFor(subsystem);
+  AllocStats stats;
+  stats.heapAllocs = counters.heapAllocs.load(std::memory_order_relaxed);
+  stats.heapFrees = counters.heapFrees.load(std::memory_order_relaxed);
+  stats.heapBytes = counters.heapBytes.load(std::memory_order_relaxed);
+  stats.arenaBlocks = counters.arenaBlocks.load(std::memory_order_relaxed);
+  stats.arenaBytes = counters.arenaBytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+bool allocTrackingEnabled() {
+#ifdef GLORA_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void logAllocStats() {
+  for (size_t i = 0; i < kSubsystemCount; ++i) {
+    auto subsystem = static_cast<AllocSubsystem>(i);
+    AllocStats stats = allocStats(subsystem);
+    std::printf("[Alloc] %-8s heap allocs=%llu frees=%llu bytes=%llu | arena blocks=%llu bytes=%llu\n",
+                allocSubsystemName(subsystem),
+                static_cast<unsigned long long>(stats.heapAllocs),
+                static_cast<unsigned long long>(stats.heapFrees),
+                static_cast<unsigned long long>(stats.heapBytes),
+                static_cast<unsigned long long>(stats.arenaBlocks),
+                static_cast<unsigned long long>(stats.arenaBytes));
+  }
+  if (!allocTrackingEnabled()) {
+    std::printf("[Alloc] heap counters disabled (build with -DGLORA_ALLOC_TRACKING=ON)\n");
+  }
+}
+
+AllocSubsystem currentAllocSubsystem() {
+  return t_subsystem;
+}
+
+ScopedAllocTag::ScopedAllocTag(AllocSubsystem subsystem) : previous_(t_subsystem) {
+  t_subsystem = subsystem;
+}
+
+ScopedAllocTag::~ScopedAllocTag() {
+  t_subsystem = previous_;
+}
+
+// ============================================================================
+// ScratchArena
+// ============================================================================
+
+ScratchArena::ScratchArena(AllocSubsystem subsystem, size_t initialBytes,
+                           std::pmr::memory_resource* upstream)
+    : subsystem_(subsystem), upstream_(upstream) {
+  if (initialBytes > 0) {
+    addBlock(initialBytes, alignof(std::max_align_t));
+  }
+}
+
+ScratchArena::~ScratchArena() {
+  for (const auto& block : blocks_) {
+    upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+  }
+}
+
+void ScratchArena::reset() {
+  highWater_ = std::max(highWater_, used_);
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+  while (current_ < blocks_.size()) {
+    Block& block = blocks_[current_];
+    size_t start = alignOffset(block.data, offset_, alignment);
+    if (start + bytes <= block.size) {
+      offset_ = start + bytes;
+      used_ += bytes;
+      return block.data + start;
+    }
+    // Move on to the next retained block
+    ++current_;
+    offset_ = 0;
+  }
+
+  // addBlock leaves `alignment` bytes of slack for the aligned start
+  addBlock(bytes, alignment);
+  current_ = blocks_.size() - 1;
+  size_t start = alignOffset(blocks_.back().data, 0, alignment);
+  offset_ = start + bytes;
+  used_ += bytes;
+  return blocks_.back().data + start;
+}
+
+void ScratchArena::addBlock(size_t minBytes, size_t alignment) {
+  // Geometric growth so a new working set settles in a few blocks
+  size_t size = std::max(minBytes + alignment, blocks_.empty() ? minBytes : capacity_);
+  size = alignUp(size, alignof(std::max_align_t));
+
+  auto* data = static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t)));
+  blocks_.push_back({data, size});
+  capacity_ += size;
+
+  auto& counters = countersFor(subsystem_);
+  counters.arenaBlocks.fetch_add(1, std::memory_order_relaxed);
+  counters.arenaBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // namespace core
+} // namespace glora
+
+// ============================================================================
+// Global heap instrumentation
+// ============================================================================
+#ifdef GLORA_ALLOC_TRACKING
+
+namespace {
+
+// Each block carries the subsystem it was allocated under in a header, so a
+// free is counted against the allocating subsystem, not the freeing thread's
+constexpr std::size_t kTagHeader = alignof(std::max_align_t);
+
+void* trackedAlloc(std::size_t size) {
+  glora::core::AllocSubsystem subsystem = glora::core::t_subsystem;
+  auto* block = static_cast<unsigned char*>(std::malloc(size + kTagHeader));
+  if (!block) return nullptr;
+  *block = static_cast<unsigned char>(subsystem);
+
+  auto& counters = glora::core::g_counters[static_cast<size_t>(subsystem)];
+  counters.heapAllocs.fetch_add(1, std::memory_order_relaxed);
+  counters.heapBytes.fetch_add(size, std::memory_order_relaxed);
+  return block + kTagHeader;
+}
+
+void trackedFree(void* ptr) {
+  if (!ptr) return;
+  auto* block = static_cast<unsigned char*>(ptr) - kTagHeader;
+  auto& counters = glora::core::g_counters[*block];
+  counters.heapFrees.fetch_add(1, std::memory_order_relaxed);
+  std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  if (void* ptr = trackedAlloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  if (void* ptr = trackedAlloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return trackedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return trackedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+
+#endif // GLORA_ALLOC_TRACKING
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Subsystems that allocations are attributed to
+enum class AllocSubsystem : uint8_t {
+  General = 0,
+  Frame,     // ImGui frame loop
+  Request,   // Frontend request handling
+  RestPage,  // REST page fetch + decode
+  Tick,      // Live tick processing
+  Count
+};
+
+const char* allocSubsystemName(AllocSubsystem subsystem);
+
+// Per-subsystem counters.
+// heap*  - global operator new/delete calls (only with GLORA_ALLOC_TRACKING)
+// arena* - blocks the scratch arenas had to take from their upstream
+struct AllocStats {
+  uint64_t heapAllocs = 0;
+  uint64_t heapFrees = 0;
+  uint64_t heapBytes = 0;
+  uint64_t arenaBlocks = 0;
+  uint64_t arenaBytes = 0;
+};
+
+AllocStats allocStats(AllocSubsystem subsystem);
+
+// True when the global operator new is instrumented
+bool allocTrackingEnabled();
+
+// Print one line per subsystem to stdout
+void logAllocStats();
+
+// Subsystem the calling thread's heap allocations are attributed to
+AllocSubsystem currentAllocSubsystem();
+
+// Attribute heap allocations on this thread to a subsystem for the scope
+class ScopedAllocTag {
+public:
+  explicit ScopedAllocTag(AllocSubsystem subsystem);
+  ~ScopedAllocTag();
+
+  ScopedAllocTag(const ScopedAllocTag&) = delete;
+  ScopedAllocTag& operator=(const ScopedAllocTag&) = delete;
+
+private:
+  AllocSubsystem previous_;
+};
+
+// Rewindable bump allocator for short-lived temporaries.
+//
+// Unlike std::pmr::monotonic_buffer_resource, reset() keeps every block it
+// has taken from upstream, so once the arena has grown to the working set of
+// a frame/request/page it stops touching the heap altogether. Deallocation is
+// a no-op. Any power-of-two alignment is honored, including over-aligned
+// types. Not thread safe; use one arena per thread.
+class ScratchArena : public std::pmr::memory_resource {
+public:
+  explicit ScratchArena(AllocSubsystem subsystem, size_t initialBytes = 64 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  ~ScratchArena() override;
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  // Rewind to the first block; everything allocated since is invalid
+  void reset();
+
+  // Bytes handed out since the last reset
+  size_t used() const { return used_; }
+
+  // Largest used() seen across resets
+  size_t highWater() const { return highWater_; }
+
+  // Total bytes held from upstream
+  size_t capacity() const { return capacity_; }
+
+private:
+  struct Block {
+    std::byte* data;
+    size_t size;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  void addBlock(size_t minBytes, size_t alignment);
+
+  AllocSubsystem subsystem_;
+  std::pmr::memory_resource* upstream_;
+  std::vector<Block> blocks_;
+  size_t current_ = 0;  // Index of the block being bumped
+  size_t offset_ = 0;   // Offset into blocks_[current_]
+  size_t used_ = 0;
+  size_t highWater_ = 0;
+  size_t capacity_ = 0;
+};
+
+// Reset an arena and tag the thread for the duration of a frame/request/page
+class ArenaScope {
+public:
+  explicit ArenaScope(ScratchArena& arena, AllocSubsystem subsystem)
+      : arena_(arena), tag_(subsystem) {
+    arena_.reset();
+  }
+
+  std::pmr::memory_resource* resource() { return &arena_; }
+
+private:
+  ScratchArena& arena_;
+  ScopedAllocTag tag_;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,285 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <set>
+
+namespace glora {
+namespace core {
+
+size_t metricShard() {
+  static std::atomic<size_t> nextShard{0};
+  thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return shard;
+}
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+  std::sort(bounds_.begin(), bounds_.end());
+  if (bounds_.size() > kMaxBuckets) {
+    bounds_.resize(kMaxBuckets);
+  }
+}
+
+void Histogram::observe(double v) {
+  // Bucket lists are short, a linear scan beats a binary search here
+  size_t bucket = 0;
+  while (bucket < bounds_.size() && v > bounds_[bucket]) {
+    ++bucket;
+  }
+  Shard& shard = shards_[metricShard()];
+  shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::bucketCounts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1, 0);
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+      counts[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  return counts;
+}
+
+uint64_t Histogram::count() const {
+  uint64_t total = 0;
+  for (uint64_t c : bucketCounts()) {
+    total += c;
+  }
+  return total;
+}
+
+double Histogram::sum() const {
+  double total = 0.0;
+  for (const auto& shard : shards_) {
+    total += shard.sum.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// ============================================================================
+// MetricsRegistry
+// ============================================================================
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+  static MetricsRegistry instance;
+  return instance;
+}
+
+namespace {
+
+const char* typeName(MetricType type) {
+  switch (type) {
+    case MetricType::COUNTER: return "counter";
+    case MetricType::GAUGE: return "gauge";
+    case MetricType::HISTOGRAM: return "histogram";
+  }
+  return "untyped";
+}
+
+} // namespace
+
+MetricsRegistry::Entry& MetricsRegistry::entryFor(const std::string& name, const std::string& help,
+                                                  const std::string& labels, MetricType type) {
+  // Every series of a family passed this check, so its first one speaks for all
+  for (auto& entry : entries_) {
+    if (entry.name != name) continue;
+    if (entry.type != type) {
+      std::cerr << "[Metrics] " << name << " is a " << typeName(entry.type) << ", rejected as a "
+                << typeName(type) << " (not exported)" << std::endl;
+      Entry& detached = detached_.emplace_back();
+      detached.name = name;
+      detached.help = help;
+      detached.labels = labels;
+      detached.type = type;
+      return detached;
+    }
+    if (entry.help != help) {
+      std::cerr << "[Metrics] " << name << " registered with different HELP text \"" << help
+                << "\", keeping \"" << entry.help << "\"" << std::endl;
+    }
+    break;
+  }
+
+  for (auto& entry : entries_) {
+    if (entry.name == name && entry.labels == labels) {
+      return entry;
+    }
+  }
+  Entry& entry = entries_.emplace_back();
+  entry.name = name;
+  entry.help = help;
+  entry.labels = labels;
+  entry.type = type;
+  return entry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entryFor(name, help, labels, MetricType::COUNTER);
+  if (!entry.counter) {
+    entry.counter = std::make_unique<Counter>();
+  }
+  return *entry.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entryFor(name, help, labels, MetricType::GAUGE);
+  if (!entry.gauge) {
+    entry.gauge = std::make_unique<Gauge>();
+  }
+  return *entry.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entryFor(name, help, labels, MetricType::HISTOGRAM);
+  if (!entry.histogram) {
+    entry.histogram = std::make_unique<Histogram>(bounds);
+  }
+  return *entry.histogram;
+}
+
+std::vector<double> MetricsRegistry::latencyBucketsMs() {
+  return {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 5000};
+}
+
+std::vector<double> MetricsRegistry::durationBucketsUs() {
+  return {1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 100000};
+}
+
+namespace {
+
+void appendNumber(std::string& out, double value) {
+  char buf[32];
+  if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+    return;
+  }
+  std::snprintf(buf, sizeof(buf), "%.17g", value);
+  out += buf;
+}
+
+void appendSeries(std::string& out, const std::string& name, const std::string& labels,
+                  const std::string& extraLabel = "") {
+  out += name;
+  if (!labels.empty() || !extraLabel.empty()) {
+    out += '{';
+    out += labels;
+    if (!labels.empty() && !extraLabel.empty()) out += ',';
+    out += extraLabel;
+    out += '}';
+  }
+  out += ' ';
+}
+
+} // namespace
+
+std::string MetricsRegistry::renderPrometheus() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string out;
+  out.reserve(entries_.size() * 128);
+
+  // HELP/TYPE once per family; label variants follow their first occurrence
+  std::set<std::string> written;
+  for (const auto& first : entries_) {
+    if (!written.insert(first.name).second) continue;
+
+    out += "# HELP " + first.name + " " + first.help + "\n";
+    out += "# TYPE " + first.name + " " + typeName(first.type) + "\n";
+
+    for (const auto& entry : entries_) {
+      if (entry.name != first.name) continue;
+
+      switch (entry.type) {
+        case MetricType::COUNTER:
+          appendSeries(out, entry.name, entry.labels);
+          appendNumber(out, static_cast<double>(entry.counter->value()));
+          out += '\n';
+          break;
+        case MetricType::GAUGE:
+          appendSeries(out, entry.name, entry.labels);
+          appendNumber(out, entry.gauge->value());
+          out += '\n';
+          break;
+        case MetricType::HISTOGRAM: {
+          const auto& bounds = entry.histogram->bounds();
+          auto counts = entry.histogram->bucketCounts();
+          uint64_t cumulative = 0;
+          for (size_t i = 0; i < counts.size(); ++i) {
+            cumulative += counts[i];
+            std::string le = "le=\"";
+            if (i < bounds.size()) {
+              char buf[32];
+              std::snprintf(buf, sizeof(buf), "%g", bounds[i]);
+              le += buf;
+            } else {
+              le += "+Inf";
+            }
+            le += "\"";
+            appendSeries(out, entry.name + "_bucket", entry.labels, le);
+            appendNumber(out, static_cast<double>(cumulative));
+            out += '\n';
+          }
+          appendSeries(out, entry.name + "_sum", entry.labels);
+          appendNumber(out, entry.histogram->sum());
+          out += '\n';
+          appendSeries(out, entry.name + "_count", entry.labels);
+          appendNumber(out, static_cast<double>(cumulative));
+          out += '\n';
+          break;
+        }
+      }
+    }
+  }
+
+  return out;
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<MetricSample> samples;
+  samples.reserve(entries_.size());
+
+  for (const auto& entry : entries_) {
+    MetricSample sample;
+    sample.name = entry.name;
+    sample.labels = entry.labels;
+    sample.type = entry.type;
+    switch (entry.type) {
+      case MetricType::COUNTER:
+        sample.value = static_cast<double>(entry.counter->value());
+        break;
+      case MetricType::GAUGE:
+        sample.value = entry.gauge->value();
+        break;
+      case MetricType::HISTOGRAM: {
+        sample.bounds = entry.histogram->bounds();
+        auto counts = entry.histogram->bucketCounts();
+        uint64_t cumulative = 0;
+        for (uint64_t c : counts) {
+          cumulative += c;
+          sample.cumulative.push_back(cumulative);
+        }
+        sample.value = static_cast<double>(cumulative);
+        sample.sum = entry.histogram->sum();
+        break;
+      }
+    }
+    samples.push_back(std::move(sample));
+  }
+
+  return samples;
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Number of per-thread shards for counters and histograms. Threads are
+// assigned round-robin, so up to this many writers never share a cache line.
+constexpr size_t kMetricShards = 16;
+
+// Shard index for the calling thread
+size_t metricShard();
+
+// Monotonic counter. inc() is a relaxed add on the caller's shard.
+class Counter {
+public:
+  void inc(uint64_t n = 1) {
+    shards_[metricShard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+      total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, kMetricShards> shards_;
+};
+
+// Point-in-time value (queue depth, connected clients)
+class Gauge {
+public:
+  void set(double v) { value_.store(v, std::memory_order_relaxed); }
+  void inc(double n = 1.0) { value_.fetch_add(n, std::memory_order_relaxed); }
+  void dec(double n = 1.0) { value_.fetch_sub(n, std::memory_order_relaxed); }
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> value_{0.0};
+};
+
+// Fixed-bucket histogram. Bucket bounds are upper bounds (le) in ascending
+// order; values above the last bound land in +Inf.
+class Histogram {
+public:
+  static constexpr size_t kMaxBuckets = 16;
+
+  explicit Histogram(std::vector<double> bounds);
+
+  void observe(double v);
+
+  const std::vector<double>& bounds() const { return bounds_; }
+
+  // Per-bucket counts (not cumulative), last entry is +Inf
+  std::vector<uint64_t> bucketCounts() const;
+  uint64_t count() const;
+  double sum() const;
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kMaxBuckets + 1> buckets{};
+    std::atomic<double> sum{0.0};
+  };
+
+  std::vector<double> bounds_;
+  std::array<Shard, kMetricShards> shards_;
+};
+
+// Times a scope into a histogram in milliseconds
+class ScopedTimer {
+public:
+  explicit ScopedTimer(Histogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    histogram_.observe(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start_).count());
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Histogram& histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+enum class MetricType { COUNTER, GAUGE, HISTOGRAM };
+
+// Read-only view of one metric for non-Prometheus consumers (getMetrics)
+struct MetricSample {
+  std::string name;
+  std::string labels;  // Prometheus label set without braces, e.g. table="ticks"
+  MetricType type;
+  double value = 0.0;                 // Counter/gauge value, histogram count
+  double sum = 0.0;                   // Histogram only
+  std::vector<double> bounds;         // Histogram only
+  std::vector<uint64_t> cumulative;   // Histogram only, one per bound plus +Inf
+};
+
+// Process-wide registry.
+//
+// Registration takes a lock and returns a reference that stays valid for the
+// life of the process; hot paths look a metric up once (e.g. into a
+// function-local static) and then only touch its atomics.
+class MetricsRegistry {
+public:
+  static MetricsRegistry& getInstance();
+
+  Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+  Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+  Histogram& histogram(const std::string& name, const std::string& help,
+                       const std::vector<double>& bounds, const std::string& labels = "");
+
+  // Prometheus text exposition format (version 0.0.4)
+  std::string renderPrometheus() const;
+
+  std::vector<MetricSample> snapshot() const;
+
+  // Common bucket layouts
+  static std::vector<double> latencyBucketsMs();   // 0.05 ms .. 5 s
+  static std::vector<double> durationBucketsUs();  // 1 us .. 100 ms
+
+private:
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  struct Entry {
+    std::string name;
+    std::string help;
+    std::string labels;
+    MetricType type;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+  };
+
+  // The series of `name` with `labels`, created if new. A family takes its
+  // type and HELP from its first registration: a HELP mismatch is logged, a
+  // type mismatch is logged and gets a detached series that is never exported.
+  Entry& entryFor(const std::string& name, const std::string& help, const std::string& labels,
+                  MetricType type);
+
+  mutable std::mutex mutex_;
+  std::deque<Entry> entries_;   // Registration order, grouped by name on output
+  std::deque<Entry> detached_;  // Rejected registrations, kept alive for their callers
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,131 @@
+#include "OverloadController.h"
+#include "Metrics.h"
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+struct OverloadMetrics {
+  Gauge& tier;
+  Gauge& lagMs;
+  Histogram& lagHistMs;
+  Counter& escalations;
+  Counter& recoveries;
+  Histogram& overloadMs;
+  std::array<Counter*, static_cast<size_t>(OverloadController::Shed::COUNT)> shed;
+};
+
+OverloadMetrics& overloadMetrics() {
+  auto& registry = MetricsRegistry::getInstance();
+  static OverloadMetrics metrics{
+    registry.gauge("glora_overload_tier", "Load shedding tier (0 normal, 1 degraded, 2 conflated, 3 deferred)"),
+    registry.gauge("glora_pipeline_lag_ms", "Queueing delay of the last tick before processing"),
+    registry.histogram("glora_pipeline_lag_hist_ms", "Queueing delay per tick before processing",
+                       MetricsRegistry::latencyBucketsMs()),
+    registry.counter("glora_overload_transitions_total", "Load shedding tier changes", "direction=\"up\""),
+    registry.counter("glora_overload_transitions_total", "Load shedding tier changes", "direction=\"down\""),
+    registry.histogram("glora_overload_duration_ms", "Time from leaving to returning to the normal tier",
+                       MetricsRegistry::latencyBucketsMs()),
+    {
+      // DOM frames skipped, trade and candle broadcasts conflated, writes batched
+      &registry.counter("glora_overload_shed_total", "Work shed under load", "kind=\"dom_frame\""),
+      &registry.counter("glora_overload_shed_total", "Work shed under load", "kind=\"tick_broadcast\""),
+      &registry.counter("glora_overload_shed_total", "Work shed under load", "kind=\"candle_broadcast\""),
+      &registry.counter("glora_overload_shed_total", "Work shed under load", "kind=\"deferred_write\""),
+    },
+  };
+  return metrics;
+}
+
+} // namespace
+
+OverloadController& OverloadController::getInstance() {
+  static OverloadController instance;
+  return instance;
+}
+
+OverloadController::OverloadController() {
+  overloadMetrics().tier.set(0);
+}
+
+const char* OverloadController::tierName(Tier tier) {
+  switch (tier) {
+    case Tier::NORMAL: return "normal";
+    case Tier::DEGRADED: return "degraded";
+    case Tier::CONFLATED: return "conflated";
+    case Tier::DEFERRED: return "deferred";
+    default: return "unknown";
+  }
+}
+
+void OverloadController::observe(double lagMs, size_t queueDepth) {
+  auto& metrics = overloadMetrics();
+  metrics.lagMs.set(lagMs);
+  if (queueDepth > 0 || lagMs > 0.0) {
+    metrics.lagHistMs.observe(lagMs);
+  }
+
+  auto now = Clock::now();
+  Tier current = tier();
+
+  // Highest tier whose entry threshold is crossed
+  Tier target = Tier::NORMAL;
+  for (int t = static_cast<int>(Tier::COUNT) - 1; t > 0; --t) {
+    const auto& limits = kThresholds[t];
+    if (lagMs >= limits.enterLagMs || queueDepth >= limits.enterQueue) {
+      target = static_cast<Tier>(t);
+      break;
+    }
+  }
+
+  if (target > current) {
+    setTier(target, now, lagMs, queueDepth);
+    below_ = false;
+    return;
+  }
+  if (current == Tier::NORMAL) return;
+
+  const auto& limits = kThresholds[static_cast<size_t>(current)];
+  if (lagMs >= limits.exitLagMs || queueDepth >= limits.exitQueue) {
+    below_ = false;
+    return;
+  }
+  if (!below_) {
+    below_ = true;
+    belowSince_ = now;
+  } else if (now - belowSince_ >= kRecoverHold) {
+    // Step down one tier and hold again before the next
+    setTier(static_cast<Tier>(static_cast<int>(current) - 1), now, lagMs, queueDepth);
+    belowSince_ = now;
+  }
+}
+
+void OverloadController::setTier(Tier tier, Clock::time_point now, double lagMs, size_t queueDepth) {
+  auto& metrics = overloadMetrics();
+  Tier previous = tier_.exchange(tier, std::memory_order_relaxed);
+  metrics.tier.set(static_cast<double>(tier));
+
+  if (tier > previous) {
+    metrics.escalations.inc();
+    if (previous == Tier::NORMAL) {
+      overloadStart_ = now;
+    }
+  } else {
+    metrics.recoveries.inc();
+    if (tier == Tier::NORMAL) {
+      metrics.overloadMs.observe(std::chrono::duration<double, std::milli>(now - overloadStart_).count());
+    }
+  }
+
+  std::cout << "[Overload] " << tierName(previous) << " -> " << tierName(tier) << " (lag " << lagMs
+            << " ms, queue " << queueDepth << ")" << std::endl;
+}
+
+void OverloadController::countShed(Shed kind, uint64_t n) {
+  overloadMetrics().shed[static_cast<size_t>(kind)]->inc(n);
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace glora {
+namespace core {
+
+// Tiered load shedding for the live pipeline.
+//
+// The processing thread reports, for every tick it dequeues, how long it
+// waited in the queue (local clock, so feed latency and exchange clock skew
+// don't count) and how many ticks are still queued. The controller
+// turns that into a tier; each tier sheds everything the one below does:
+//
+//   DEGRADED   Smart DOM streams publish at 1/kDegradedPublishScale the rate
+//   CONFLATED  Trade and candle broadcasts go out at most every kConflateInterval,
+//              the newest trade of each interval (a candle's final state is
+//              always sent when it closes)
+//   DEFERRED   Tick and in-progress candle writes are batched; closed
+//              candles are still written when they close
+//
+// Candle aggregation itself is never shed. A tier is entered as soon as its
+// threshold is crossed and left one step at a time, once lag and queue have
+// stayed under its exit threshold for kRecoverHold.
+class OverloadController {
+public:
+  enum class Tier { NORMAL = 0, DEGRADED, CONFLATED, DEFERRED, COUNT };
+
+  // Work dropped or postponed because of the tier, for metrics
+  enum class Shed { DOM_FRAME = 0, TICK_BROADCAST, CANDLE_BROADCAST, DEFERRED_WRITE, COUNT };
+
+  struct Thresholds {
+    double enterLagMs;
+    size_t enterQueue;
+    double exitLagMs;
+    size_t exitQueue;
+  };
+
+  static constexpr int kDegradedPublishScale = 4;
+  static constexpr auto kConflateInterval = std::chrono::milliseconds(100);
+  static constexpr auto kRecoverHold = std::chrono::milliseconds(2000);
+
+  static OverloadController& getInstance();
+
+  // Called by the processing thread (a single thread) per dequeued tick, and
+  // with zeros when it is idle so the tier can recover without traffic
+  void observe(double lagMs, size_t queueDepth);
+
+  Tier tier() const { return tier_.load(std::memory_order_relaxed); }
+  bool atLeast(Tier tier) const { return this->tier() >= tier; }
+
+  // Multiplier for periodic publish intervals under the current tier
+  int publishIntervalScale() const { return atLeast(Tier::DEGRADED) ? kDegradedPublishScale : 1; }
+
+  void countShed(Shed kind, uint64_t n = 1);
+
+  static const char* tierName(Tier tier);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  OverloadController();
+
+  void setTier(Tier tier, Clock::time_point now, double lagMs, size_t queueDepth);
+
+  // Indexed by tier; NORMAL's entry is unused
+  static constexpr std::array<Thresholds, static_cast<size_t>(Tier::COUNT)> kThresholds{{
+    {0.0, 0, 0.0, 0},
+    {250.0, 2'000, 100.0, 500},
+    {1'000.0, 10'000, 400.0, 2'000},
+    {3'000.0, 50'000, 1'000.0, 5'000},
+  }};
+
+  std::atomic<Tier> tier_{Tier::NORMAL};
+
+  // Processing thread only
+  Clock::time_point belowSince_{};
+  bool below_ = false;
+  Clock::time_point overloadStart_{};
+};
+
+} // namespace core
+} // namespace glora
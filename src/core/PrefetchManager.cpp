@@ -0,0 +1,214 @@
+#include "PrefetchManager.h"
+#include "Metrics.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+struct PrefetchMetrics {
+  Counter& warmSwitches;
+  Counter& coldSwitches;
+  Counter& evictions;
+  Gauge& warmSymbols;
+  Gauge& residentBytes;
+};
+
+PrefetchMetrics& prefetchMetrics() {
+  auto& registry = MetricsRegistry::getInstance();
+  static PrefetchMetrics metrics{
+    registry.counter("glora_prefetch_switches_total", "Symbol switches by whether the symbol was warm",
+                     "result=\"warm\""),
+    registry.counter("glora_prefetch_switches_total", "Symbol switches by whether the symbol was warm",
+                     "result=\"cold\""),
+    registry.counter("glora_prefetch_evictions_total", "Warm symbols released by the prefetcher"),
+    registry.gauge("glora_prefetch_warm_symbols", "Symbols kept warm by the prefetcher"),
+    registry.gauge("glora_prefetch_resident_bytes", "Approximate memory held by warm symbols"),
+  };
+  return metrics;
+}
+
+} // namespace
+
+PrefetchManager::PrefetchManager(std::shared_ptr<DataManager> dataManager,
+                                 std::shared_ptr<network::BinanceClient> client, int days, size_t memoryBudget)
+    : dataManager_(std::move(dataManager)), client_(std::move(client)), days_(days), memoryBudget_(memoryBudget) {}
+
+PrefetchManager::~PrefetchManager() {
+  stop();
+}
+
+void PrefetchManager::start() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+  }
+
+  thread_ = std::thread([this]() {
+    applyThreadRole(settings::ThreadRole::BACKGROUND, "glora-prefetch");
+    run();
+  });
+}
+
+void PrefetchManager::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool PrefetchManager::recordUse(const std::string& symbol) {
+  bool warm = dataManager_ && dataManager_->isWarm(symbol);
+  auto& metrics = prefetchMetrics();
+  (warm ? metrics.warmSwitches : metrics.coldSwitches).inc();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    auto& usage = usage_[symbol];
+    usage.uses = decayedUses(usage, now) + 1.0;
+    usage.at = now;
+    active_ = symbol;
+    dirty_ = true;
+  }
+  cv_.notify_all();
+  return warm;
+}
+
+void PrefetchManager::setWatchlist(const std::vector<std::string>& symbols) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    watchlist_ = std::set<std::string>(symbols.begin(), symbols.end());
+    dirty_ = true;
+  }
+  cv_.notify_all();
+}
+
+std::vector<std::string> PrefetchManager::warmSymbols() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return warm_;
+}
+
+double PrefetchManager::decayedUses(const Usage& usage, Clock::time_point now) const {
+  if (usage.uses == 0.0) return 0.0;
+  double halfLives = std::chrono::duration<double>(now - usage.at).count() /
+                     std::chrono::duration<double>(kUseHalfLife).count();
+  return usage.uses * std::exp2(-halfLives);
+}
+
+std::vector<std::string> PrefetchManager::rank() const {
+  auto now = Clock::now();
+  std::unordered_map<std::string, double> scores;
+  for (const auto& [symbol, usage] : usage_) {
+    scores[symbol] += decayedUses(usage, now);
+  }
+  for (const auto& symbol : watchlist_) {
+    scores[symbol] += kWatchlistUses;
+  }
+
+  std::vector<std::pair<double, std::string>> ranked;
+  ranked.reserve(scores.size());
+  for (const auto& [symbol, score] : scores) {
+    ranked.emplace_back(symbol == active_ ? INFINITY : score, symbol);
+  }
+  std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+
+  std::vector<std::string> symbols;
+  symbols.reserve(ranked.size());
+  for (auto& entry : ranked) {
+    symbols.push_back(std::move(entry.second));
+  }
+  return symbols;
+}
+
+void PrefetchManager::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    lock.unlock();
+    rebalance();
+    lock.lock();
+    cv_.wait_for(lock, kRebalanceInterval, [this]() { return !running_ || dirty_; });
+  }
+}
+
+void PrefetchManager::rebalance() {
+  if (!dataManager_) return;
+
+  std::vector<std::string> ranked;
+  std::vector<std::string> previous;
+  std::string active;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = false;
+    ranked = rank();
+    previous = warm_;
+    active = active_;
+  }
+
+  // Best ranked first until the symbol count or the memory budget runs out.
+  // The active symbol is loaded by the subscribe path itself.
+  std::vector<std::string> keep;
+  size_t bytes = 0;
+  for (const auto& symbol : ranked) {
+    if (keep.size() >= kMaxWarmSymbols) break;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_) return;
+    }
+    if (symbol != active && !dataManager_->isWarm(symbol) && !dataManager_->warmSymbol(symbol, days_)) {
+      continue;
+    }
+    size_t symbolBytes = dataManager_->residentBytes(symbol);
+    if (symbol != active && bytes + symbolBytes > memoryBudget_) break;
+    keep.push_back(symbol);
+    bytes += symbolBytes;
+  }
+
+  // Streams first, so evicted symbols stop receiving ticks before release
+  if (client_) {
+    std::vector<std::string> background;
+    for (const auto& symbol : keep) {
+      if (symbol != active) background.push_back(symbol);
+    }
+    client_->setBackgroundAggTrades("prefetch", background, [this](const std::string& symbol, const Tick& tick) {
+      {
+        // A symbol that just became active is already on the main socket
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (symbol == active_) return;
+      }
+      dataManager_->addBackgroundTick(symbol, tick);
+    });
+  }
+
+  // Anything used or loaded before that no longer made the cut
+  auto& metrics = prefetchMetrics();
+  std::set<std::string> kept(keep.begin(), keep.end());
+  std::set<std::string> candidates(previous.begin(), previous.end());
+  candidates.insert(ranked.begin(), ranked.end());
+  for (const auto& symbol : candidates) {
+    if (kept.count(symbol) || symbol == active || !dataManager_->isWarm(symbol)) continue;
+    dataManager_->evictSymbol(symbol);
+    metrics.evictions.inc();
+  }
+
+  metrics.warmSymbols.set(static_cast<double>(keep.size()));
+  metrics.residentBytes.set(static_cast<double>(bytes));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    warm_ = std::move(keep);
+  }
+}
+
+} // namespace core
+} // namespace glora
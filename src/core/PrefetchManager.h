@@ -0,0 +1,89 @@
+#pragma once
+
+#include "DataManager.h"
+#include "../network/BinanceClient.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Keeps the symbols a trader flips between warm, so a switch renders from
+// memory instead of the database or REST.
+//
+// Every switch to a symbol counts as a use; uses decay with kUseHalfLife, so
+// the ranking follows what is traded today. Watchlisted symbols count as
+// kWatchlistUses extra uses. In rank order the manager loads up to
+// kMaxWarmSymbols symbols into the DataManager (candles plus the recent ticks
+// behind footprints) until their resident bytes reach the memory budget, and
+// evicts warm symbols that fell out. Warm symbols other than the active one
+// have their aggTrades on the client's combined background stream so their
+// candles stay current.
+//
+// Loading runs on its own thread at background REST priority; recordUse and
+// setWatchlist only re-rank and wake it.
+class PrefetchManager {
+public:
+  static constexpr size_t kMaxWarmSymbols = 16;
+  static constexpr size_t kDefaultMemoryBudget = 512ULL * 1024 * 1024;
+  static constexpr auto kUseHalfLife = std::chrono::hours(4);
+  static constexpr double kWatchlistUses = 1.0;
+  static constexpr auto kRebalanceInterval = std::chrono::minutes(5);
+
+  PrefetchManager(std::shared_ptr<DataManager> dataManager, std::shared_ptr<network::BinanceClient> client,
+                  int days, size_t memoryBudget = kDefaultMemoryBudget);
+  ~PrefetchManager();
+
+  void start();
+  void stop();
+
+  // The user switched to `symbol`; it becomes the active symbol. Returns
+  // whether it was already warm.
+  bool recordUse(const std::string& symbol);
+
+  // Symbols to keep warm regardless of recent use (within the budget)
+  void setWatchlist(const std::vector<std::string>& symbols);
+
+  // Warm symbols, best ranked first
+  std::vector<std::string> warmSymbols() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Usage {
+    double uses = 0.0;  // Decayed to `at`
+    Clock::time_point at;
+  };
+
+  double decayedUses(const Usage& usage, Clock::time_point now) const;
+  std::vector<std::string> rank() const;
+  void run();
+  void rebalance();
+
+  std::shared_ptr<DataManager> dataManager_;
+  std::shared_ptr<network::BinanceClient> client_;
+  int days_;
+  size_t memoryBudget_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Usage> usage_;
+  std::set<std::string> watchlist_;
+  std::string active_;
+  std::vector<std::string> warm_;  // Loaded by the manager, rank order
+  bool dirty_ = false;
+
+  std::thread thread_;
+  std::condition_variable cv_;
+  bool running_ = false;
+};
+
+} // namespace core
+} // namespace glora
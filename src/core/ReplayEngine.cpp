@@ -0,0 +1,452 @@
+#include "ReplayEngine.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+void ReplayEngine::BarState::apply(const Tick& tick) {
+  if (empty) {
+    open = high = low = close = tick.price;
+    empty = false;
+  } else {
+    high = std::max(high, tick.price);
+    low = std::min(low, tick.price);
+    close = tick.price;
+  }
+  volume += tick.quantity;
+}
+
+Candle ReplayEngine::BarState::toCandle(uint64_t intervalMs) const {
+  Candle candle;
+  candle.start_time_ms = start;
+  candle.end_time_ms = start + intervalMs;
+  candle.open = open;
+  candle.high = high;
+  candle.low = low;
+  candle.close = close;
+  candle.volume = volume;
+  return candle;
+}
+
+ReplayEngine::ReplayEngine(std::shared_ptr<database::Database> database) : database_(std::move(database)) {}
+
+ReplayEngine::~ReplayEngine() {
+  stop();
+}
+
+bool ReplayEngine::start(const std::string& symbol, uint64_t startTime, uint64_t endTime, uint64_t intervalMs,
+                         double speed, Callbacks callbacks) {
+  if (!database_ || symbol.empty() || endTime <= startTime || intervalMs == 0) return false;
+  if (endTime - startTime > kMaxSessionMs) {
+    std::cerr << "[Replay] Session longer than " << kMaxSessionMs / 3600000 << "h rejected" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> sessionLock(sessionMutex_);
+  joinPlayback();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_ = std::move(callbacks);
+  symbol_ = symbol;
+  startTime_ = startTime;
+  endTime_ = endTime;
+  intervalMs_ = intervalMs;
+  running_ = true;
+  ready_ = false;
+  paused_ = true;
+  finished_ = false;
+  speed_ = std::clamp(speed, kMinSpeed, kMaxSpeed);
+  stepTicks_ = 0;
+  pendingSeek_.reset();
+  currentTime_ = startTime;
+  ticksPlayed_ = 0;
+  stateChanged_ = false;
+  thread_ = std::thread(&ReplayEngine::run, this);
+  return true;
+}
+
+void ReplayEngine::stop() {
+  std::lock_guard<std::mutex> sessionLock(sessionMutex_);
+  joinPlayback();
+}
+
+void ReplayEngine::joinPlayback() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ && !thread_.joinable()) return;
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ReplayEngine::play() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ || finished_) return;
+    paused_ = false;
+    stepTicks_ = 0;
+    reanchor(Clock::now());
+    stateChanged_ = true;
+  }
+  cv_.notify_all();
+}
+
+void ReplayEngine::pause() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ || paused_) return;
+    // Freeze where the clock is, even in a gap between trades
+    currentTime_ = std::max(currentTime_, std::min(clockTime(Clock::now()), endTime_));
+    paused_ = true;
+    stateChanged_ = true;
+  }
+  cv_.notify_all();
+}
+
+void ReplayEngine::setSpeed(double speed) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    if (!paused_) {
+      anchorTime_ = static_cast<double>(clockTime(now));
+      anchorWall_ = now;
+    }
+    speed_ = std::clamp(speed, kMinSpeed, kMaxSpeed);
+    stateChanged_ = true;
+  }
+  cv_.notify_all();
+}
+
+void ReplayEngine::step(size_t count) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    if (!paused_) {
+      currentTime_ = std::max(currentTime_, std::min(clockTime(Clock::now()), endTime_));
+      paused_ = true;
+    }
+    stepTicks_ += count;
+  }
+  cv_.notify_all();
+}
+
+void ReplayEngine::seek(uint64_t timeMs) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    pendingSeek_ = std::clamp(timeMs, startTime_, endTime_);
+    stepTicks_ = 0;
+  }
+  cv_.notify_all();
+}
+
+ReplayEngine::State ReplayEngine::state() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  State state;
+  state.symbol = symbol_;
+  state.startTime = startTime_;
+  state.endTime = endTime_;
+  state.intervalMs = intervalMs_;
+  state.speed = speed_;
+  state.active = running_;
+  state.ready = ready_;
+  state.paused = paused_;
+  state.finished = finished_;
+  state.ticksPlayed = ticksPlayed_;
+  state.checkpoints = ready_ ? checkpoints_.size() : 0;
+  state.time = currentTime_;
+  if (ready_ && !paused_ && !finished_) {
+    state.time = std::max(currentTime_, std::min(clockTime(Clock::now()), endTime_));
+  }
+  return state;
+}
+
+uint64_t ReplayEngine::clockTime(Clock::time_point now) const {
+  double elapsedMs = std::chrono::duration<double, std::milli>(now - anchorWall_).count();
+  return static_cast<uint64_t>(anchorTime_ + elapsedMs * speed_);
+}
+
+void ReplayEngine::reanchor(Clock::time_point now) {
+  anchorTime_ = static_cast<double>(currentTime_);
+  anchorWall_ = now;
+}
+
+void ReplayEngine::advanceBar(BarState& bar, const Tick& tick) const {
+  uint64_t barStart = tick.timestamp_ms / intervalMs_ * intervalMs_;
+  if (bar.empty || bar.start != barStart) {
+    bar = BarState{};
+    bar.start = barStart;
+  }
+  bar.apply(tick);
+}
+
+void ReplayEngine::advancePlayback(const Tick& tick, bool notify) {
+  uint64_t barStart = tick.timestamp_ms / intervalMs_ * intervalMs_;
+  if (!bar_.empty && bar_.start != barStart) {
+    if (notify && callbacks_.onCandle) {
+      callbacks_.onCandle(barCandle(), true);
+    }
+    footprint_.clear();
+  }
+  advanceBar(bar_, tick);
+
+  PriceNode& node = footprint_[tick.price];
+  if (tick.is_buyer_maker) {
+    node.bid_volume += tick.quantity;
+  } else {
+    node.ask_volume += tick.quantity;
+  }
+}
+
+Candle ReplayEngine::barCandle() const {
+  Candle candle = bar_.toCandle(intervalMs_);
+  candle.footprint_profile = footprint_;
+  return candle;
+}
+
+void ReplayEngine::rebuildBar(const Checkpoint& checkpoint) {
+  bar_ = BarState{};
+  footprint_.clear();
+  if (checkpoint.bar.empty) return;
+
+  // The checkpoint's bar only counts ticks from the session start
+  database::TickCursor cursor{std::max(checkpoint.bar.start, startTime_)};
+  const database::TickCursor& stop = checkpoint.cursor;
+  std::vector<Tick> page;
+  while (true) {
+    page.clear();
+    if (database_->getTickPage(symbol_, cursor, stop.timestamp_ms, kPageTicks, page) == 0) return;
+    for (const Tick& tick : page) {
+      if (tick.timestamp_ms == stop.timestamp_ms && tick.trade_id >= stop.key) return;
+      advancePlayback(tick, false);
+    }
+  }
+}
+
+bool ReplayEngine::buildIndex() {
+  auto buildStart = Clock::now();
+  checkpoints_.clear();
+  secondIndex_.clear();
+
+  // The session start is always a checkpoint, so every seek has one at or
+  // before it
+  Checkpoint first;
+  first.time = startTime_;
+  first.cursor = database::TickCursor{startTime_};
+  checkpoints_.push_back(first);
+
+  database::TickCursor cursor{startTime_};
+  std::vector<Tick> page;
+  page.reserve(kPageTicks);
+  BarState bar;
+  uint64_t tickNumber = 0;
+  size_t sinceCheckpoint = 0;
+  uint64_t lastCheckpointTime = startTime_;
+
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_) return false;
+    }
+    page.clear();
+    if (database_->getTickPage(symbol_, cursor, endTime_, kPageTicks, page) == 0) break;
+
+    for (const Tick& tick : page) {
+      if (sinceCheckpoint >= kCheckpointTicks || tick.timestamp_ms >= lastCheckpointTime + kCheckpointMs) {
+        Checkpoint checkpoint;
+        checkpoint.time = tick.timestamp_ms;
+        checkpoint.cursor = database::TickCursor{tick.timestamp_ms, tick.trade_id};
+        checkpoint.tickNumber = tickNumber;
+        checkpoint.bar = bar;
+        checkpoints_.push_back(checkpoint);
+        sinceCheckpoint = 0;
+        lastCheckpointTime = tick.timestamp_ms;
+      }
+      advanceBar(bar, tick);
+      ++tickNumber;
+      ++sinceCheckpoint;
+    }
+  }
+
+  // Second s -> last checkpoint strictly before the start of that second
+  size_t seconds = static_cast<size_t>((endTime_ - startTime_) / 1000) + 1;
+  secondIndex_.resize(seconds);
+  uint32_t last = 0;
+  for (size_t s = 0; s < seconds; ++s) {
+    uint64_t secondStart = startTime_ + s * 1000;
+    while (last + 1 < checkpoints_.size() && checkpoints_[last + 1].time < secondStart) {
+      ++last;
+    }
+    secondIndex_[s] = last;
+  }
+
+  std::cout << "[Replay] Indexed " << tickNumber << " ticks of " << symbol_ << " into "
+            << checkpoints_.size() << " checkpoints in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - buildStart).count()
+            << " ms" << std::endl;
+  return true;
+}
+
+const ReplayEngine::Checkpoint& ReplayEngine::checkpointFor(uint64_t timeMs) const {
+  size_t second = std::min(static_cast<size_t>((timeMs - startTime_) / 1000), secondIndex_.size() - 1);
+  size_t index = secondIndex_[second];
+  // At most the checkpoints inside this one second
+  while (index + 1 < checkpoints_.size() && checkpoints_[index + 1].time < timeMs) {
+    ++index;
+  }
+  return checkpoints_[index];
+}
+
+const Tick* ReplayEngine::peekTick() {
+  if (pagePos_ >= page_.size()) {
+    page_.clear();
+    pagePos_ = 0;
+    if (database_->getTickPage(symbol_, cursor_, endTime_, kPageTicks, page_) == 0) {
+      return nullptr;
+    }
+  }
+  return &page_[pagePos_];
+}
+
+void ReplayEngine::seekTo(uint64_t timeMs) {
+  const Checkpoint& checkpoint = checkpointFor(timeMs);
+  cursor_ = checkpoint.cursor;
+  page_.clear();
+  pagePos_ = 0;
+  rebuildBar(checkpoint);
+  uint64_t played = checkpoint.tickNumber;
+
+  // Replay the few ticks between the checkpoint and the target silently
+  while (const Tick* tick = peekTick()) {
+    if (tick->timestamp_ms >= timeMs) break;
+    advancePlayback(*tick, false);
+    ++pagePos_;
+    ++played;
+  }
+
+  if (callbacks_.onReset) {
+    callbacks_.onReset();
+  }
+  if (!bar_.empty && callbacks_.onCandle) {
+    callbacks_.onCandle(barCandle(), false);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    currentTime_ = timeMs;
+    ticksPlayed_ = played;
+    finished_ = false;
+    reanchor(Clock::now());
+  }
+  publishState();
+}
+
+void ReplayEngine::emit(const Tick& stored) {
+  Tick tick = stored;
+  if (tick.trade_id < 0) {
+    tick.trade_id = 0;  // Synthetic storage key, not an exchange ID
+  }
+
+  advancePlayback(tick, true);
+  if (callbacks_.onTick) {
+    callbacks_.onTick(tick);
+  }
+
+  auto now = Clock::now();
+  if (callbacks_.onCandle && now - lastCandleSent_ >= kCandleInterval) {
+    callbacks_.onCandle(barCandle(), false);
+    lastCandleSent_ = now;
+  }
+}
+
+void ReplayEngine::publishState() {
+  lastStateSent_ = Clock::now();
+  if (callbacks_.onState) {
+    callbacks_.onState(state());
+  }
+}
+
+void ReplayEngine::run() {
+  applyThreadRole(settings::ThreadRole::BACKGROUND, "glora-replay");
+
+  bool indexed = buildIndex();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    ready_ = indexed;
+  }
+  seekTo(startTime_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    if (pendingSeek_) {
+      uint64_t target = *pendingSeek_;
+      pendingSeek_.reset();
+      lock.unlock();
+      seekTo(target);
+      lock.lock();
+      continue;
+    }
+
+    auto now = Clock::now();
+    if (stateChanged_ || (!paused_ && now - lastStateSent_ >= kStateInterval)) {
+      stateChanged_ = false;
+      lock.unlock();
+      publishState();
+      lock.lock();
+      continue;
+    }
+
+    if ((paused_ || finished_) && stepTicks_ == 0) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    lock.unlock();
+    const Tick* tick = peekTick();
+    lock.lock();
+
+    if (!tick) {
+      // End of the session: hold at the end until a seek
+      finished_ = true;
+      paused_ = true;
+      stepTicks_ = 0;
+      currentTime_ = endTime_;
+      stateChanged_ = true;
+      continue;
+    }
+
+    if (stepTicks_ > 0) {
+      --stepTicks_;
+    } else {
+      now = Clock::now();
+      if (tick->timestamp_ms > clockTime(now)) {
+        // Sleep until the clock reaches the tick; controls wake us earlier
+        auto due = anchorWall_ + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>((tick->timestamp_ms - anchorTime_) / speed_));
+        cv_.wait_until(lock, std::min(due, now + kMaxWait));
+        continue;
+      }
+    }
+
+    Tick next = *tick;
+    ++pagePos_;
+    currentTime_ = std::max(currentTime_, next.timestamp_ms);
+    ++ticksPlayed_;
+    if (paused_) {
+      stateChanged_ = stepTicks_ == 0;
+    }
+
+    lock.unlock();
+    emit(next);
+    lock.lock();
+  }
+}
+
+} // namespace core
+} // namespace glora
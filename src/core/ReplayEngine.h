@@ -0,0 +1,177 @@
+#pragma once
+
+#include "DataModels.h"
+#include "../database/Database.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Plays a stored session back tick by tick on a replay clock.
+//
+// Starting a session scans its ticks once to build a sparse seek index: a
+// checkpoint every kCheckpointTicks ticks or kCheckpointMs of market time,
+// each holding the table position and the OHLCV of the bar in progress.
+// A per-second table maps any timestamp to its checkpoint in O(1), so a seek
+// reads at most one checkpoint's worth of ticks instead of reloading the
+// session, plus the start of the bar in progress to rebuild its footprint
+// (checkpoints don't carry one). Ticks are paged from the database as
+// playback advances.
+//
+// Playback runs on its own thread at 0.1x to 1000x market speed, with pause,
+// single-stepping and seeking. Controls may be called from any thread; they
+// are applied by the playback thread, which is also the only thread that
+// invokes the callbacks.
+class ReplayEngine {
+public:
+  static constexpr double kMinSpeed = 0.1;
+  static constexpr double kMaxSpeed = 1000.0;
+  static constexpr size_t kCheckpointTicks = 10'000;
+  static constexpr uint64_t kCheckpointMs = 1000;
+  static constexpr uint64_t kMaxSessionMs = 7ULL * 24 * 60 * 60 * 1000;
+
+  struct State {
+    std::string symbol;
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+    uint64_t intervalMs = 0;
+    uint64_t time = 0;          // Replay clock
+    double speed = 1.0;
+    bool active = false;
+    bool ready = false;         // Seek index built
+    bool paused = true;
+    bool finished = false;
+    uint64_t ticksPlayed = 0;
+    size_t checkpoints = 0;
+  };
+
+  struct Callbacks {
+    std::function<void(const Tick&)> onTick;
+    // Bar in progress with its footprint up to the replay time. `closed` is
+    // set once when the clock leaves the bar.
+    std::function<void(const Candle&, bool closed)> onCandle;
+    std::function<void(const State&)> onState;
+    // Playback jumped; state derived from the tick stream should be cleared
+    std::function<void()> onReset;
+  };
+
+  explicit ReplayEngine(std::shared_ptr<database::Database> database);
+  ~ReplayEngine();
+
+  // Replace any running session. The old playback thread is joined before
+  // `callbacks` are installed, so it never sees the new session's callbacks.
+  // Playback starts paused at startTime once the seek index is built.
+  bool start(const std::string& symbol, uint64_t startTime, uint64_t endTime, uint64_t intervalMs,
+             double speed, Callbacks callbacks);
+  void stop();
+
+  void play();
+  void pause();
+  void setSpeed(double speed);
+  // Emit the next `count` ticks while paused
+  void step(size_t count = 1);
+  void seek(uint64_t timeMs);
+
+  State state() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // OHLCV of the bar in progress
+  struct BarState {
+    uint64_t start = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    bool empty = true;
+
+    void apply(const Tick& tick);
+    Candle toCandle(uint64_t intervalMs) const;
+  };
+
+  struct Checkpoint {
+    uint64_t time = 0;
+    database::TickCursor cursor;  // Position of the first tick at or after `time`
+    uint64_t tickNumber = 0;
+    BarState bar;                 // Bar state before that tick
+  };
+
+  static constexpr size_t kPageTicks = 20'000;
+  static constexpr auto kCandleInterval = std::chrono::milliseconds(50);
+  static constexpr auto kStateInterval = std::chrono::milliseconds(250);
+  static constexpr auto kMaxWait = std::chrono::milliseconds(100);
+
+  void run();
+  void joinPlayback();  // sessionMutex_ held
+  bool buildIndex();
+  const Checkpoint& checkpointFor(uint64_t timeMs) const;
+  void seekTo(uint64_t timeMs);
+  const Tick* peekTick();  // Next tick, paging it in; nullptr at the session end
+  void advanceBar(BarState& bar, const Tick& tick) const;
+  // Rebuild bar_ and footprint_ from the bar start up to `checkpoint`
+  void rebuildBar(const Checkpoint& checkpoint);
+  // bar_ and footprint_ take the tick; with `notify` a bar it closes is sent
+  void advancePlayback(const Tick& tick, bool notify);
+  Candle barCandle() const;
+  void emit(const Tick& tick);
+  void publishState();
+
+  // Replay time now, from the clock anchor; mutex_ held
+  uint64_t clockTime(Clock::time_point now) const;
+  void reanchor(Clock::time_point now);
+
+  std::shared_ptr<database::Database> database_;
+  Callbacks callbacks_;  // Set by start() while no playback thread runs
+
+  // Session (fixed while the playback thread runs)
+  std::string symbol_;
+  uint64_t startTime_ = 0;
+  uint64_t endTime_ = 0;
+  uint64_t intervalMs_ = 60000;
+
+  // Owned by the playback thread
+  std::vector<Checkpoint> checkpoints_;
+  std::vector<uint32_t> secondIndex_;  // Second since start -> last checkpoint before it
+  database::TickCursor cursor_;
+  std::vector<Tick> page_;
+  size_t pagePos_ = 0;
+  BarState bar_;
+  Candle::Footprint footprint_;  // Of bar_
+  Clock::time_point lastCandleSent_{};
+  Clock::time_point lastStateSent_{};
+
+  // Serialises start() and stop(), so a session's thread and callbacks are
+  // only replaced once the previous thread has been joined
+  std::mutex sessionMutex_;
+
+  // Controls and clock, under mutex_
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool running_ = false;
+  bool ready_ = false;
+  bool paused_ = true;
+  bool finished_ = false;
+  double speed_ = 1.0;
+  size_t stepTicks_ = 0;
+  bool stateChanged_ = false;
+  std::optional<uint64_t> pendingSeek_;
+  uint64_t currentTime_ = 0;
+  uint64_t ticksPlayed_ = 0;
+  double anchorTime_ = 0.0;            // Replay ms at anchorWall_
+  Clock::time_point anchorWall_{};
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,146 @@
+#include "SparklineService.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+constexpr float kNoData = std::numeric_limits<float>::quiet_NaN();
+
+} // namespace
+
+SparklineService::SparklineService(size_t points, uint64_t windowMs)
+    : points_(std::max<size_t>(points, 2)), bucketMs_(std::max<uint64_t>(windowMs / points_, 1)) {}
+
+void SparklineService::advance(Ring& ring, uint64_t bucket) const {
+  // Quiet buckets repeat the last close; a gap longer than the window
+  // rewrites every slot
+  float last = ring.values[ring.headBucket % points_];
+  uint64_t steps = std::min<uint64_t>(bucket - ring.headBucket, points_);
+  for (uint64_t b = bucket - steps + 1; b <= bucket; ++b) {
+    ring.values[b % points_] = last;
+  }
+  ring.headBucket = bucket;
+}
+
+void SparklineService::update(const std::string& symbol, uint64_t timeMs, double price) {
+  if (price <= 0.0) return;
+  uint64_t bucket = timeMs / bucketMs_;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& ring = rings_[symbol];
+  if (ring.values.empty()) {
+    ring.values.assign(points_, kNoData);
+  }
+
+  if (ring.empty) {
+    ring.headBucket = bucket;
+    ring.empty = false;
+  } else if (bucket > ring.headBucket) {
+    advance(ring, bucket);
+  } else if (bucket < ring.headBucket) {
+    return;  // Late update for a bucket that already has a newer close
+  }
+  ring.values[bucket % points_] = static_cast<float>(price);
+}
+
+void SparklineService::seed(const std::string& symbol, const std::vector<Candle>& candles) {
+  // Closes per bucket, built apart so live points always win
+  Ring seeded;
+  seeded.values.assign(points_, kNoData);
+  for (const auto& candle : candles) {
+    if (candle.close <= 0.0) continue;
+    uint64_t bucket = candle.start_time_ms / bucketMs_;
+    if (seeded.empty) {
+      seeded.headBucket = bucket;
+      seeded.empty = false;
+    } else if (bucket > seeded.headBucket) {
+      advance(seeded, bucket);
+    } else if (bucket < seeded.headBucket) {
+      continue;  // Candles are oldest first; skip strays
+    }
+    seeded.values[bucket % points_] = static_cast<float>(candle.close);
+  }
+  if (seeded.empty) return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& ring = rings_[symbol];
+  if (ring.values.empty() || ring.empty) {
+    ring = std::move(seeded);
+    return;
+  }
+  for (size_t offset = 0; offset < points_ && offset <= seeded.headBucket; ++offset) {
+    uint64_t bucket = seeded.headBucket - offset;
+    if (bucket > ring.headBucket || ring.headBucket - bucket >= points_) continue;
+    float& slot = ring.values[bucket % points_];
+    if (std::isnan(slot)) {
+      slot = seeded.values[bucket % points_];
+    }
+  }
+}
+
+bool SparklineService::tracks(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = rings_.find(symbol);
+  return it != rings_.end() && !it->second.empty;
+}
+
+void SparklineService::copySeries(const Ring& ring, uint64_t endBucket, float* out) const {
+  float last = ring.values[ring.headBucket % points_];
+  for (size_t i = 0; i < points_; ++i) {
+    uint64_t offset = points_ - 1 - i;
+    if (offset > endBucket) {
+      out[i] = kNoData;
+      continue;
+    }
+    uint64_t bucket = endBucket - offset;
+    if (bucket > ring.headBucket) {
+      out[i] = last;  // No trade since: still at the last close
+    } else if (ring.headBucket - bucket >= points_) {
+      out[i] = kNoData;
+    } else {
+      out[i] = ring.values[bucket % points_];
+    }
+  }
+}
+
+SparklineService::Snapshot SparklineService::snapshot(const std::vector<std::string>& symbols,
+                                                      uint64_t nowMs) const {
+  Snapshot result;
+  uint64_t endBucket = nowMs / bucketMs_;
+  result.endTime = (endBucket + 1) * bucketMs_;
+  result.bucketMs = bucketMs_;
+  result.points = points_;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto append = [&](const std::string& symbol, const Ring& ring) {
+    if (ring.empty) return;
+    result.symbols.push_back(symbol);
+    result.values.resize(result.symbols.size() * points_);
+    copySeries(ring, endBucket, result.values.data() + (result.symbols.size() - 1) * points_);
+  };
+
+  if (symbols.empty()) {
+    result.symbols.reserve(rings_.size());
+    result.values.reserve(rings_.size() * points_);
+    for (const auto& [symbol, ring] : rings_) {
+      append(symbol, ring);
+    }
+  } else {
+    result.symbols.reserve(symbols.size());
+    result.values.reserve(symbols.size() * points_);
+    for (const auto& symbol : symbols) {
+      auto it = rings_.find(symbol);
+      if (it != rings_.end()) {
+        append(symbol, it->second);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DataModels.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Tiny fixed-size price histories for watchlists and screeners.
+//
+// Each tracked symbol has a ring of `points` closes over `windowMs` (96
+// fifteen-minute buckets over 24h by default), updated in place from the
+// miniTicker and aggTrade streams. A point is the last price seen in its
+// bucket; buckets with no trade repeat the previous close, and buckets from
+// before the symbol was first seen are NaN.
+//
+// A snapshot aligns every requested symbol to the same end bucket, so a
+// whole watchlist is one contiguous block of floats.
+class SparklineService {
+public:
+  static constexpr size_t kDefaultPoints = 96;
+  static constexpr uint64_t kDefaultWindowMs = 24ULL * 60 * 60 * 1000;
+
+  struct Snapshot {
+    uint64_t endTime = 0;              // End of the newest bucket
+    uint64_t bucketMs = 0;
+    size_t points = 0;
+    std::vector<std::string> symbols;  // Requested symbols that are tracked
+    std::vector<float> values;         // symbols.size() x points, oldest first
+  };
+
+  explicit SparklineService(size_t points = kDefaultPoints, uint64_t windowMs = kDefaultWindowMs);
+
+  void update(const std::string& symbol, uint64_t timeMs, double price);
+
+  // Fill buckets that have no live data yet from stored candles (closes)
+  void seed(const std::string& symbol, const std::vector<Candle>& candles);
+
+  bool tracks(const std::string& symbol) const;
+
+  // Series ending at the bucket containing nowMs; every tracked symbol when
+  // `symbols` is empty
+  Snapshot snapshot(const std::vector<std::string>& symbols, uint64_t nowMs) const;
+
+  size_t points() const { return points_; }
+  uint64_t bucketMs() const { return bucketMs_; }
+
+private:
+  struct Ring {
+    std::vector<float> values;  // Slot = bucket % points
+    uint64_t headBucket = 0;    // Newest bucket written
+    bool empty = true;
+  };
+
+  void advance(Ring& ring, uint64_t bucket) const;
+  void copySeries(const Ring& ring, uint64_t endBucket, float* out) const;
+
+  size_t points_;
+  uint64_t bucketMs_;
+  std::unordered_map<std::string, Ring> rings_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "DataModels.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace database {
+class Database;
+}
+
+namespace core {
+
+// An instrument priced from other symbols' trades
+struct SyntheticDefinition {
+  enum class Kind {
+    RATIO,   // (w0 * p0) / (w1 * p1), e.g. ETHUSDT/BTCUSDT
+    SPREAD,  // w0 * p0 + w1 * p1 (weights default to 1, -1), e.g. basis
+    BASKET   // Sum of w_i * p_i over any number of legs
+  };
+
+  struct Leg {
+    std::string symbol;
+    double weight = 1.0;
+  };
+
+  std::string name;
+  Kind kind = Kind::RATIO;
+  std::vector<Leg> legs;
+  uint64_t toleranceMs = 1000;  // Legs must all have traded within this of a tick
+};
+
+std::optional<SyntheticDefinition::Kind> parseSyntheticKind(const std::string& name);
+const char* syntheticKindName(SyntheticDefinition::Kind kind);
+
+// Default name for a definition without one: "A/B", "A-B" or "A+B+C"
+std::string syntheticName(const SyntheticDefinition& definition);
+
+// Turns leg trades into synthetic ticks that go through the normal candle
+// pipeline under the synthetic's name.
+//
+// Every leg trade updates that leg's last price and event time. When all
+// legs have a price no older than the tolerance at the trade's event time,
+// the synthetic prints a tick at that time: price from the definition,
+// quantity = the leg trade's quote notional (so candle volume is traded
+// notional across legs), and the aggressor side flipped for legs that
+// weigh negatively or sit in a ratio's denominator. Synthetic ticks carry no
+// trade ID, so storage keys them by content.
+//
+// History is built the same way by merge-joining the legs' stored ticks in
+// time order, paging each leg from the database, in one pass.
+class SyntheticInstruments {
+public:
+  static constexpr size_t kMaxLegs = 8;
+  static constexpr size_t kHistoryPageTicks = 4096;
+
+  // Validates legs for the kind; replaces a synthetic of the same name
+  bool define(SyntheticDefinition definition);
+  bool remove(const std::string& name);
+
+  bool contains(const std::string& name) const;
+  std::optional<SyntheticDefinition> definition(const std::string& name) const;
+  std::vector<SyntheticDefinition> definitions() const;
+
+  // Union of all legs, for the trade subscription
+  std::vector<std::string> legSymbols() const;
+
+  // Synthetic ticks (name, tick) produced by one leg trade
+  std::vector<std::pair<std::string, Tick>> onLegTick(const std::string& symbol, const Tick& tick);
+
+  // Replay [startTime, endTime] of stored leg ticks through a fresh join;
+  // `sink` gets synthetic ticks in time order. Returns how many were made.
+  size_t buildHistory(const database::Database& database, const SyntheticDefinition& definition,
+                      uint64_t startTime, uint64_t endTime, const std::function<void(const Tick&)>& sink) const;
+
+private:
+  // Last trade per leg for one synthetic
+  struct JoinState {
+    std::vector<double> prices;
+    std::vector<uint64_t> times;
+    uint64_t lastTime = 0;  // Output stays in time order
+  };
+
+  static std::optional<Tick> join(const SyntheticDefinition& definition, JoinState& state, size_t leg,
+                                  const Tick& tick);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, SyntheticDefinition> definitions_;
+  std::map<std::string, JoinState> states_;
+};
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,144 @@
+#include "ThreadAffinity.h"
+#include "Tracing.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace glora {
+namespace core {
+
+namespace {
+
+std::mutex g_topologyMutex;
+settings::ThreadTopology g_topology;
+
+#ifdef __linux__
+// set_mempolicy(2) through syscall() so we don't need to link libnuma
+constexpr int kMpolPreferred = 1;
+
+bool setPreferredNode(int node) {
+  constexpr size_t kBits = sizeof(unsigned long) * 8;
+  if (node < 0 || static_cast<size_t>(node) >= kBits * 16) return false;
+  unsigned long mask[16] = {};
+  mask[node / kBits] |= 1UL << (node % kBits);
+  return syscall(SYS_set_mempolicy, kMpolPreferred, mask, kBits * 16) == 0;
+}
+#endif
+
+} // namespace
+
+void setThreadTopology(const settings::ThreadTopology& topology) {
+  std::lock_guard<std::mutex> lock(g_topologyMutex);
+  g_topology = topology;
+  
+  if (topology.enabled) {
+    std::cout << "[ThreadAffinity] Topology enabled:" << std::endl;
+    for (size_t i = 0; i < topology.roles.size(); ++i) {
+      const auto& role = topology.roles[i];
+      std::cout << "  " << settings::threadRoleName(static_cast<settings::ThreadRole>(i))
+                << ": cores=";
+      if (role.cores.empty()) {
+        std::cout << "any";
+      } else {
+        for (size_t c = 0; c < role.cores.size(); ++c) {
+          std::cout << (c ? "," : "") << role.cores[c];
+        }
+      }
+      std::cout << (role.realtime ? " SCHED_FIFO" : "")
+                << " priority=" << role.priority
+                << " numa=" << role.numaNode << std::endl;
+    }
+  }
+}
+
+void applyThreadRole(settings::ThreadRole role, const char* name) {
+  settings::ThreadRoleConfig config;
+  bool enabled = false;
+  {
+    std::lock_guard<std::mutex> lock(g_topologyMutex);
+    enabled = g_topology.enabled;
+    config = g_topology.forRole(role);
+  }
+  Tracer::getInstance().setThreadName(name);
+
+#ifdef __linux__
+  // Thread names are limited to 15 characters plus the terminator
+  char shortName[16];
+  std::strncpy(shortName, name, sizeof(shortName) - 1);
+  shortName[sizeof(shortName) - 1] = '\0';
+  pthread_setname_np(pthread_self(), shortName);
+
+  if (!enabled) return;
+
+  if (!config.cores.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int core : config.cores) {
+      if (core >= 0 && core < CPU_SETSIZE) {
+        CPU_SET(core, &cpus);
+      }
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (rc != 0) {
+      std::cerr << "[ThreadAffinity] " << name << ": failed to set affinity: "
+                << std::strerror(rc) << std::endl;
+    }
+  }
+
+  if (config.realtime) {
+    sched_param param{};
+    param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO),
+                                    std::min(config.priority, sched_get_priority_max(SCHED_FIFO)));
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+      std::cerr << "[ThreadAffinity] " << name << ": SCHED_FIFO unavailable ("
+                << std::strerror(rc) << "), staying on SCHED_OTHER" << std::endl;
+    }
+  } else if (config.priority != 0) {
+    // Per-thread nice value; on Linux setpriority applies to a single task id
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), config.priority) != 0) {
+      std::cerr << "[ThreadAffinity] " << name << ": failed to set nice "
+                << config.priority << ": " << std::strerror(errno) << std::endl;
+    }
+  }
+
+  if (config.numaNode >= 0 && !setPreferredNode(config.numaNode)) {
+    std::cerr << "[ThreadAffinity] " << name << ": failed to prefer NUMA node "
+              << config.numaNode << ": " << std::strerror(errno) << std::endl;
+  }
+#else
+  (void)role;
+  (void)name;
+  (void)config;
+  (void)enabled;
+#endif
+}
+
+size_t threadCountForRole(settings::ThreadRole role, size_t fallback) {
+  std::lock_guard<std::mutex> lock(g_topologyMutex);
+  const auto& cores = g_topology.forRole(role).cores;
+  if (g_topology.enabled && !cores.empty()) {
+    return cores.size();
+  }
+  return fallback;
+}
+
+void applyThreadRoleOnce(settings::ThreadRole role, const char* name) {
+  thread_local bool applied = false;
+  if (applied) return;
+  applied = true;
+  applyThreadRole(role, name);
+}
+
+} // namespace core
+} // namespace glora
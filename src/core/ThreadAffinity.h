@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../settings/Settings.h"
+#include <cstddef>
+
+namespace glora {
+namespace core {
+
+// Install the process-wide thread topology. Call once at startup, before
+// the threads that apply roles are started.
+void setThreadTopology(const settings::ThreadTopology& topology);
+
+// Name the calling thread (max 15 chars shows in top/perf) and apply the
+// role's core set, scheduling policy and NUMA memory policy. Failures are
+// logged and the thread keeps running with default placement.
+void applyThreadRole(settings::ThreadRole role, const char* name);
+
+// Number of threads a pool serving `role` should run: one per configured
+// core when the role is pinned, `fallback` otherwise
+size_t threadCountForRole(settings::ThreadRole role, size_t fallback);
+
+// Same as applyThreadRole, but only the first call on each thread has an
+// effect. Used from callbacks that run on threads owned by a library.
+void applyThreadRoleOnce(settings::ThreadRole role, const char* name);
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Fixed-size worker pool for CPU-bound batch jobs (footprint rebuilds,
+// aggregation). Tasks are executed in FIFO order; submit() returns a future
+// so callers can join on a batch of tasks.
+class ThreadPool {
+public:
+  // Runs on each worker thread before it takes tasks (naming, pinning)
+  using WorkerInit = std::function<void(size_t index)>;
+
+  explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency(),
+                      WorkerInit init = nullptr) {
+    threadCount = std::max<size_t>(1, threadCount);
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+      workers_.emplace_back([this, init, i]() {
+        if (init) init(i);
+        workerLoop();
+      });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mut_);
+      stopping_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Queue a callable and get a future for its result
+  template <typename F>
+  auto submit(F &&func) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+    std::future<Result> result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mut_);
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cond_.notify_one();
+    return result;
+  }
+
+  size_t size() const { return workers_.size(); }
+
+private:
+  void workerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mut_);
+        cond_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+        if (stopping_ && tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mut_;
+  std::condition_variable cond_;
+  bool stopping_{false};
+};
+
+} // namespace core
+} // namespace glora
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
@@ -38,6 +39,21 @@ public:
     return item;
   }
 
+  // Pop an item, waiting at most `timeout`. std::nullopt on timeout or when
+  // the queue was invalidated (see valid())
+  std::optional<T> pop_for(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mut_);
+    cond_.wait_for(lock, timeout, [this]() { return !queue_.empty() || !valid_; });
+
+    if (!valid_ || queue_.empty()) {
+      return std::nullopt;
+    }
+
+    T item = std::move(queue_.front());
+    queue_.pop();
+    return item;
+  }
+
   // Attempt to pop an item without blocking
   std::optional<T> try_pop() {
     std::lock_guard<std::mutex> lock(mut_);
@@ -54,6 +70,16 @@ public:
     return queue_.empty();
   }
 
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mut_);
+    return queue_.size();
+  }
+
+  bool valid() const {
+    std::lock_guard<std::mutex> lock(mut_);
+    return valid_;
+  }
+
   void invalidate() {
     std::lock_guard<std::mutex> lock(mut_);
     valid_ = false;
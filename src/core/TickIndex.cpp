@@ -0,0 +1,262 @@
+#include "TickIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+bool tickBefore(const Tick& tick, uint64_t timeMs) { return tick.timestamp_ms < timeMs; }
+
+uint64_t nowMs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+void TickIndex::setLoader(Loader loader) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  loader_ = std::move(loader);
+}
+
+TickIndex::Bucket& TickIndex::bucketFor(const std::string& symbol, SymbolState& state, uint64_t id,
+                                        uint64_t coveredFrom) {
+  auto [it, inserted] = state.buckets.try_emplace(id);
+  Bucket& bucket = it->second;
+  if (inserted) {
+    bucket.coveredFrom = coveredFrom;
+    lru_.emplace_front(symbol, id);
+    bucket.lru = lru_.begin();
+  }
+  return bucket;
+}
+
+void TickIndex::eraseBucket(SymbolState& state, std::unordered_map<uint64_t, Bucket>::iterator it) {
+  tickCount_ -= it->second.ticks.size();
+  lru_.erase(it->second.lru);
+  state.buckets.erase(it);
+}
+
+void TickIndex::touch(Bucket& bucket) {
+  lru_.splice(lru_.begin(), lru_, bucket.lru);
+}
+
+void TickIndex::evictIfNeeded() {
+  auto it = lru_.end();
+  while (tickCount_ + lru_.size() * kBucketCost > maxTicks_ && it != lru_.begin()) {
+    --it;
+    auto& [symbol, id] = *it;
+    auto stateIt = symbols_.find(symbol);
+    if (stateIt == symbols_.end()) continue;
+    SymbolState& state = stateIt->second;
+    // The live bucket has no copy in storage yet that covers all of it
+    if (id == state.liveId) continue;
+    auto bucketIt = state.buckets.find(id);
+    auto next = std::next(it);
+    eraseBucket(state, bucketIt);
+    it = next;
+  }
+}
+
+void TickIndex::append(const std::string& symbol, const Tick& tick) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SymbolState& state = symbols_[symbol];
+  uint64_t id = bucketId(tick.timestamp_ms);
+
+  // A stream that was already running in the previous bucket covers this
+  // one from its start, otherwise only from the first tick we saw
+  uint64_t coveredFrom = (state.liveId != 0 && id == state.liveId + 1) ? id * kBucketMs : tick.timestamp_ms;
+  Bucket& bucket = bucketFor(symbol, state, id, coveredFrom);
+  if (id > state.liveId) {
+    state.liveId = id;
+  }
+
+  if (bucket.ticks.empty() || bucket.ticks.back().timestamp_ms <= tick.timestamp_ms) {
+    bucket.ticks.push_back(tick);
+  } else {
+    auto pos = std::upper_bound(bucket.ticks.begin(), bucket.ticks.end(), tick.timestamp_ms,
+                                [](uint64_t time, const Tick& t) { return time < t.timestamp_ms; });
+    bucket.ticks.insert(pos, tick);
+  }
+  ++tickCount_;
+
+  evictIfNeeded();
+}
+
+void TickIndex::invalidateRange(const std::string& symbol, uint64_t startTime, uint64_t endTime) {
+  if (endTime <= startTime) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stateIt = symbols_.find(symbol);
+  if (stateIt == symbols_.end()) return;
+  SymbolState& state = stateIt->second;
+
+  for (uint64_t id = bucketId(startTime); id <= bucketId(endTime - 1); ++id) {
+    auto it = state.buckets.find(id);
+    if (it == state.buckets.end()) continue;
+    if (id == state.liveId) {
+      // Keep the live ticks, reload everything before them
+      Bucket& bucket = it->second;
+      if (!bucket.ticks.empty()) {
+        bucket.coveredFrom = std::max(bucket.coveredFrom, bucket.ticks.front().timestamp_ms);
+        auto keep = std::lower_bound(bucket.ticks.begin(), bucket.ticks.end(), bucket.coveredFrom, tickBefore);
+        tickCount_ -= static_cast<size_t>(keep - bucket.ticks.begin());
+        bucket.ticks.erase(bucket.ticks.begin(), keep);
+      }
+      continue;
+    }
+    eraseBucket(state, it);
+  }
+}
+
+void TickIndex::fillGaps(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                         std::vector<Tick>& uncached) {
+  uint64_t now = nowMs();
+  Loader loader;
+  std::vector<Gap> gaps;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loader_) return;
+    loader = loader_;
+
+    SymbolState& state = symbols_[symbol];
+    for (uint64_t id = bucketId(startTime); id <= bucketId(endTime - 1); ++id) {
+      uint64_t bucketStart = id * kBucketMs;
+      auto it = state.buckets.find(id);
+      if (it == state.buckets.end()) {
+        gaps.push_back({id, bucketStart, bucketStart + kBucketMs});
+      } else if (it->second.coveredFrom > bucketStart) {
+        gaps.push_back({id, bucketStart, it->second.coveredFrom});
+      }
+    }
+  }
+  if (gaps.empty()) return;
+
+  // One storage query per run of adjacent gaps
+  size_t runStart = 0;
+  while (runStart < gaps.size()) {
+    size_t runEnd = runStart + 1;
+    while (runEnd < gaps.size() && gaps[runEnd].start == gaps[runEnd - 1].end) {
+      ++runEnd;
+    }
+
+    std::vector<Tick> loaded;
+    loader(symbol, gaps[runStart].start, gaps[runEnd - 1].end, loaded);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    SymbolState& state = symbols_[symbol];
+    auto tickIt = loaded.begin();
+    for (size_t g = runStart; g < runEnd; ++g) {
+      const Gap& gap = gaps[g];
+      tickIt = std::lower_bound(tickIt, loaded.end(), gap.start, tickBefore);
+      auto gapEnd = std::lower_bound(tickIt, loaded.end(), gap.end, tickBefore);
+
+      // Storage may not hold all of a span that isn't over yet
+      if (gap.end > now) {
+        uncached.insert(uncached.end(), tickIt, gapEnd);
+        tickIt = gapEnd;
+        continue;
+      }
+
+      // The bucket may have been created or extended by the live stream
+      // while we were loading; only take what is still missing
+      Bucket& bucket = bucketFor(symbol, state, gap.id, gap.end);
+      if (bucket.coveredFrom > gap.start) {
+        auto missingEnd = std::lower_bound(tickIt, gapEnd, bucket.coveredFrom, tickBefore);
+        bucket.ticks.insert(bucket.ticks.begin(), tickIt, missingEnd);
+        tickCount_ += static_cast<size_t>(missingEnd - tickIt);
+        bucket.coveredFrom = gap.start;
+      }
+      tickIt = gapEnd;
+    }
+    runStart = runEnd;
+  }
+}
+
+size_t TickIndex::forEach(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                          const std::function<void(const Tick&)>& visit) {
+  if (endTime <= startTime) return 0;
+  std::vector<Tick> uncached;
+  fillGaps(symbol, startTime, endTime, uncached);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stateIt = symbols_.find(symbol);
+  if (stateIt == symbols_.end()) return 0;
+  SymbolState& state = stateIt->second;
+
+  size_t visited = 0;
+  auto extra = std::lower_bound(uncached.begin(), uncached.end(), startTime, tickBefore);
+  for (uint64_t id = bucketId(startTime); id <= bucketId(endTime - 1); ++id) {
+    auto it = state.buckets.find(id);
+    Bucket* bucket = it == state.buckets.end() ? nullptr : &it->second;
+
+    // Uncached ticks come before what the bucket covers (the live stream may
+    // have created it since they were loaded)
+    uint64_t extraEnd = std::min(bucket ? bucket->coveredFrom : (id + 1) * kBucketMs, endTime);
+    for (; extra != uncached.end() && extra->timestamp_ms < (id + 1) * kBucketMs; ++extra) {
+      if (extra->timestamp_ms < extraEnd) {
+        visit(*extra);
+        ++visited;
+      }
+    }
+    if (!bucket) continue;
+    touch(*bucket);
+
+    auto tick = std::lower_bound(bucket->ticks.begin(), bucket->ticks.end(), startTime, tickBefore);
+    for (; tick != bucket->ticks.end() && tick->timestamp_ms < endTime; ++tick) {
+      visit(*tick);
+      ++visited;
+    }
+  }
+
+  evictIfNeeded();
+  return visited;
+}
+
+bool TickIndex::buildCandle(const std::string& symbol, uint64_t startTime, uint64_t endTime, Candle& out) {
+  out.start_time_ms = startTime;
+  out.end_time_ms = endTime;
+  return forEach(symbol, startTime, endTime, [&out](const Tick& tick) { out.add_tick(tick); }) > 0;
+}
+
+std::vector<Tick> TickIndex::getTrades(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                       double minQuantity, size_t limit) {
+  std::vector<Tick> trades;
+  forEach(symbol, startTime, endTime, [&trades, minQuantity](const Tick& tick) {
+    if (tick.quantity >= minQuantity) {
+      trades.push_back(tick);
+    }
+  });
+
+  std::reverse(trades.begin(), trades.end());
+  if (limit > 0 && trades.size() > limit) {
+    trades.resize(limit);
+  }
+  return trades;
+}
+
+void TickIndex::evictSymbol(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stateIt = symbols_.find(symbol);
+  if (stateIt == symbols_.end()) return;
+  for (auto& [id, bucket] : stateIt->second.buckets) {
+    tickCount_ -= bucket.ticks.size();
+    lru_.erase(bucket.lru);
+  }
+  symbols_.erase(stateIt);
+}
+
+size_t TickIndex::tickCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tickCount_;
+}
+
+size_t TickIndex::bucketCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+} // namespace core
+} // namespace glora
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "DataModels.h"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// In-memory tick archive bucketed by time, for bar drill-downs.
+//
+// Ticks are kept per symbol in fixed buckets of kBucketMs. Any bar of any
+// interval maps to a contiguous run of buckets, so a footprint or a trade
+// list for it is a binary search into the first bucket plus a scan of the
+// span. The live stream appends to the newest buckets; spans the index does
+// not hold (older history, or the part of a bucket before the app started)
+// are paged in through the loader on first use. Spans that end after the
+// current time are loaded on every query but not cached, since storage may
+// still be filling them. Least recently used buckets are evicted once the
+// index holds more than its tick budget; every bucket, empty or not, is
+// charged kBucketCost ticks for its bookkeeping.
+//
+// Thread safe. Loads run without holding the index lock.
+class TickIndex {
+public:
+  static constexpr uint64_t kBucketMs = 60 * 1000;
+  static constexpr size_t kDefaultMaxTicks = 4'000'000;  // ~128 MB of Tick
+  static constexpr size_t kBucketCost = 4;               // Map and LRU nodes, in Tick sizes
+
+  // Append ticks for [startTime, endTime) in time order to `out`
+  using Loader = std::function<void(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                    std::vector<Tick>& out)>;
+
+  explicit TickIndex(size_t maxTicks = kDefaultMaxTicks) : maxTicks_(maxTicks) {}
+
+  void setLoader(Loader loader);
+
+  // Live ticks, expected in (roughly) time order
+  void append(const std::string& symbol, const Tick& tick);
+
+  // History for [startTime, endTime) changed in storage (gap fill); drop the
+  // affected buckets so the next query pages them in again
+  void invalidateRange(const std::string& symbol, uint64_t startTime, uint64_t endTime);
+
+  // Visit ticks in [startTime, endTime) in time order under the index lock.
+  // Pages missing spans in first. Returns the number of ticks visited.
+  size_t forEach(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                 const std::function<void(const Tick&)>& visit);
+
+  // Footprint bar for [startTime, endTime); false when there are no ticks
+  bool buildCandle(const std::string& symbol, uint64_t startTime, uint64_t endTime, Candle& out);
+
+  // Trades in [startTime, endTime) with quantity >= minQuantity, newest first,
+  // at most `limit` of them (0 = no limit)
+  std::vector<Tick> getTrades(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                              double minQuantity = 0.0, size_t limit = 0);
+
+  // Forget a symbol entirely
+  void evictSymbol(const std::string& symbol);
+
+  size_t tickCount() const;
+  size_t bucketCount() const;
+
+private:
+  struct Bucket {
+    std::vector<Tick> ticks;            // Time ordered
+    uint64_t coveredFrom = 0;           // Ticks are complete from here to the bucket end
+    std::list<std::pair<std::string, uint64_t>>::iterator lru;
+  };
+
+  struct SymbolState {
+    std::unordered_map<uint64_t, Bucket> buckets;  // Bucket id -> bucket
+    uint64_t liveId = 0;                           // Bucket the live stream is writing to
+  };
+
+  // A span to page in: [start, end) of bucket `id`
+  struct Gap {
+    uint64_t id;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  static uint64_t bucketId(uint64_t timeMs) { return timeMs / kBucketMs; }
+
+  Bucket& bucketFor(const std::string& symbol, SymbolState& state, uint64_t id, uint64_t coveredFrom);
+  void eraseBucket(SymbolState& state, std::unordered_map<uint64_t, Bucket>::iterator it);
+  void touch(Bucket& bucket);
+  void evictIfNeeded();
+  // Page missing spans of [startTime, endTime) in; ticks of spans that reach
+  // past now are appended to `uncached` instead
+  void fillGaps(const std::string& symbol, uint64_t startTime, uint64_t endTime, std::vector<Tick>& uncached);
+
+  Loader loader_;
+  size_t maxTicks_;
+  size_t tickCount_ = 0;
+
+  std::unordered_map<std::string, SymbolState> symbols_;
+  std::list<std::pair<std::string, uint64_t>> lru_;  // Most recently used first
+  mutable std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace glora
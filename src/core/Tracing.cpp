@@ -0,0 +1,167 @@
+#include "Tracing.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace glora {
+namespace core {
+
+namespace {
+
+// Name given before the thread's first span, applied when its buffer is made
+thread_local std::string t_threadName;
+
+void appendEscaped(std::string& out, const char* text) {
+  for (const char* c = text; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out += '\\';
+      out += *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      out += *c;
+    }
+  }
+}
+
+void appendMicros(std::string& out, uint64_t ns) {
+  char buffer[32];
+  int length = std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                             static_cast<unsigned long long>(ns / 1000),
+                             static_cast<unsigned long long>(ns % 1000));
+  out.append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+Tracer& Tracer::getInstance() {
+  static Tracer instance;
+  return instance;
+}
+
+void Tracer::start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  sessionStartNs_.store(nowNs(), std::memory_order_relaxed);
+  sessionEndNs_.store(0, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_release);
+  std::cout << "[Tracer] Tracing started" << std::endl;
+}
+
+void Tracer::stop() {
+  if (!enabled_.exchange(false, std::memory_order_acq_rel)) return;
+  sessionEndNs_.store(nowNs(), std::memory_order_relaxed);
+  std::cout << "[Tracer] Tracing stopped" << std::endl;
+}
+
+Tracer::ThreadBuffer*& Tracer::currentBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+  return buffer;
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer() {
+  ThreadBuffer*& buffer = currentBuffer();
+  if (!buffer) {
+    auto created = std::make_unique<ThreadBuffer>();
+    created->spans = std::make_unique<Span[]>(kSpansPerThread);
+    std::lock_guard<std::mutex> lock(mutex_);
+    created->tid = static_cast<uint32_t>(buffers_.size() + 1);
+    created->name = t_threadName.empty() ? "thread-" + std::to_string(created->tid) : t_threadName;
+    buffer = created.get();
+    buffers_.push_back(std::move(created));
+  }
+  return *buffer;
+}
+
+void Tracer::setThreadName(const char* name) {
+  t_threadName = name;
+  if (ThreadBuffer* buffer = currentBuffer()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer->name = name;
+  }
+}
+
+void Tracer::record(const char* category, const char* name, uint64_t startNs, uint64_t endNs) {
+  if (!enabled()) return;
+  ThreadBuffer& buffer = threadBuffer();
+
+  // First span of a new session on this thread: only the owner resets
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+    buffer.count.store(0, std::memory_order_relaxed);
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    buffer.generation.store(generation, std::memory_order_release);
+  }
+
+  size_t count = buffer.count.load(std::memory_order_relaxed);
+  if (count >= kSpansPerThread) {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.spans[count] = Span{category, name, startNs, endNs};
+  buffer.count.store(count + 1, std::memory_order_release);
+}
+
+Tracer::Summary Tracer::exportChromeTrace(std::string& out) const {
+  Summary summary;
+  out.clear();
+  out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  out += "{\"args\":{\"name\":\"glora\"},\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0}";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  uint64_t sessionStart = sessionStartNs_.load(std::memory_order_relaxed);
+  uint64_t sessionEnd = sessionEndNs_.load(std::memory_order_relaxed);
+  if (sessionEnd == 0) sessionEnd = nowNs();
+  summary.durationMs = (sessionEnd - std::min(sessionStart, sessionEnd)) / 1000000;
+
+  for (const auto& buffer : buffers_) {
+    // Threads that have not traced since start() still hold the last session
+    if (buffer->generation.load(std::memory_order_acquire) != generation) continue;
+    size_t count = buffer->count.load(std::memory_order_acquire);
+    if (count == 0) continue;
+    ++summary.threads;
+    summary.spans += count;
+    summary.dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+    std::string tid = std::to_string(buffer->tid);
+    out += ",{\"args\":{\"name\":\"";
+    appendEscaped(out, buffer->name.c_str());
+    out += "\"},\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + "}";
+
+    for (size_t i = 0; i < count; ++i) {
+      const Span& span = buffer->spans[i];
+      uint64_t start = std::max(span.startNs, sessionStart);
+      uint64_t end = std::max(span.endNs, start);
+      out += ",{\"cat\":\"";
+      appendEscaped(out, span.category);
+      out += "\",\"dur\":";
+      appendMicros(out, end - start);
+      out += ",\"name\":\"";
+      appendEscaped(out, span.name);
+      out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+      out += tid;
+      out += ",\"ts\":";
+      appendMicros(out, start - sessionStart);
+      out += '}';
+    }
+  }
+  out += "]}";
+  return summary;
+}
+
+bool Tracer::writeChromeTrace(const std::string& path, Summary& summary) const {
+  std::string json;
+  summary = exportChromeTrace(json);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (!file) {
+    std::cerr << "[Tracer] Failed to write " << path << std::endl;
+    return false;
+  }
+  std::cout << "[Tracer] Wrote " << summary.spans << " spans from " << summary.threads << " threads ("
+            << summary.dropped << " dropped) to " << path << std::endl;
+  return true;
+}
+
+} // namespace core
+} // namespace glora
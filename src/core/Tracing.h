@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace glora {
+namespace core {
+
+// Timeline tracing of pipeline spans, exported as Chrome trace event JSON
+// (chrome://tracing or ui.perfetto.dev), one track per thread.
+//
+// Spans are recorded by GLORA_TRACE_SCOPE(category, name) with string
+// literals. While tracing is off a scope costs one relaxed atomic load.
+// While on, it reads the steady clock twice and appends one fixed-size span
+// to the calling thread's own buffer: a plain store plus a release store of
+// the count, no lock and no allocation after the thread's first span. A
+// buffer that fills up counts further spans as dropped instead of growing.
+//
+// start() begins a new session; buffers from the previous one are reset by
+// their owning thread on its next span, so the exporter never races a reset.
+class Tracer {
+public:
+  static constexpr size_t kSpansPerThread = 1 << 15;
+
+  struct Summary {
+    size_t spans = 0;
+    size_t dropped = 0;
+    size_t threads = 0;
+    uint64_t durationMs = 0;
+  };
+
+  static Tracer& getInstance();
+
+  // Start a session, discarding the previous one's spans
+  void start();
+  // Stop recording; the session's spans stay readable until the next start()
+  void stop();
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // The last (or current) session as {"traceEvents": [...]} into `out`
+  Summary exportChromeTrace(std::string& out) const;
+  // Same, written to a file; false if it cannot be written
+  bool writeChromeTrace(const std::string& path, Summary& summary) const;
+
+  // Track name for the calling thread (set from applyThreadRole)
+  void setThreadName(const char* name);
+
+  void record(const char* category, const char* name, uint64_t startNs, uint64_t endNs);
+
+  static uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+private:
+  Tracer() = default;
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  struct Span {
+    const char* category;
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+  };
+
+  // Written only by its thread; read by the exporter up to `count`
+  struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::string name;                      // Under mutex_
+    std::unique_ptr<Span[]> spans;
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> dropped{0};
+    std::atomic<uint64_t> generation{0};
+  };
+
+  // The calling thread's buffer, null before its first span
+  static ThreadBuffer*& currentBuffer();
+  ThreadBuffer& threadBuffer();
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<uint64_t> sessionStartNs_{0};
+  std::atomic<uint64_t> sessionEndNs_{0};
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;  // Never freed: threads may outlive a session
+};
+
+// RAII span; use through GLORA_TRACE_SCOPE
+class TraceScope {
+public:
+  TraceScope(const char* category, const char* name)
+      : category_(category), name_(name),
+        startNs_(Tracer::getInstance().enabled() ? Tracer::nowNs() : 0) {}
+
+  ~TraceScope() {
+    if (startNs_ != 0) {
+      Tracer::getInstance().record(category_, name_, startNs_, Tracer::nowNs());
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+  const char* category_;
+  const char* name_;
+  uint64_t startNs_;
+};
+
+} // namespace core
+} // namespace glora
+
+#define GLORA_TRACE_CONCAT_INNER(a, b) a##b
+#define GLORA_TRACE_CONCAT(a, b) GLORA_TRACE_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing block; category and name must be literals
+#define GLORA_TRACE_SCOPE(category, name) \
+  ::glora::core::TraceScope GLORA_TRACE_CONCAT(gloraTraceScope_, __LINE__)(category, name)
@@ -1,4 +1,6 @@
 #include "Database.h"
+#include "../core/Metrics.h"
+#include "../core/Tracing.h"
 #include <iostream>
 #include <chrono>
 #include <sstream>
@@ -8,6 +10,50 @@
 namespace glora {
 namespace database {
 
+// Write-path instrumentation per table
+struct TableMetrics {
+  core::Counter& rows;
+  core::Histogram& commitMs;
+};
+
+static TableMetrics& tickTableMetrics() {
+  auto& registry = core::MetricsRegistry::getInstance();
+  static TableMetrics metrics{
+    registry.counter("glora_db_rows_written_total", "Rows written to SQLite", "table=\"ticks\""),
+    registry.histogram("glora_db_commit_ms", "Batch insert transaction duration",
+                       core::MetricsRegistry::latencyBucketsMs(), "table=\"ticks\""),
+  };
+  return metrics;
+}
+
+static TableMetrics& candleTableMetrics() {
+  auto& registry = core::MetricsRegistry::getInstance();
+  static TableMetrics metrics{
+    registry.counter("glora_db_rows_written_total", "Rows written to SQLite", "table=\"candles\""),
+    registry.histogram("glora_db_commit_ms", "Batch insert transaction duration",
+                       core::MetricsRegistry::latencyBucketsMs(), "table=\"candles\""),
+  };
+  return metrics;
+}
+
+// Key for ticks whose source carries no exchange ID. Kept negative and far
+// below the -rowid keys given to migrated legacy rows, so neither collides
+// with real aggTrade IDs.
+static int64_t syntheticTradeId(const core::Tick& tick) {
+  uint64_t h = 1469598103934665603ull;  // FNV-1a over the fields the old UNIQUE index used
+  auto mix = [&h](const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      h ^= bytes[i];
+      h *= 1099511628211ull;
+    }
+  };
+  mix(&tick.timestamp_ms, sizeof(tick.timestamp_ms));
+  mix(&tick.price, sizeof(tick.price));
+  mix(&tick.quantity, sizeof(tick.quantity));
+  return -static_cast<int64_t>((h >> 2) | (1ull << 61));
+}
+
 Database::Database() : db_(nullptr), dbPath_("") {}
 
 Database::~Database() {
@@ -28,17 +74,22 @@ bool Database::initialize(const std::string& dbPath) {
   execute("PRAGMA synchronous=NORMAL;");
   execute("PRAGMA cache_size=10000;");
   
+  // Ticks from before trade IDs were stored are rekeyed first
+  migrateLegacyTicks();
+  
   // Create tables
+  // Ticks are clustered by (symbol, trade_id): dedup is the primary key
+  // itself, and inserts in ID order append to the end of the B-tree
   const char* ticksTable = R"(
     CREATE TABLE IF NOT EXISTS ticks (
-      id INTEGER PRIMARY KEY AUTOINCREMENT,
       symbol TEXT NOT NULL,
+      trade_id INTEGER NOT NULL,
       timestamp_ms INTEGER NOT NULL,
       price REAL NOT NULL,
       quantity REAL NOT NULL,
       is_buyer_maker INTEGER NOT NULL,
-      UNIQUE(symbol, timestamp_ms, price, quantity)
-    );
+      PRIMARY KEY (symbol, trade_id)
+    ) WITHOUT ROWID;
     CREATE INDEX IF NOT EXISTS idx_ticks_symbol_time ON ticks(symbol, timestamp_ms);
   )";
   
@@ -139,13 +190,62 @@ bool Database::execute(const std::string& sql) const {
   return true;
 }
 
+void Database::migrateLegacyTicks() {
+  sqlite3* db = reinterpret_cast<sqlite3*>(db_);
+  sqlite3_stmt* stmt;
+  
+  // Old layout: AUTOINCREMENT id + UNIQUE(symbol, timestamp_ms, price, quantity)
+  const char* sql = "SELECT name FROM pragma_table_info('ticks')";
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return;
+  
+  bool exists = false;
+  bool hasTradeId = false;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    exists = true;
+    const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    if (name && std::strcmp(name, "trade_id") == 0) hasTradeId = true;
+  }
+  sqlite3_finalize(stmt);
+  
+  if (!exists || hasTradeId) return;
+  
+  std::cout << "[Database] Migrating ticks table to (symbol, trade_id) keys..." << std::endl;
+  
+  // Legacy rows have no exchange ID; their negated rowid keeps them unique
+  // and out of the way of ID gap detection
+  bool ok = execute(R"(
+    BEGIN TRANSACTION;
+    ALTER TABLE ticks RENAME TO ticks_legacy;
+    DROP INDEX IF EXISTS idx_ticks_symbol_time;
+    CREATE TABLE ticks (
+      symbol TEXT NOT NULL,
+      trade_id INTEGER NOT NULL,
+      timestamp_ms INTEGER NOT NULL,
+      price REAL NOT NULL,
+      quantity REAL NOT NULL,
+      is_buyer_maker INTEGER NOT NULL,
+      PRIMARY KEY (symbol, trade_id)
+    ) WITHOUT ROWID;
+    INSERT INTO ticks (symbol, trade_id, timestamp_ms, price, quantity, is_buyer_maker)
+      SELECT symbol, -id, timestamp_ms, price, quantity, is_buyer_maker FROM ticks_legacy;
+    DROP TABLE ticks_legacy;
+    COMMIT;
+  )");
+  
+  if (!ok) {
+    execute("ROLLBACK");
+    std::cerr << "[Database] Tick migration failed, keeping the legacy table" << std::endl;
+  }
+}
+
 bool Database::insertTicks(const std::string& symbol, const std::vector<core::Tick>& ticks) {
+  GLORA_TRACE_SCOPE("db", "insertTicks");
   if (ticks.empty() || !db_) return true;
   
   sqlite3_stmt* stmt;
   const char* sql = R"(
-    INSERT OR IGNORE INTO ticks (symbol, timestamp_ms, price, quantity, is_buyer_maker)
-    VALUES (?, ?, ?, ?, ?)
+    INSERT OR IGNORE INTO ticks (symbol, trade_id, timestamp_ms, price, quantity, is_buyer_maker)
+    VALUES (?, ?, ?, ?, ?, ?)
   )";
   
   // Validate SQLite handle before use
@@ -154,14 +254,19 @@ bool Database::insertTicks(const std::string& symbol, const std::vector<core::Ti
   int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
   if (rc != SQLITE_OK) return false;
   
+  auto& metrics = tickTableMetrics();
+  core::ScopedTimer commitTimer(metrics.commitMs);
+  metrics.rows.inc(ticks.size());
+  
   sqlite3_exec(reinterpret_cast<sqlite3*>(db_), "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
   
   for (const auto& tick : ticks) {
     sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, tick.timestamp_ms);
-    sqlite3_bind_double(stmt, 3, tick.price);
-    sqlite3_bind_double(stmt, 4, tick.quantity);
-    sqlite3_bind_int(stmt, 5, tick.is_buyer_maker ? 1 : 0);
+    sqlite3_bind_int64(stmt, 2, tick.trade_id > 0 ? tick.trade_id : syntheticTradeId(tick));
+    sqlite3_bind_int64(stmt, 3, tick.timestamp_ms);
+    sqlite3_bind_double(stmt, 4, tick.price);
+    sqlite3_bind_double(stmt, 5, tick.quantity);
+    sqlite3_bind_int(stmt, 6, tick.is_buyer_maker ? 1 : 0);
     sqlite3_step(stmt);
     sqlite3_reset(stmt);
   }
@@ -172,19 +277,20 @@ bool Database::insertTicks(const std::string& symbol, const std::vector<core::Ti
   return true;
 }
 
-std::vector<core::Tick> Database::getTicks(const std::string& symbol, uint64_t startTime, uint64_t endTime) const {
-  std::vector<core::Tick> ticks;
-  
+// Shared by the std:: and pmr getTicks overloads
+template <typename TickContainer>
+static void readTicks(sqlite3* db, const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                      TickContainer& ticks) {
   sqlite3_stmt* stmt;
   const char* sql = R"(
-    SELECT timestamp_ms, price, quantity, is_buyer_maker
+    SELECT timestamp_ms, price, quantity, is_buyer_maker, trade_id
     FROM ticks
     WHERE symbol = ? AND timestamp_ms >= ? AND timestamp_ms <= ?
-    ORDER BY timestamp_ms ASC
+    ORDER BY timestamp_ms ASC, trade_id ASC
   )";
   
-  int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) return ticks;
+  int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) return;
   
   sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_int64(stmt, 2, startTime);
@@ -196,13 +302,70 @@ std::vector<core::Tick> Database::getTicks(const std::string& symbol, uint64_t s
     tick.price = sqlite3_column_double(stmt, 1);
     tick.quantity = sqlite3_column_double(stmt, 2);
     tick.is_buyer_maker = sqlite3_column_int(stmt, 3) == 1;
+    int64_t tradeId = sqlite3_column_int64(stmt, 4);
+    tick.trade_id = tradeId > 0 ? tradeId : 0;  // Negative keys are synthetic
     ticks.push_back(tick);
   }
   
   sqlite3_finalize(stmt);
+}
+
+size_t Database::getTickPage(const std::string& symbol, TickCursor& cursor, uint64_t endTime, size_t limit,
+                             std::vector<core::Tick>& out) const {
+  GLORA_TRACE_SCOPE("db", "getTickPage");
+  if (!db_ || limit == 0) return 0;
+  
+  // Row-value comparison walks idx_ticks_symbol_time from the cursor
+  sqlite3_stmt* stmt;
+  const char* sql = R"(
+    SELECT timestamp_ms, price, quantity, is_buyer_maker, trade_id
+    FROM ticks
+    WHERE symbol = ? AND timestamp_ms <= ? AND (timestamp_ms, trade_id) >= (?, ?)
+    ORDER BY timestamp_ms ASC, trade_id ASC
+    LIMIT ?
+  )";
+  
+  int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) return 0;
+  
+  sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(stmt, 2, endTime);
+  sqlite3_bind_int64(stmt, 3, cursor.timestamp_ms);
+  sqlite3_bind_int64(stmt, 4, cursor.key);
+  sqlite3_bind_int64(stmt, 5, static_cast<int64_t>(limit));
+  
+  size_t count = 0;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    core::Tick tick;
+    tick.timestamp_ms = sqlite3_column_int64(stmt, 0);
+    tick.price = sqlite3_column_double(stmt, 1);
+    tick.quantity = sqlite3_column_double(stmt, 2);
+    tick.is_buyer_maker = sqlite3_column_int(stmt, 3) == 1;
+    tick.trade_id = sqlite3_column_int64(stmt, 4);
+    out.push_back(tick);
+    ++count;
+  }
+  sqlite3_finalize(stmt);
+  
+  if (count > 0) {
+    cursor.timestamp_ms = out.back().timestamp_ms;
+    cursor.key = out.back().trade_id + 1;
+  }
+  return count;
+}
+
+std::vector<core::Tick> Database::getTicks(const std::string& symbol, uint64_t startTime, uint64_t endTime) const {
+  std::vector<core::Tick> ticks;
+  readTicks(reinterpret_cast<sqlite3*>(db_), symbol, startTime, endTime, ticks);
   return ticks;
 }
 
+void Database::getTicks(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                        std::pmr::vector<core::Tick>& out) const {
+  GLORA_TRACE_SCOPE("db", "getTicks");
+  readTicks(reinterpret_cast<sqlite3*>(db_), symbol, startTime, endTime, out);
+}
+
 std::optional<uint64_t> Database::getLatestTickTime(const std::string& symbol) const {
   sqlite3_stmt* stmt;
   const char* sql = "SELECT MAX(timestamp_ms) FROM ticks WHERE symbol = ?";
@@ -222,6 +385,24 @@ std::optional<uint64_t> Database::getLatestTickTime(const std::string& symbol) c
   return std::nullopt;
 }
 
+std::optional<int64_t> Database::getLatestTradeId(const std::string& symbol) const {
+  sqlite3_stmt* stmt;
+  const char* sql = "SELECT MAX(trade_id) FROM ticks WHERE symbol = ? AND trade_id > 0";
+  
+  int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) return std::nullopt;
+  
+  sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
+  
+  std::optional<int64_t> result;
+  if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+    result = sqlite3_column_int64(stmt, 0);
+  }
+  
+  sqlite3_finalize(stmt);
+  return result;
+}
+
 std::optional<uint64_t> Database::getEarliestTickTime(const std::string& symbol) const {
   sqlite3_stmt* stmt;
   const char* sql = "SELECT MIN(timestamp_ms) FROM ticks WHERE symbol = ?";
@@ -242,6 +423,7 @@ std::optional<uint64_t> Database::getEarliestTickTime(const std::string& symbol)
 }
 
 bool Database::insertCandles(const std::string& symbol, const std::vector<core::Candle>& candles) {
+  GLORA_TRACE_SCOPE("db", "insertCandles");
   if (candles.empty() || !db_) return true;
   
   sqlite3_stmt* stmt;
@@ -254,6 +436,10 @@ bool Database::insertCandles(const std::string& symbol, const std::vector<core::
   int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
   if (rc != SQLITE_OK) return false;
   
+  auto& metrics = candleTableMetrics();
+  core::ScopedTimer commitTimer(metrics.commitMs);
+  metrics.rows.inc(candles.size());
+  
   sqlite3_exec(reinterpret_cast<sqlite3*>(db_), "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
   
   for (const auto& candle : candles) {
@@ -276,6 +462,7 @@ bool Database::insertCandles(const std::string& symbol, const std::vector<core::
 }
 
 std::vector<core::Candle> Database::getCandles(const std::string& symbol, uint64_t startTime, uint64_t endTime) const {
+  GLORA_TRACE_SCOPE("db", "getCandles");
   std::vector<core::Candle> candles;
   
   sqlite3_stmt* stmt;
@@ -310,6 +497,7 @@ std::vector<core::Candle> Database::getCandles(const std::string& symbol, uint64
 }
 
 std::vector<DataGap> Database::detectGaps(const std::string& symbol, uint64_t startTime, uint64_t endTime, uint64_t maxGapMs) const {
+  GLORA_TRACE_SCOPE("db", "detectGaps");
   std::vector<DataGap> gaps;
   
   // Get all timestamps in range
@@ -354,6 +542,69 @@ std::vector<DataGap> Database::detectGaps(const std::string& symbol, uint64_t st
   return gaps;
 }
 
+std::vector<DataGap> Database::detectIdGaps(const std::string& symbol, uint64_t startTime, uint64_t endTime) const {
+  GLORA_TRACE_SCOPE("db", "detectIdGaps");
+  std::vector<DataGap> gaps;
+  
+  // Walk the primary key in order; the time index only narrows the range.
+  // Only jumps are returned, so the result is small even for a week of ticks.
+  sqlite3_stmt* stmt;
+  const char* sql = R"(
+    SELECT prev_id, trade_id, prev_time, timestamp_ms FROM (
+      SELECT trade_id, timestamp_ms,
+             LAG(trade_id) OVER (ORDER BY trade_id) AS prev_id,
+             LAG(timestamp_ms) OVER (ORDER BY trade_id) AS prev_time
+      FROM ticks
+      WHERE symbol = ? AND trade_id > 0 AND timestamp_ms >= ? AND timestamp_ms <= ?
+    )
+    WHERE prev_id IS NOT NULL AND trade_id - prev_id > 1
+    ORDER BY trade_id
+  )";
+  
+  int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    std::cerr << "[Database] detectIdGaps: " << sqlite3_errmsg(reinterpret_cast<sqlite3*>(db_)) << std::endl;
+    return gaps;
+  }
+  
+  sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(stmt, 2, startTime);
+  sqlite3_bind_int64(stmt, 3, endTime);
+  
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    DataGap gap;
+    gap.symbol = symbol;
+    gap.firstMissingId = sqlite3_column_int64(stmt, 0) + 1;
+    gap.lastMissingId = sqlite3_column_int64(stmt, 1) - 1;
+    gap.startTime = sqlite3_column_int64(stmt, 2);
+    gap.endTime = sqlite3_column_int64(stmt, 3);
+    gaps.push_back(gap);
+  }
+  
+  sqlite3_finalize(stmt);
+  return gaps;
+}
+
+bool Database::hasTradeIds(const std::string& symbol, uint64_t startTime, uint64_t endTime) const {
+  sqlite3_stmt* stmt;
+  const char* sql = R"(
+    SELECT 1 FROM ticks
+    WHERE symbol = ? AND timestamp_ms >= ? AND timestamp_ms <= ? AND trade_id > 0
+    LIMIT 1
+  )";
+  
+  int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) return false;
+  
+  sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(stmt, 2, startTime);
+  sqlite3_bind_int64(stmt, 3, endTime);
+  
+  bool found = sqlite3_step(stmt) == SQLITE_ROW;
+  sqlite3_finalize(stmt);
+  return found;
+}
+
 bool Database::markGapFilled(const std::string& symbol, uint64_t startTime, uint64_t endTime) {
   const char* sql = R"(
     UPDATE gaps SET filled = 1 
@@ -543,6 +794,72 @@ bool Database::insertSymbols(const std::vector<core::Symbol>& symbols) {
   return true;
 }
 
+bool Database::applySymbolDiff(const core::SymbolDiff& diff) {
+  if (diff.empty()) return true;
+  if (!db_) return false;
+  sqlite3* db = reinterpret_cast<sqlite3*>(db_);
+  
+  // Upsert rather than INSERT OR REPLACE so the price columns survive
+  sqlite3_stmt* upsert;
+  const char* upsertSql = R"(
+    INSERT INTO symbols 
+    (symbol, base_asset, quote_asset, status, permissions, 
+     min_price, max_price, tick_size, min_qty, max_qty, step_size, min_notional,
+     last_update_time)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, strftime('%s', 'now'))
+    ON CONFLICT(symbol) DO UPDATE SET
+      base_asset = excluded.base_asset, quote_asset = excluded.quote_asset,
+      status = excluded.status, permissions = excluded.permissions,
+      min_price = excluded.min_price, max_price = excluded.max_price, tick_size = excluded.tick_size,
+      min_qty = excluded.min_qty, max_qty = excluded.max_qty, step_size = excluded.step_size,
+      min_notional = excluded.min_notional, last_update_time = excluded.last_update_time
+  )";
+  if (sqlite3_prepare_v2(db, upsertSql, -1, &upsert, nullptr) != SQLITE_OK) return false;
+  
+  sqlite3_stmt* remove;
+  if (sqlite3_prepare_v2(db, "DELETE FROM symbols WHERE symbol = ?", -1, &remove, nullptr) != SQLITE_OK) {
+    sqlite3_finalize(upsert);
+    return false;
+  }
+  
+  bool ok = true;
+  sqlite3_exec(db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+  
+  auto write = [&](const core::Symbol& symbol) {
+    sqlite3_bind_text(upsert, 1, symbol.symbol.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(upsert, 2, symbol.baseAsset.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(upsert, 3, symbol.quoteAsset.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(upsert, 4, symbol.status.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(upsert, 5, symbol.permissions.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(upsert, 6, symbol.minPrice);
+    sqlite3_bind_double(upsert, 7, symbol.maxPrice);
+    sqlite3_bind_double(upsert, 8, symbol.tickSize);
+    sqlite3_bind_double(upsert, 9, symbol.minQty);
+    sqlite3_bind_double(upsert, 10, symbol.maxQty);
+    sqlite3_bind_double(upsert, 11, symbol.stepSize);
+    sqlite3_bind_double(upsert, 12, symbol.minNotional);
+    ok = ok && sqlite3_step(upsert) == SQLITE_DONE;
+    sqlite3_reset(upsert);
+  };
+  for (const auto& symbol : diff.added) write(symbol);
+  for (const auto& symbol : diff.changed) write(symbol);
+  
+  for (const auto& name : diff.removed) {
+    sqlite3_bind_text(remove, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    ok = ok && sqlite3_step(remove) == SQLITE_DONE;
+    sqlite3_reset(remove);
+  }
+  
+  sqlite3_exec(db, ok ? "COMMIT" : "ROLLBACK", nullptr, nullptr, nullptr);
+  sqlite3_finalize(upsert);
+  sqlite3_finalize(remove);
+  
+  if (!ok) {
+    std::cerr << "[Database] Failed to apply symbol changes: " << sqlite3_errmsg(db) << std::endl;
+  }
+  return ok;
+}
+
 std::vector<core::Symbol> Database::getAllSymbols() const {
   std::vector<core::Symbol> symbols;
   
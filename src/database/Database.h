@@ -3,8 +3,10 @@
 #include "../core/DataModels.h"
 #include <string>
 #include <vector>
+#include <memory_resource>
 #include <optional>
 #include <cstdint>
+#include <limits>
 
 namespace glora {
 namespace database {
@@ -14,6 +16,15 @@ struct DataGap {
   std::string symbol;
   uint64_t startTime;
   uint64_t endTime;
+  int64_t firstMissingId = 0;  // ID gaps only: first and last trade ID not stored
+  int64_t lastMissingId = 0;
+};
+
+// Position in a symbol's ticks for keyset paging: storage order is time,
+// then trade_id key
+struct TickCursor {
+  uint64_t timestamp_ms = 0;
+  int64_t key = std::numeric_limits<int64_t>::min();
 };
 
 class Database {
@@ -37,12 +48,25 @@ public:
                                     uint64_t startTime, 
                                     uint64_t endTime) const;
   
+  // Get ticks within time range into caller-owned storage (e.g. a request arena)
+  void getTicks(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                std::pmr::vector<core::Tick>& out) const;
+  
+  // Append up to `limit` ticks from `cursor` to endTime (inclusive) in
+  // storage order and move the cursor past them. trade_id is the storage
+  // key here, negative for ticks stored without an exchange ID.
+  size_t getTickPage(const std::string& symbol, TickCursor& cursor, uint64_t endTime, size_t limit,
+                     std::vector<core::Tick>& out) const;
+  
   // Get latest tick time for a symbol
   std::optional<uint64_t> getLatestTickTime(const std::string& symbol) const;
   
   // Get earliest tick time for a symbol
   std::optional<uint64_t> getEarliestTickTime(const std::string& symbol) const;
   
+  // Highest stored exchange trade ID for a symbol
+  std::optional<int64_t> getLatestTradeId(const std::string& symbol) const;
+  
   // === Candle Data Operations ===
   
   // Insert candles
@@ -61,6 +85,16 @@ public:
                                    uint64_t endTime,
                                    uint64_t maxGapMs = 60000) const; // Default 1 minute gap
   
+  // Detect missing trade IDs between stored ticks in a time range. Exact, and
+  // needs no threshold: consecutive aggTrades have consecutive IDs.
+  std::vector<DataGap> detectIdGaps(const std::string& symbol,
+                                     uint64_t startTime,
+                                     uint64_t endTime) const;
+  
+  // True if any tick in the range carries an exchange trade ID (rows from
+  // before IDs were stored don't)
+  bool hasTradeIds(const std::string& symbol, uint64_t startTime, uint64_t endTime) const;
+  
   // Mark gap as being filled
   bool markGapFilled(const std::string& symbol, uint64_t startTime, uint64_t endTime);
   
@@ -94,6 +128,10 @@ public:
   // Insert multiple symbols (bulk)
   bool insertSymbols(const std::vector<core::Symbol>& symbols);
   
+  // Apply a registry diff in one transaction: upsert added and changed
+  // metadata (keeping stored prices), delete removed symbols
+  bool applySymbolDiff(const core::SymbolDiff& diff);
+  
   // Get all symbols
   std::vector<core::Symbol> getAllSymbols() const;
   
@@ -120,6 +158,7 @@ private:
   
   // Internal helpers
   bool execute(const std::string& sql) const;
+  void migrateLegacyTicks();
   std::string getTickInsertSql() const;
   std::string getCandleInsertSql() const;
 };
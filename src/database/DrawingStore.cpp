@@ -0,0 +1,485 @@
+#include "DrawingStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace glora {
+namespace database {
+
+namespace {
+
+constexpr uint8_t kOpPut = 1;
+constexpr uint8_t kOpDelete = 2;
+
+#pragma pack(push, 1)
+struct FileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint64_t indexOffset;   // 0 until the first compaction
+  uint64_t indexedEnd;    // End of the index block; the tail starts here
+};
+
+struct RecordHeader {
+  uint8_t op;
+  uint8_t reserved;
+  uint16_t symbolLength;
+  uint16_t layerLength;
+  uint16_t idLength;
+  uint32_t dataLength;
+  uint64_t startTime;
+  uint64_t endTime;
+};
+
+struct IndexEntryHeader {
+  uint16_t symbolLength;
+  uint16_t layerLength;
+  uint16_t idLength;
+  uint32_t dataLength;
+  uint64_t startTime;
+  uint64_t endTime;
+  uint64_t offset;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader must be 24 bytes");
+static_assert(sizeof(RecordHeader) == 28, "RecordHeader must be 28 bytes");
+static_assert(sizeof(IndexEntryHeader) == 34, "IndexEntryHeader must be 34 bytes");
+
+template <typename T>
+bool readPod(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+void appendPod(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool readString(std::istream& in, size_t length, std::string& out) {
+  out.resize(length);
+  return length == 0 || static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(length)));
+}
+
+uint64_t recordBytes(const std::string& symbol, const std::string& layer, const std::string& id,
+                     uint32_t dataLength) {
+  return sizeof(RecordHeader) + symbol.size() + layer.size() + id.size() + dataLength;
+}
+
+bool fitsRecord(const std::string& symbol, const std::string& layer, const std::string& id,
+                const std::string& data) {
+  constexpr size_t kMaxName = std::numeric_limits<uint16_t>::max();
+  return symbol.size() <= kMaxName && layer.size() <= kMaxName && id.size() <= kMaxName &&
+         data.size() <= std::numeric_limits<uint32_t>::max();
+}
+
+} // namespace
+
+DrawingStore::~DrawingStore() {
+  close();
+}
+
+bool DrawingStore::open(const std::string& path) {
+  close();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto openStart = std::chrono::steady_clock::now();
+
+  std::error_code ec;
+  uint64_t size = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+  if (size == 0) {
+    std::ofstream create(path, std::ios::binary | std::ios::trunc);
+    FileHeader header{kMagic, kVersion, 0, 0, sizeof(FileHeader)};
+    create.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!create) {
+      std::cerr << "[DrawingStore] Cannot create " << path << std::endl;
+      return false;
+    }
+    size = sizeof(FileHeader);
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  FileHeader header{};
+  if (!in || !readPod(in, header) || header.magic != kMagic) {
+    std::cerr << "[DrawingStore] " << path << " is not a drawing store" << std::endl;
+    return false;
+  }
+  if (header.version > kVersion) {
+    std::cerr << "[DrawingStore] " << path << " is version " << header.version
+              << ", newer than this build (" << kVersion << ")" << std::endl;
+    return false;
+  }
+  if (header.indexedEnd < sizeof(FileHeader) || header.indexedEnd > size ||
+      (header.indexOffset != 0 && !readIndex(in, header.indexOffset, header.indexedEnd))) {
+    std::cerr << "[DrawingStore] Corrupt index in " << path << std::endl;
+    symbols_.clear();
+    liveBytes_ = 0;
+    return false;
+  }
+
+  uint64_t validEnd = header.indexedEnd;
+  scanRecords(in, header.indexedEnd, size, validEnd);
+  in.close();
+  if (validEnd < size) {
+    std::cerr << "[DrawingStore] Dropping " << (size - validEnd) << " bytes of torn records" << std::endl;
+    std::filesystem::resize_file(path, validEnd, ec);
+  }
+
+  path_ = path;
+  fileSize_ = validEnd;
+  reader_.open(path_, std::ios::binary);
+  writer_.open(path_, std::ios::binary | std::ios::app);
+  if (!reader_ || !writer_) {
+    std::cerr << "[DrawingStore] Cannot open " << path_ << " for writing" << std::endl;
+    return false;
+  }
+
+  size_t drawings = 0;
+  for (const auto& [symbol, layers] : symbols_) {
+    for (const auto& [name, entries] : layers) {
+      drawings += entries.size();
+    }
+  }
+  auto openUs = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - openStart).count();
+  std::cout << "[DrawingStore] Opened " << path_ << ": " << drawings << " drawings for "
+            << symbols_.size() << " symbols in " << openUs << " us" << std::endl;
+  return true;
+}
+
+void DrawingStore::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (reader_.is_open()) reader_.close();
+  if (writer_.is_open()) writer_.close();
+  symbols_.clear();
+  fileSize_ = 0;
+  liveBytes_ = 0;
+}
+
+bool DrawingStore::readIndex(std::ifstream& in, uint64_t offset, uint64_t end) {
+  in.clear();
+  in.seekg(static_cast<std::streamoff>(offset));
+  uint32_t count = 0;
+  if (!readPod(in, count)) return false;
+
+  std::string symbol, layer, id;
+  for (uint32_t i = 0; i < count; ++i) {
+    IndexEntryHeader header{};
+    if (!readPod(in, header) || !readString(in, header.symbolLength, symbol) ||
+        !readString(in, header.layerLength, layer) || !readString(in, header.idLength, id)) {
+      return false;
+    }
+    if (header.offset + header.dataLength > offset) return false;  // Sections precede the index
+    apply(kOpPut, symbol, layer, id, {header.startTime, header.endTime, header.offset, header.dataLength});
+  }
+  return static_cast<uint64_t>(in.tellg()) <= end;
+}
+
+bool DrawingStore::scanRecords(std::ifstream& in, uint64_t offset, uint64_t end, uint64_t& validEnd) {
+  in.clear();
+  in.seekg(static_cast<std::streamoff>(offset));
+  uint64_t position = offset;
+  std::string symbol, layer, id;
+  while (position + sizeof(RecordHeader) <= end) {
+    RecordHeader header{};
+    if (!readPod(in, header)) break;
+    if (header.op != kOpPut && header.op != kOpDelete) break;
+    uint64_t names = static_cast<uint64_t>(header.symbolLength) + header.layerLength + header.idLength;
+    uint64_t total = sizeof(RecordHeader) + names + header.dataLength;
+    if (position + total > end) break;
+    if (!readString(in, header.symbolLength, symbol) || !readString(in, header.layerLength, layer) ||
+        !readString(in, header.idLength, id)) {
+      break;
+    }
+
+    // Payloads stay on disk until a window asks for them
+    uint64_t payload = position + sizeof(RecordHeader) + names;
+    apply(header.op, symbol, layer, id, {header.startTime, header.endTime, payload, header.dataLength});
+    position += total;
+    in.ignore(static_cast<std::streamsize>(header.dataLength));  // Stays in the read buffer, unlike seekg
+  }
+  validEnd = position;
+  return position == end;
+}
+
+void DrawingStore::apply(uint8_t op, const std::string& symbol, const std::string& layer,
+                         const std::string& id, const Entry& entry) {
+  auto& layers = symbols_[symbol];
+
+  // An id is unique per symbol, whichever layer it was on
+  for (auto it = layers.begin(); it != layers.end();) {
+    auto found = it->second.find(id);
+    if (found != it->second.end()) {
+      liveBytes_ -= recordBytes(symbol, it->first, id, found->second.length);
+      it->second.erase(found);
+    }
+    it = it->second.empty() ? layers.erase(it) : std::next(it);
+  }
+
+  if (op == kOpPut) {
+    layers[layer][id] = entry;
+    liveBytes_ += recordBytes(symbol, layer, id, entry.length);
+  }
+  if (layers.empty()) {
+    symbols_.erase(symbol);
+  }
+}
+
+bool DrawingStore::append(uint8_t op, const std::string& symbol, const DrawingRecord& drawing) {
+  if (!writer_.is_open()) return false;
+  const std::string& data = op == kOpPut ? drawing.data : std::string();
+  if (!fitsRecord(symbol, drawing.layer, drawing.id, data)) return false;
+
+  RecordHeader header{};
+  header.op = op;
+  header.symbolLength = static_cast<uint16_t>(symbol.size());
+  header.layerLength = static_cast<uint16_t>(drawing.layer.size());
+  header.idLength = static_cast<uint16_t>(drawing.id.size());
+  header.dataLength = static_cast<uint32_t>(data.size());
+  header.startTime = drawing.startTime;
+  header.endTime = drawing.endTime;
+
+  std::string record;
+  record.reserve(recordBytes(symbol, drawing.layer, drawing.id, header.dataLength));
+  appendPod(record, header);
+  record += symbol;
+  record += drawing.layer;
+  record += drawing.id;
+  uint64_t payload = fileSize_ + record.size();
+  record += data;
+
+  writer_.write(record.data(), static_cast<std::streamsize>(record.size()));
+  writer_.flush();
+  if (!writer_) {
+    std::cerr << "[DrawingStore] Write failed for " << path_ << std::endl;
+    writer_.clear();
+    return false;
+  }
+  fileSize_ += record.size();
+  apply(op, symbol, drawing.layer, drawing.id, {drawing.startTime, drawing.endTime, payload, header.dataLength});
+  return true;
+}
+
+bool DrawingStore::put(const std::string& symbol, const DrawingRecord& drawing) {
+  if (symbol.empty() || drawing.id.empty() || drawing.layer.empty() || drawing.startTime > drawing.endTime) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!append(kOpPut, symbol, drawing)) return false;
+  maybeCompact();
+  return true;
+}
+
+bool DrawingStore::remove(const std::string& symbol, const std::string& id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) return false;
+  for (const auto& [layer, entries] : it->second) {
+    auto found = entries.find(id);
+    if (found == entries.end()) continue;
+    DrawingRecord tombstone;
+    tombstone.id = id;
+    tombstone.layer = layer;
+    tombstone.startTime = found->second.startTime;
+    tombstone.endTime = found->second.endTime;
+    if (!append(kOpDelete, symbol, tombstone)) return false;
+    maybeCompact();
+    return true;
+  }
+  return false;
+}
+
+std::vector<DrawingRecord> DrawingStore::load(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                              const std::string& layer) const {
+  std::vector<DrawingRecord> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end() || !reader_.is_open()) return result;
+
+  std::vector<const Entry*> entries;
+  std::vector<std::pair<const std::string*, const Entry*>> matches;
+  for (const auto& [name, layerEntries] : it->second) {
+    if (!layer.empty() && name != layer) continue;
+    matches.clear();
+    for (const auto& [id, entry] : layerEntries) {
+      if (entry.startTime <= endTime && entry.endTime >= startTime) {
+        matches.emplace_back(&id, &entry);
+      }
+    }
+
+    // Within a layer by start time, ties by id
+    std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+      return a.second->startTime < b.second->startTime;
+    });
+    for (const auto& [id, entry] : matches) {
+      DrawingRecord record;
+      record.id = *id;
+      record.layer = name;
+      record.startTime = entry->startTime;
+      record.endTime = entry->endTime;
+      result.push_back(std::move(record));
+      entries.push_back(entry);
+    }
+  }
+
+  // Payloads in file order: compacted sections make this one forward pass
+  std::vector<size_t> reads(result.size());
+  for (size_t i = 0; i < reads.size(); ++i) reads[i] = i;
+  std::sort(reads.begin(), reads.end(), [&entries](size_t a, size_t b) {
+    return entries[a]->offset < entries[b]->offset;
+  });
+  reader_.clear();
+  for (size_t index : reads) {
+    const Entry& entry = *entries[index];
+    reader_.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!readString(reader_, entry.length, result[index].data)) {
+      std::cerr << "[DrawingStore] Short read at " << entry.offset << " in " << path_ << std::endl;
+      reader_.clear();
+      result[index].data.clear();
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> DrawingStore::layers(const std::string& symbol) const {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) return result;
+  for (const auto& [name, entries] : it->second) {
+    result.push_back(name);
+  }
+  return result;
+}
+
+size_t DrawingStore::count(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) return 0;
+  size_t total = 0;
+  for (const auto& [name, entries] : it->second) {
+    total += entries.size();
+  }
+  return total;
+}
+
+bool DrawingStore::compact() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return compactLocked();
+}
+
+void DrawingStore::maybeCompact() {
+  uint64_t dead = fileSize_ > liveBytes_ ? fileSize_ - liveBytes_ : 0;
+  if (dead >= kCompactMinBytes && dead > liveBytes_) {
+    compactLocked();
+  }
+}
+
+bool DrawingStore::compactLocked() {
+  if (!reader_.is_open()) return false;
+  auto compactStart = std::chrono::steady_clock::now();
+  std::string tempPath = path_ + ".compact";
+  std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+  FileHeader header{kMagic, kVersion, 0, 0, 0};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // Sections: symbol, then layer, then start time
+  std::map<std::string, Symbol> compacted;
+  uint64_t position = sizeof(FileHeader);
+  std::string data;
+  reader_.clear();
+  for (const auto& [symbol, layers] : symbols_) {
+    for (const auto& [layer, entries] : layers) {
+      std::vector<std::pair<const std::string*, const Entry*>> ordered;
+      for (const auto& [id, entry] : entries) {
+        ordered.emplace_back(&id, &entry);
+      }
+      std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+        return a.second->startTime < b.second->startTime;
+      });
+
+      for (const auto& [id, entry] : ordered) {
+        reader_.seekg(static_cast<std::streamoff>(entry->offset));
+        if (!readString(reader_, entry->length, data)) {
+          std::cerr << "[DrawingStore] Compaction aborted: short read in " << path_ << std::endl;
+          reader_.clear();
+          out.close();
+          std::error_code ec;
+          std::filesystem::remove(tempPath, ec);
+          return false;
+        }
+        RecordHeader record{kOpPut, 0, static_cast<uint16_t>(symbol.size()), static_cast<uint16_t>(layer.size()),
+                            static_cast<uint16_t>(id->size()), entry->length, entry->startTime, entry->endTime};
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        out << symbol << layer << *id;
+        position += sizeof(record) + symbol.size() + layer.size() + id->size();
+        compacted[symbol][layer][*id] = {entry->startTime, entry->endTime, position, entry->length};
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        position += data.size();
+      }
+    }
+  }
+
+  // Index after the sections
+  header.indexOffset = position;
+  uint32_t count = 0;
+  for (const auto& [symbol, layers] : compacted) {
+    for (const auto& [layer, entries] : layers) {
+      count += static_cast<uint32_t>(entries.size());
+    }
+  }
+  std::string index;
+  appendPod(index, count);
+  for (const auto& [symbol, layers] : compacted) {
+    for (const auto& [layer, entries] : layers) {
+      for (const auto& [id, entry] : entries) {
+        IndexEntryHeader indexEntry{static_cast<uint16_t>(symbol.size()), static_cast<uint16_t>(layer.size()),
+                                    static_cast<uint16_t>(id.size()), entry.length, entry.startTime,
+                                    entry.endTime, entry.offset};
+        appendPod(index, indexEntry);
+        index += symbol;
+        index += layer;
+        index += id;
+      }
+    }
+  }
+  out.write(index.data(), static_cast<std::streamsize>(index.size()));
+  header.indexedEnd = position + index.size();
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+  if (!out) {
+    std::cerr << "[DrawingStore] Compaction failed writing " << tempPath << std::endl;
+    std::error_code ec;
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  uint64_t before = fileSize_;
+  reader_.close();
+  writer_.close();
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path_, ec);
+  if (!ec) {
+    symbols_ = std::move(compacted);
+    fileSize_ = header.indexedEnd;
+  }
+  reader_.open(path_, std::ios::binary);
+  writer_.open(path_, std::ios::binary | std::ios::app);
+  if (ec) {
+    std::cerr << "[DrawingStore] Compaction failed replacing " << path_ << ": " << ec.message() << std::endl;
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  auto compactMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - compactStart).count();
+  std::cout << "[DrawingStore] Compacted " << path_ << " from " << before << " to " << fileSize_
+            << " bytes in " << compactMs << " ms" << std::endl;
+  return true;
+}
+
+} // namespace database
+} // namespace glora
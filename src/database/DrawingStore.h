@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace glora {
+namespace database {
+
+// One chart drawing as the frontend saves it. `data` is the drawing's own
+// encoding (the frontend's JSON), stored opaquely.
+struct DrawingRecord {
+  std::string id;
+  std::string layer = "Default";
+  uint64_t startTime = 0;                                      // Time span the drawing covers,
+  uint64_t endTime = std::numeric_limits<uint64_t>::max();     // for window queries
+  std::string data;
+};
+
+// Binary, versioned drawing/workspace store.
+//
+// File layout ("GLDW", little endian):
+//   FileHeader   magic, version, indexOffset, indexedEnd
+//   sections     live records grouped by symbol, then layer, then start time
+//   index        one entry per live record: symbol, layer, id, span, offset
+//   tail         records appended since the index was written
+//
+// Every save or delete is one record appended to the tail, so saving never
+// rewrites other drawings. Opening reads the index block and scans only the
+// tail's record headers (payloads are skipped), building an in-memory index
+// of symbol -> layer -> id. Loading a symbol's drawings for a time window
+// reads just the overlapping payloads, in file order. When dead records
+// outweigh live ones the file is compacted: live records are rewritten into
+// sections with a fresh index, and the new file replaces the old one.
+//
+// A torn record at the end (crash mid-append) is cut off on open.
+class DrawingStore {
+public:
+  static constexpr uint32_t kMagic = 0x57444C47;  // "GLDW"
+  static constexpr uint16_t kVersion = 1;
+  static constexpr uint64_t kCompactMinBytes = 1 << 20;
+
+  DrawingStore() = default;
+  ~DrawingStore();
+
+  DrawingStore(const DrawingStore&) = delete;
+  DrawingStore& operator=(const DrawingStore&) = delete;
+
+  // Open or create the store; false when the file is unreadable or from a
+  // newer version (it is left untouched)
+  bool open(const std::string& path);
+  void close();
+
+  // Insert or replace a drawing (moving it between layers if the layer changed)
+  bool put(const std::string& symbol, const DrawingRecord& drawing);
+  bool remove(const std::string& symbol, const std::string& id);
+
+  // Drawings of `symbol` overlapping [startTime, endTime], optionally only
+  // from one layer, ordered by layer then start time
+  std::vector<DrawingRecord> load(const std::string& symbol, uint64_t startTime = 0,
+                                  uint64_t endTime = std::numeric_limits<uint64_t>::max(),
+                                  const std::string& layer = "") const;
+
+  std::vector<std::string> layers(const std::string& symbol) const;
+  size_t count(const std::string& symbol) const;
+
+  // Rewrite live records into sections with a fresh index
+  bool compact();
+
+private:
+  struct Entry {
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+    uint64_t offset = 0;   // Payload position in the file
+    uint32_t length = 0;
+  };
+  using Layer = std::map<std::string, Entry>;       // By id
+  using Symbol = std::map<std::string, Layer>;      // By layer
+
+  bool readIndex(std::ifstream& in, uint64_t offset, uint64_t end);
+  bool scanRecords(std::ifstream& in, uint64_t offset, uint64_t end, uint64_t& validEnd);
+  void apply(uint8_t op, const std::string& symbol, const std::string& layer, const std::string& id,
+             const Entry& entry);
+  bool append(uint8_t op, const std::string& symbol, const DrawingRecord& drawing);
+  void maybeCompact();
+  bool compactLocked();
+
+  std::string path_;
+  mutable std::mutex mutex_;
+  mutable std::ifstream reader_;
+  std::ofstream writer_;
+  uint64_t fileSize_ = 0;
+  uint64_t liveBytes_ = 0;   // Payload and header bytes of live records
+  std::map<std::string, Symbol> symbols_;
+};
+
+} // namespace database
+} // namespace glora
@@ -4,18 +4,43 @@
 #include <memory>
 #include <atomic>
 #include <csignal>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
 
 #include "core/DataModels.h"
 #include "core/ThreadSafeQueue.h"
+#include "core/MemoryArena.h"
+#include "core/ThreadAffinity.h"
+#include "core/Metrics.h"
+#include "core/OverloadController.h"
+#include "core/Tracing.h"
 #include "database/Database.h"
 #include "network/BinanceClient.h"
 #include "network/WebSocketServer.h"
 #include "network/ApiHandler.h"
+#include "network/JsonWriter.h"
+#include "network/MetricsServer.h"
 #include "settings/Settings.h"
+#include "settings/SettingsManager.h"
 #include "render/MainWindow.h"
 
 using namespace glora::settings;
 
+namespace {
+
+// A live trade as queued by the feed thread (or a joined synthetic tick).
+// Overload lag is how long it waited for the processing thread, measured on
+// the local clock, so feed transit time and exchange clock skew don't count
+// as falling behind.
+struct QueuedTick {
+  std::string symbol;
+  glora::core::Tick tick;
+  std::chrono::steady_clock::time_point enqueued;
+};
+
+} // namespace
+
 int main(int argc, char *argv[]) {
   std::cout << "Starting Glora Charting App..." << std::endl;
 
@@ -26,6 +51,19 @@ int main(int argc, char *argv[]) {
   settings.historyDuration = glora::settings::HistoryDuration::LAST_7_DAYS;
   settings.customDays = 7;
 
+  // 1a. Thread topology from settings.json (must be set before threads start)
+  auto& settingsManager = glora::settings::SettingsManager::getInstance();
+  settingsManager.load();
+  settings.threads = settingsManager.getSettings().threads;
+  settings.metricsEnabled = settingsManager.getSettings().metricsEnabled;
+  settings.metricsPort = settingsManager.getSettings().metricsPort;
+  glora::core::setThreadTopology(settings.threads);
+
+  // 1b. GLORA_TRACE=1 traces startup; a stopTrace message writes it out
+  if (std::getenv("GLORA_TRACE")) {
+    glora::core::Tracer::getInstance().start();
+  }
+
   // 2. Initialize Database
   auto database = std::make_shared<glora::database::Database>();
   if (!database->initialize("glora_data.db")) {
@@ -49,12 +87,25 @@ int main(int argc, char *argv[]) {
   }
   std::cout << "WebSocket Server started on port 8080" << std::endl;
 
+  // 4a. Metrics endpoint for Prometheus scrapes (non-fatal if the port is taken)
+  std::unique_ptr<glora::network::MetricsServer> metricsServer;
+  if (settings.metricsEnabled) {
+    metricsServer = std::make_unique<glora::network::MetricsServer>(settings.metricsPort);
+    if (metricsServer->start()) {
+      std::cout << "Metrics available at http://127.0.0.1:" << settings.metricsPort << "/metrics" << std::endl;
+    }
+  }
+
   // 5. Initialize Data Manager
   auto dataManager = std::make_shared<glora::core::DataManager>();
   dataManager->initialize(settings);
   dataManager->setNetworkClient(binanceClient);
   dataManager->setDatabase(database);
   
+  // Symbol registry: the stored copy now, exchange changes in the background
+  dataManager->loadSymbols();
+  dataManager->startSymbolRefresh();
+  
   // 5a. Load initial data and detect/fill gaps on startup
   std::cout << "[Main] Loading initial data and detecting gaps..." << std::endl;
   dataManager->loadSymbolData(settings.defaultSymbol);
@@ -87,55 +138,165 @@ int main(int argc, char *argv[]) {
   }
 
   // 8. Setup communication queue between Network and UI
-  glora::core::ThreadSafeQueue<glora::core::Tick> tickQueue;
+  glora::core::ThreadSafeQueue<QueuedTick> tickQueue;
+  auto& tickQueueDepth = glora::core::MetricsRegistry::getInstance().gauge(
+      "glora_tick_queue_depth", "Ticks waiting for the processing thread");
+
+  // 8a. Load shedding driven by the processing thread's lag
+  using OverloadController = glora::core::OverloadController;
+  auto& overload = OverloadController::getInstance();
+  std::chrono::steady_clock::time_point lastCandleBroadcast{};
+  uint64_t lastCandleSent = 0;
+
+  // CONFLATED tier: the newest trade of each kConflateInterval goes out when
+  // the interval ends, from the feed thread or else the processing thread
+  std::mutex conflateMutex;
+  std::optional<glora::core::Tick> conflatedTick;
+  std::chrono::steady_clock::time_point lastTickBroadcast{};
+  auto broadcastTick = [&](const glora::core::Tick& tick) {
+    thread_local std::string tickMessage;
+    glora::network::encodeTickMessage(tickMessage, settings.defaultSymbol, tick);
+    apiHandler->broadcastStream(tickMessage);
+  };
+  auto flushConflatedTick = [&]() {
+    std::lock_guard<std::mutex> lock(conflateMutex);
+    auto now = std::chrono::steady_clock::now();
+    if (!conflatedTick || now - lastTickBroadcast < OverloadController::kConflateInterval) return;
+    broadcastTick(*conflatedTick);
+    conflatedTick.reset();
+    lastTickBroadcast = now;
+  };
 
   // 9. Subscribe to real-time data
   binanceClient->subscribeAggTrades(
       settings.defaultSymbol,
       [&](const glora::core::Tick &tick) { 
-        tickQueue.push(tick); 
+        auto now = std::chrono::steady_clock::now();
+        tickQueue.push(QueuedTick{settings.defaultSymbol, tick, now});
+        tickQueueDepth.set(static_cast<double>(tickQueue.size()));
+        
+        // Conflated to the latest trade per interval while overloaded: a
+        // trade inside the interval replaces the pending one
+        if (overload.atLeast(OverloadController::Tier::CONFLATED)) {
+          std::lock_guard<std::mutex> lock(conflateMutex);
+          if (now - lastTickBroadcast < OverloadController::kConflateInterval) {
+            if (conflatedTick) {
+              overload.countShed(OverloadController::Shed::TICK_BROADCAST);
+            }
+            conflatedTick = tick;
+            return;
+          }
+          conflatedTick.reset();
+          lastTickBroadcast = now;
+          broadcastTick(tick);
+          return;
+        }
         
         // Also broadcast to frontend via API Handler
-        apiHandler->broadcast(nlohmann::json{
-          {"type", "tick"},
-          {"symbol", settings.defaultSymbol},
-          {"time", tick.timestamp_ms},
-          {"price", tick.price},
-          {"quantity", tick.quantity},
-          {"isBuyerMaker", tick.is_buyer_maker}
-        });
+        broadcastTick(tick);
+      });
+
+  // Synthetic instruments share the queue, so they count toward overload
+  apiHandler->setSyntheticTickSink([&](const std::string& name, const glora::core::Tick& tick) {
+    tickQueue.push(QueuedTick{name, tick, std::chrono::steady_clock::now()});
+    tickQueueDepth.set(static_cast<double>(tickQueue.size()));
+  });
+
+  // 9a. Order book for the Smart DOM: REST snapshot first, then live diffs
+  binanceClient->fetchDepth(settings.defaultSymbol, 1000,
+      [&](const std::vector<std::pair<double, double>>& bids,
+          const std::vector<std::pair<double, double>>& asks) {
+        dataManager->updateOrderBook(settings.defaultSymbol, bids, asks);
+      });
+  binanceClient->subscribeDepth(settings.defaultSymbol,
+      [&](const std::vector<std::pair<double, double>>& bids,
+          const std::vector<std::pair<double, double>>& asks) {
+        dataManager->updateOrderBook(settings.defaultSymbol, bids, asks);
       });
 
+  // 9b. All-market miniTickers keep watchlist prices and sparklines current
+  binanceClient->subscribeMiniTickers([&](const std::vector<glora::core::MiniTicker>& tickers) {
+    dataManager->applyMiniTickers(tickers);
+  });
+
   // Set up data update callback to broadcast candle updates
-  dataManager->setOnDataUpdateCallback([&apiHandler, &settings, &dataManager]() {
-    // Get latest candles and broadcast to frontend
-    const auto& candles = dataManager->getCandles(settings.defaultSymbol);
-    if (!candles.empty()) {
-      const auto& latestCandle = candles.back();
+  dataManager->setOnDataUpdateCallback([&]() {
+    auto broadcastCandle = [&](const glora::core::Candle& candle) {
       nlohmann::json candleMsg = nlohmann::json::object();
       candleMsg["type"] = "candle";
       candleMsg["symbol"] = settings.defaultSymbol;
-      candleMsg["time"] = latestCandle.start_time_ms;
-      candleMsg["open"] = latestCandle.open;
-      candleMsg["high"] = latestCandle.high;
-      candleMsg["low"] = latestCandle.low;
-      candleMsg["close"] = latestCandle.close;
+      candleMsg["time"] = candle.start_time_ms;
+      candleMsg["open"] = candle.open;
+      candleMsg["high"] = candle.high;
+      candleMsg["low"] = candle.low;
+      candleMsg["close"] = candle.close;
       apiHandler->broadcast(candleMsg);
+    };
+    
+    // Get latest candles and broadcast to frontend
+    const auto& candles = dataManager->getCandles(settings.defaultSymbol);
+    if (!candles.empty()) {
+      const auto& latestCandle = candles.back();
+      bool opened = latestCandle.start_time_ms != lastCandleSent;
+      auto now = std::chrono::steady_clock::now();
+      if (!opened && overload.atLeast(OverloadController::Tier::CONFLATED) &&
+          now - lastCandleBroadcast < OverloadController::kConflateInterval) {
+        overload.countShed(OverloadController::Shed::CANDLE_BROADCAST);
+        return;
+      }
+      
+      // Updates may have been conflated away; the closed candle always gets
+      // its final state
+      if (opened && candles.size() >= 2 && candles[candles.size() - 2].start_time_ms == lastCandleSent) {
+        broadcastCandle(candles[candles.size() - 2]);
+      }
+      broadcastCandle(latestCandle);
+      lastCandleSent = latestCandle.start_time_ms;
+      lastCandleBroadcast = now;
     }
   });
 
   // 10. Start Network Thread
   std::thread networkThread([&]() {
+    glora::core::applyThreadRole(ThreadRole::FEED, "glora-connect");
     binanceClient->connectAndRun();
   });
 
   // 11. Start Data Processing Thread
   std::thread processingThread([&]() {
+    glora::core::applyThreadRole(ThreadRole::AGGREGATE, "glora-aggregate");
+    glora::core::ScopedAllocTag tickTag(glora::core::AllocSubsystem::Tick);
     while (true) {
-      auto tickOpt = tickQueue.pop();
-      if (tickOpt.has_value()) {
-        mainWindow.addRawTick(tickOpt.value());
-        dataManager->addLiveTick(settings.defaultSymbol, tickOpt.value());
+      auto queued = tickQueue.pop_for(std::chrono::milliseconds(250));
+      flushConflatedTick();
+      if (queued.has_value()) {
+        size_t depth = tickQueue.size();
+        tickQueueDepth.set(static_cast<double>(depth));
+        
+        // Time spent in the queue
+        double lagMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - queued->enqueued).count();
+        overload.observe(lagMs, depth);
+        
+        GLORA_TRACE_SCOPE("pipeline", "processTick");
+        const glora::core::Tick& tick = queued->tick;
+        if (queued->symbol != settings.defaultSymbol) {
+          dataManager->addBackgroundTick(queued->symbol, tick);
+          if (overload.atLeast(OverloadController::Tier::CONFLATED)) {
+            overload.countShed(OverloadController::Shed::TICK_BROADCAST);
+          } else {
+            thread_local std::string syntheticMessage;
+            glora::network::encodeTickMessage(syntheticMessage, queued->symbol, tick);
+            apiHandler->broadcastStream(syntheticMessage);
+          }
+          continue;
+        }
+        mainWindow.addRawTick(tick);
+        dataManager->addLiveTick(settings.defaultSymbol, tick);
+        dataManager->processTradeForSmartDOM(settings.defaultSymbol, tick);
+      } else if (tickQueue.valid()) {
+        // Idle: nothing is behind, let the controller recover
+        overload.observe(0.0, 0);
       } else {
         break;
       }
@@ -144,6 +305,7 @@ int main(int argc, char *argv[]) {
   
   // 12. Start Hourly Cleanup Thread (removes data older than 7 days)
   std::thread cleanupThread([&database, &settings]() {
+    glora::core::applyThreadRole(ThreadRole::PERSIST, "glora-cleanup");
     const int CLEANUP_INTERVAL_HOURS = 1;
     const int KEEP_DAYS = 7;
     
@@ -154,16 +316,25 @@ int main(int argc, char *argv[]) {
       if (database) {
         database->cleanupOldData(KEEP_DAYS);
       }
+      glora::core::logAllocStats();
     }
   });
 
   std::cout << "Application running. Frontend should connect to ws://localhost:8080" << std::endl;
   std::cout << "Press 'Q' or 'q' to quit" << std::endl;
   std::cout << "API endpoints available:" << std::endl;
-  std::cout << "  - getHistory: { type: 'getHistory', symbol: 'BTCUSDT', days: 7 }" << std::endl;
+  std::cout << "  - getHistory: { type: 'getHistory', symbol: 'BTCUSDT', days: 7, maxPoints: 1500, mode: 'ohlc' }" << std::endl;
+  std::cout << "  - getHistoryPage: { type: 'getHistoryPage', symbol: 'BTCUSDT', interval: '1m', before: <ms>, limit: 500 }" << std::endl;
   std::cout << "  - getFootprint: { type: 'getFootprint', symbol: 'BTCUSDT', candleTime: <timestamp> }" << std::endl;
   std::cout << "  - subscribe: { type: 'subscribe', symbol: 'BTCUSDT' }" << std::endl;
   std::cout << "  - setConfig: { type: 'setConfig', days: 5 }" << std::endl;
+  std::cout << "  - getMetrics: { type: 'getMetrics' }" << std::endl;
+  std::cout << "  - subscribeDOM: { type: 'subscribeDOM', symbol: 'BTCUSDT', depth: 25, intervalMs: 250 }" << std::endl;
+  std::cout << "  - replayStart: { type: 'replayStart', symbol: 'BTCUSDT', startTime: <ms>, endTime: <ms>, interval: '1m', speed: 10 }" << std::endl;
+  std::cout << "  - replayControl: { type: 'replayControl', action: 'play' | 'pause' | 'step' | 'seek' | 'speed' | 'stop' }" << std::endl;
+  std::cout << "  - setWatchlist: { type: 'setWatchlist', symbols: ['BTCUSDT', 'ETHUSDT'] } (kept warm for instant switches)" << std::endl;
+  std::cout << "  - getSparklines: { type: 'getSparklines', symbols: ['BTCUSDT', 'ETHUSDT'] } (binary reply)" << std::endl;
+  std::cout << "  - startTrace / stopTrace: { type: 'stopTrace', path: 'glora_trace.json' } (Chrome/Perfetto timeline)" << std::endl;
   std::cout << "  - quit: { type: 'quit' } (or press Q in console)" << std::endl;
 
   // Add quit message handler to API Handler
@@ -176,6 +347,7 @@ int main(int argc, char *argv[]) {
 
   // Console input listener thread for 'q' or 'quit' command
   std::thread consoleInputThread([&quitRequested, &mainWindow]() {
+    glora::core::applyThreadRole(ThreadRole::BACKGROUND, "glora-console");
     std::string input;
     while (!quitRequested.load()) {
       if (std::getline(std::cin, input)) {
@@ -190,19 +362,26 @@ int main(int argc, char *argv[]) {
     }
   });
 
-  // Run UI (or just wait for frontend connections)
+  // Run UI (or just wait for frontend connections). Placed last so the
+  // threads started above don't inherit the render core set.
+  glora::core::applyThreadRole(ThreadRole::RENDER, "glora-render");
   mainWindow.run();
 
   // Shutdown signals
   tickQueue.invalidate();
 
   // Shutdown
+  dataManager->stopSymbolRefresh();
   binanceClient->shutdown();
   wsServer->stop();
+  if (metricsServer) {
+    metricsServer->stop();
+  }
 
   if (processingThread.joinable()) {
     processingThread.join();
   }
+  dataManager->flushDeferredWrites();
   if (networkThread.joinable()) {
     networkThread.join();
   }
@@ -211,6 +390,7 @@ int main(int argc, char *argv[]) {
   }
 
   database->close();
+  glora::core::logAllocStats();
   
   std::cout << "Exiting correctly." << std::endl;
   return 0;
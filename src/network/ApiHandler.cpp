@@ -1,14 +1,104 @@
 #include "ApiHandler.h"
+#include "JsonWriter.h"
+#include "../core/MemoryArena.h"
+#include "../core/Metrics.h"
+#include "../core/ThreadAffinity.h"
+#include "../core/Tracing.h"
 #include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <filesystem>
+#include <memory_resource>
 #include <thread>
 
 namespace glora {
 namespace network {
 
+namespace {
+
+/**
+ * Scratch memory for the request being handled on this thread.
+ * ixwebsocket dispatches from one thread per connection, so each gets its own.
+ */
+core::ScratchArena& requestArena() {
+    thread_local core::ScratchArena arena(core::AllocSubsystem::Request, 256 * 1024);
+    return arena;
+}
+
+/**
+ * Text buffer for streamed responses on this thread; keeps its capacity,
+ * so steady-state history and tick messages encode without allocating
+ */
+std::string& jsonBuffer() {
+    thread_local std::string buffer;
+    buffer.clear();
+    return buffer;
+}
+
+/**
+ * "correlationMatrix" message; correlations and betas at 4 decimals are
+ * plenty for a heatmap and keep a 64 x 64 matrix near 30KB
+ */
+void encodeCorrelationMatrix(std::string& out, const core::CorrelationEngine::Matrix& matrix) {
+    constexpr int kDecimals = 4;
+    size_t n = matrix.symbols.size();
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("benchmark");
+    writer.value(n > 0 ? matrix.symbols.front() : std::string());
+    writer.key("beta");
+    writer.beginArray();
+    for (float beta : matrix.beta) {
+        writer.fixed(beta, kDecimals);
+    }
+    writer.endArray();
+    writer.key("correlation");
+    writer.beginArray();
+    for (size_t i = 0; i < n; ++i) {
+        writer.beginArray();
+        for (size_t j = 0; j < n; ++j) {
+            writer.fixed(matrix.correlation[i * n + j], kDecimals);
+        }
+        writer.endArray();
+    }
+    writer.endArray();
+    writer.field("endTime", matrix.endTime);
+    writer.field("samples", matrix.samples);
+    writer.field("stepMs", matrix.stepMs);
+    writer.key("symbols");
+    writer.beginArray();
+    for (const auto& symbol : matrix.symbols) {
+        writer.value(symbol);
+    }
+    writer.endArray();
+    writer.field("type", "correlationMatrix");
+    writer.endObject();
+}
+
+} // namespace
+
 ApiHandler::ApiHandler() {}
 
-ApiHandler::~ApiHandler() {}
+ApiHandler::~ApiHandler() {
+    // Finish queued synthetic builds while everything they reply through exists
+    syntheticBuilder_.reset();
+    if (dataManager_ && correlationListenerId_) {
+        dataManager_->correlation().removeListener(correlationListenerId_);
+    }
+    if (dataManager_ && liquidityListenerId_) {
+        dataManager_->icebergs().removeListener(liquidityListenerId_);
+    }
+    if (prefetch_) {
+        prefetch_->stop();
+    }
+    if (replay_) {
+        replay_->stop();
+    }
+    if (domPublisher_) {
+        domPublisher_->stop();
+    }
+}
 
 bool ApiHandler::initialize(
     std::shared_ptr<core::DataManager> dataManager,
@@ -26,8 +116,11 @@ bool ApiHandler::initialize(
     
     // Set up message callback on WebSocketServer
     if (wsServer_) {
-        wsServer_->setMessageCallback([this](const std::string& message) {
-            this->handleMessage(message);
+        wsServer_->setMessageCallback([this](int clientId, const std::string& message) {
+            this->handleMessage(clientId, message);
+        });
+        wsServer_->setDisconnectCallback([this](int clientId) {
+            this->handleClientDisconnected(clientId);
         });
     }
     
@@ -36,6 +129,63 @@ bool ApiHandler::initialize(
         dataManager_->initialize(settings_);
         dataManager_->setNetworkClient(binanceClient_);
         dataManager_->setDatabase(database_);
+        
+        domPublisher_ = std::make_unique<DomStreamPublisher>(
+            dataManager_, [this](const std::string& frame) { broadcastStream(frame); });
+        domPublisher_->start();
+        if (wsServer_) {
+            // A lagging sender shard may have dropped diffs; snapshots repair the book
+            wsServer_->setDropCallback([this]() { domPublisher_->resync(); });
+        }
+        bookSignalPublisher_ = std::make_unique<BookSignalPublisher>(dataManager_, wsServer_);
+        syntheticBuilder_ = std::make_unique<core::ThreadPool>(1, [](size_t) {
+            core::applyThreadRole(settings::ThreadRole::AGGREGATE, "glora-synthetic");
+        });
+        
+        // Correlation matrices go out at the subscribed interval, not every step
+        correlationListenerId_ = dataManager_->correlation().addListener(
+            [this](const core::CorrelationEngine::Matrix& matrix) {
+                uint64_t interval = correlationPublishMs_.load();
+                uint64_t last = lastCorrelationPublish_.load();
+                if (interval == 0 || matrix.endTime < last + interval ||
+                    !lastCorrelationPublish_.compare_exchange_strong(last, matrix.endTime)) {
+                    return;
+                }
+                auto& message = jsonBuffer();
+                encodeCorrelationMatrix(message, matrix);
+                broadcast(message);
+            });
+        
+        // Hidden liquidity events are rare: plain JSON to the chart and alerts
+        liquidityListenerId_ = dataManager_->icebergs().addListener(
+            [this](const std::string& symbol, const core::LiquidityEvent& event) {
+                broadcast(json{
+                    {"type", "liquidityEvent"},
+                    {"kind", core::liquidityEventKindName(event.kind)},
+                    {"symbol", symbol},
+                    {"price", event.price},
+                    {"side", event.bidSide ? "bid" : "ask"},
+                    {"executed", event.executed},
+                    {"displayed", event.displayed},
+                    {"refills", event.refills},
+                    {"time", event.timeMs}
+                });
+            });
+        
+        int days = (settings_.historyDuration == settings::HistoryDuration::CUSTOM) ?
+                   settings_.customDays : 7;
+        prefetch_ = std::make_unique<core::PrefetchManager>(dataManager_, binanceClient_, days);
+        prefetch_->start();
+    }
+    
+    if (database_) {
+        replay_ = std::make_unique<core::ReplayEngine>(database_);
+    }
+    
+    // Drawings are optional: charts still work without the store
+    drawings_ = std::make_unique<database::DrawingStore>();
+    if (!drawings_->open(kDrawingStorePath)) {
+        drawings_.reset();
     }
     
     isInitialized_ = true;
@@ -43,12 +193,26 @@ bool ApiHandler::initialize(
     return true;
 }
 
-void ApiHandler::handleMessage(const std::string& messageStr) {
+void ApiHandler::handleClientDisconnected(int clientId) {
+    if (domPublisher_) {
+        domPublisher_->removeClient(clientId);
+    }
+    std::lock_guard<std::mutex> lock(correlationMutex_);
+    if (correlationClients_.erase(clientId) > 0) {
+        applyCorrelationSubscriptionsLocked();
+    }
+}
+
+void ApiHandler::handleMessage(int clientId, const std::string& messageStr) {
+    GLORA_TRACE_SCOPE("api", "handleMessage");
     if (!isInitialized_) {
         std::cerr << "[ApiHandler] Not initialized, ignoring message" << std::endl;
         return;
     }
     
+    // Request temporaries are released when the next request starts
+    core::ArenaScope requestScope(requestArena(), core::AllocSubsystem::Request);
+    
     try {
         json message = json::parse(messageStr);
         std::string type = message.value("type", "");
@@ -57,14 +221,20 @@ void ApiHandler::handleMessage(const std::string& messageStr) {
         
         if (type == "getHistory") {
             handleGetHistory(message);
+        } else if (type == "getHistoryPage") {
+            handleGetHistoryPage(message);
         } else if (type == "getFootprint") {
             handleGetFootprint(message);
+        } else if (type == "getTimeAndSales") {
+            handleGetTimeAndSales(message);
         } else if (type == "subscribe") {
             handleSubscribe(message);
         } else if (type == "setConfig") {
             handleSetConfig(message);
         } else if (type == "getStatus") {
             handleGetStatus(message);
+        } else if (type == "getMetrics") {
+            handleGetMetrics(message);
         } else if (type == "getTicks") {
             handleGetTicks(message);
         } else if (type == "saveCredentials") {
@@ -75,6 +245,40 @@ void ApiHandler::handleMessage(const std::string& messageStr) {
             handleDeleteCredentials(message);
         } else if (type == "getSmartDOM") {
             handleGetSmartDOM(message);
+        } else if (type == "subscribeDOM") {
+            handleSubscribeDOM(clientId, message);
+        } else if (type == "unsubscribeDOM") {
+            handleUnsubscribeDOM(clientId, message);
+        } else if (type == "subscribeCorrelation") {
+            handleSubscribeCorrelation(clientId, message);
+        } else if (type == "unsubscribeCorrelation") {
+            handleUnsubscribeCorrelation(clientId, message);
+        } else if (type == "subscribeBookSignals") {
+            handleSubscribeBookSignals(message);
+        } else if (type == "unsubscribeBookSignals") {
+            handleUnsubscribeBookSignals(message);
+        } else if (type == "replayStart") {
+            handleReplayStart(message);
+        } else if (type == "replayControl") {
+            handleReplayControl(message);
+        } else if (type == "getSparklines") {
+            handleGetSparklines(message);
+        } else if (type == "setWatchlist") {
+            handleSetWatchlist(message);
+        } else if (type == "createSynthetic") {
+            handleCreateSynthetic(message);
+        } else if (type == "removeSynthetic") {
+            handleRemoveSynthetic(message);
+        } else if (type == "saveDrawing") {
+            handleSaveDrawing(message);
+        } else if (type == "deleteDrawing") {
+            handleDeleteDrawing(message);
+        } else if (type == "getDrawings") {
+            handleGetDrawings(message);
+        } else if (type == "startTrace") {
+            handleStartTrace(message);
+        } else if (type == "stopTrace") {
+            handleStopTrace(message);
         } else if (type == "quit") {
             std::cout << "[ApiHandler] Quit requested" << std::endl;
             // Signal shutdown - we'll handle this via callback
@@ -98,6 +302,7 @@ void ApiHandler::handleMessage(const std::string& messageStr) {
 }
 
 void ApiHandler::handleGetHistory(const json& message) {
+    GLORA_TRACE_SCOPE("api", "getHistory");
     std::string symbol = message.value("symbol", currentSymbol_);
     int days = message.value("days", 7); // Default 7 days
     
@@ -126,6 +331,36 @@ void ApiHandler::handleGetHistory(const json& message) {
               << " from " << startTime << " to " << endTime 
               << " (interval: " << interval << ", days: " << days << ")" << std::endl;
     
+    // A point budget asks for a shape-preserving reduction from the candle
+    // pyramid. Zooming in with the same budget returns a finer resolution.
+    int maxPoints = message.value("maxPoints", 0);
+    if (maxPoints > 0 && dataManager_) {
+        std::string modeName = message.value("mode", "ohlc");
+        auto mode = core::parseDownsampleMode(modeName);
+        if (!mode) {
+            auto response = buildErrorResponse("Unknown downsample mode: " + modeName);
+            response["requestId"] = getRequestId(message);
+            broadcast(response);
+            return;
+        }
+        
+        maxPoints = std::clamp(maxPoints, kMinHistoryPoints, kMaxHistoryPoints);
+        auto result = dataManager_->getDownsampledHistory(symbol, startTime, endTime, maxPoints, *mode,
+                                                          core::DataManager::intervalToMs(interval));
+        if (!result.candles.empty()) {
+            sendHistoryResponse(result.candles, {
+                {"interval", interval},
+                {"mode", modeName},
+                {"resolutionMs", result.resolutionMs},
+                {"sourceCount", result.sourceCount},
+                {"downsampled", result.candles.size() < result.sourceCount},
+                {"requestId", getRequestId(message)}
+            });
+            return;
+        }
+        // Nothing stored for the range yet: fall through to the full fetch
+    }
+    
     // Check if interval changed
     bool intervalChanged = (interval != currentInterval_);
     
@@ -165,13 +400,16 @@ void ApiHandler::handleGetHistory(const json& message) {
                         database_->insertCandles(symbol, fetchedCandles);
                         std::cout << "[ApiHandler] Saved " << fetchedCandles.size() 
                                   << " candles to database" << std::endl;
+                        if (dataManager_) {
+                            dataManager_->invalidateHistory(symbol);
+                        }
                     }
                     // Use the fetched candles directly instead of re-querying database
                     // (database doesn't filter by interval, so re-querying would return wrong data)
-                    auto response = buildHistoryResponse(fetchedCandles);
-                    response["interval"] = interval;
-                    response["requestId"] = getRequestId(message);
-                    broadcast(response);
+                    sendHistoryResponse(fetchedCandles, {
+                        {"interval", interval},
+                        {"requestId", getRequestId(message)}
+                    });
                 }
             );
             return; // Don't send response now - wait for async callback
@@ -179,48 +417,239 @@ void ApiHandler::handleGetHistory(const json& message) {
     }
     
     // Return cached candles
-    auto response = buildHistoryResponse(candles);
-    response["requestId"] = getRequestId(message);
-    broadcast(response);
+    sendHistoryResponse(candles, {{"requestId", getRequestId(message)}});
+}
+
+bool ApiHandler::getBarRange(const json& message, uint64_t& startTime, uint64_t& endTime, std::string& interval) {
+    interval = message.value("interval", currentInterval_.empty() ? std::string("1m") : currentInterval_);
+    uint64_t candleTime = message.value("candleTime", 0);
+    
+    if (candleTime != 0) {
+        startTime = candleTime;
+        endTime = candleTime + core::DataManager::intervalToMs(interval);
+        return true;
+    }
+    
+    startTime = message.value("startTime", 0);
+    endTime = message.value("endTime", 0);
+    return startTime != 0 && endTime > startTime;
+}
+
+void ApiHandler::handleGetHistoryPage(const json& message) {
+    GLORA_TRACE_SCOPE("api", "getHistoryPage");
+    std::string symbol = message.value("symbol", currentSymbol_);
+    std::string interval = message.value("interval", "1m");
+    uint64_t before = message.value("before", 0ULL);
+    int limit = std::clamp(message.value("limit", kDefaultHistoryPage), 1, kMaxHistoryPage);
+    
+    if (!dataManager_ || before == 0) {
+        auto response = buildErrorResponse(dataManager_ ? "before is required" : "DataManager not available");
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
+    
+    auto candles = dataManager_->getHistoryPage(symbol, interval, before, static_cast<size_t>(limit));
+    if (!candles) {
+        // A failed fetch says nothing about older history; the client may retry
+        auto response = buildErrorResponse("History page could not be loaded");
+        response["symbol"] = symbol;
+        response["before"] = before;
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
+    
+    // The client prepends the page to what it holds; an empty page means
+    // there is no older history to ask for
+    sendHistoryResponse(*candles, {
+        {"type", "historyPage"},
+        {"symbol", symbol},
+        {"interval", interval},
+        {"before", before},
+        {"hasMore", !candles->empty()},
+        {"requestId", getRequestId(message)}
+    });
 }
 
 void ApiHandler::handleGetFootprint(const json& message) {
+    GLORA_TRACE_SCOPE("api", "getFootprint");
     std::string symbol = message.value("symbol", currentSymbol_);
-    uint64_t candleTime = message.value("candleTime", 0);
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+    std::string interval;
     
-    if (candleTime == 0) {
+    if (!getBarRange(message, startTime, endTime, interval)) {
         auto response = buildErrorResponse("Missing candleTime parameter");
         broadcast(response);
         return;
     }
     
-    std::cout << "[ApiHandler] Getting footprint for " << symbol 
-              << " at time " << candleTime << std::endl;
+    // Replay bars (the "REPLAY:" domSymbol, or replay: true) end at the replay
+    // clock; later ticks are stored but not played yet
+    bool replaySession = false;
+    if (replay_ && (symbol.rfind("REPLAY:", 0) == 0 || message.value("replay", false))) {
+        auto replay = replay_->state();
+        if (replay.active && symbol.substr(symbol.rfind(':') + 1) == replay.symbol) {
+            replaySession = true;
+            symbol = replay.symbol;
+            endTime = std::min(endTime, replay.time + 1);
+        }
+    }
+    if (replaySession && endTime <= startTime) {
+        auto response = buildErrorResponse("Bar is past the replay time");
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
     
-    // Get candles from database
-    if (database_) {
-        uint64_t startTime = candleTime;
-        uint64_t endTime = candleTime + 60000; // 1 minute
-        auto candles = database_->getCandles(symbol, startTime, endTime);
+    // Tick or volume bars, or coarser footprint rows: rebuilt from the stored
+    // ticks of the range on the worker pool
+    if (dataManager_ && (message.contains("barType") || message.contains("rowSize"))) {
+        core::BarSpec spec;
+        std::string barType = message.value("barType", "time");
+        if (barType == "tick") {
+            spec.type = core::BarType::TICK;
+            spec.size = std::max<uint64_t>(1, message.value("barSize", 1000ULL));
+        } else if (barType == "volume") {
+            spec.type = core::BarType::VOLUME;
+            spec.volumeSize = message.value("barSize", 0.0);
+        } else {
+            spec.size = core::DataManager::intervalToMs(interval);
+        }
+        spec.rowSize = std::max(0.0, message.value("rowSize", 0.0));
         
-        if (!candles.empty()) {
-            auto response = buildFootprintResponse(candles.front());
+        std::string error;
+        if (spec.type == core::BarType::VOLUME && spec.volumeSize <= 0.0) {
+            error = "barSize (quantity per bar) is required for volume bars";
+        } else if (endTime - startTime > kMaxFootprintRebuildMs) {
+            error = "Footprint rebuild range is limited to 24h";
+        }
+        if (!error.empty()) {
+            auto response = buildErrorResponse(error);
             response["requestId"] = getRequestId(message);
             broadcast(response);
-        } else {
-            auto response = buildErrorResponse("No candle found at specified time");
-            broadcast(response);
+            return;
         }
+        
+        // Plain 1m bars are what the candle cache already holds
+        bool custom = spec.type != core::BarType::TIME || spec.size != 60000 || spec.rowSize > 0.0;
+        if (custom) {
+            auto bars = dataManager_->rebuildFootprints(symbol, startTime, endTime - 1, spec);
+            sendHistoryResponse(bars, {
+                {"type", "footprintBars"},
+                {"symbol", symbol},
+                {"barType", barType},
+                {"rowSize", spec.rowSize},
+                {"requestId", getRequestId(message)}
+            });
+            return;
+        }
+    }
+    
+    std::cout << "[ApiHandler] Getting " << interval << " footprint for " << symbol 
+              << " at time " << startTime << std::endl;
+    
+    // Built from the tick index, which pages older spans in from the archive
+    std::optional<core::Candle> candle;
+    if (dataManager_) {
+        candle = dataManager_->getFootprint(symbol, startTime, endTime);
+    }
+    
+    // No ticks stored for this span: fall back to the bare OHLCV bar, which
+    // a replay can't use since it covers the whole bar
+    if (!candle && database_ && !replaySession) {
+        auto candles = database_->getCandles(symbol, startTime, endTime - 1);
+        if (!candles.empty()) {
+            candle = candles.front();
+        }
+    }
+    
+    if (candle) {
+        sendFootprintResponse(symbol, interval, *candle, getRequestId(message));
+    } else {
+        auto response = buildErrorResponse("No candle found at specified time");
+        broadcast(response);
     }
 }
 
+void ApiHandler::handleGetTimeAndSales(const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+    std::string interval;
+    double minQuantity = message.value("minQuantity", 0.0);
+    size_t limit = message.value("limit", 1000);
+    
+    if (!getBarRange(message, startTime, endTime, interval)) {
+        auto response = buildErrorResponse("Missing candleTime or startTime/endTime parameters");
+        broadcast(response);
+        return;
+    }
+    
+    if (!dataManager_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    auto trades = dataManager_->getTimeAndSales(symbol, startTime, endTime, minQuantity, limit);
+    
+    json tradesJson = json::array();
+    for (const auto& tick : trades) {
+        tradesJson.push_back({
+            {"time", tick.timestamp_ms},
+            {"price", tick.price},
+            {"quantity", tick.quantity},
+            {"isBuyerMaker", tick.is_buyer_maker},
+            {"id", tick.trade_id}
+        });
+    }
+    
+    json response = {
+        {"type", "timeAndSales"},
+        {"symbol", symbol},
+        {"startTime", startTime},
+        {"endTime", endTime},
+        {"minQuantity", minQuantity},
+        {"count", trades.size()},
+        {"trades", std::move(tradesJson)}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
 void ApiHandler::handleSubscribe(const json& message) {
+    GLORA_TRACE_SCOPE("api", "subscribe");
     std::string symbol = message.value("symbol", currentSymbol_);
     std::string interval = message.value("interval", settings_.defaultInterval);
     currentSymbol_ = symbol;
     
     std::cout << "[ApiHandler] Subscribing to " << symbol << " with interval " << interval << std::endl;
     
+    // Synthetics have no exchange stream or klines: history was built when
+    // they were created and live ticks arrive through their legs
+    if (dataManager_ && dataManager_->synthetics().contains(symbol)) {
+        sendHistoryResponse(dataManager_->aggregateToTimeframe(symbol, interval), {
+            {"interval", interval},
+            {"synthetic", true},
+            {"requestId", getRequestId(message)}
+        });
+        return;
+    }
+    
+    // Warm symbols are already in memory: no database or REST round trip
+    bool warm = prefetch_ && prefetch_->recordUse(symbol);
+    if (warm) {
+        sendHistoryResponse(dataManager_->aggregateToTimeframe(symbol, interval), {
+            {"interval", interval},
+            {"warm", true},
+            {"requestId", getRequestId(message)}
+        });
+        subscribeToLiveUpdates(symbol, interval);
+        return;
+    }
+    
     // === STEP 1: Load and send historical data from database first ===
     // We always load 1m candles and aggregate to the requested timeframe
     int days = (settings_.historyDuration == settings::HistoryDuration::CUSTOM) ? 
@@ -254,6 +683,10 @@ void ApiHandler::handleSubscribe(const json& message) {
                 if (!fetchedCandles.empty() && database_) {
                     database_->insertCandles(symbol, fetchedCandles);
                     std::cout << "[ApiHandler] Saved " << fetchedCandles.size() << " 1m candles to database" << std::endl;
+                    if (dataManager_) {
+                        dataManager_->invalidateHistory(symbol);
+                        dataManager_->loadCandles(symbol, fetchedCandles);
+                    }
                 }
                 
                 // Get candles from DataManager (which now has the data)
@@ -263,10 +696,10 @@ void ApiHandler::handleSubscribe(const json& message) {
                 }
                 
                 // Send history to frontend
-                auto response = buildHistoryResponse(candles);
-                response["interval"] = interval;
-                response["requestId"] = getRequestId(message);
-                broadcast(response);
+                sendHistoryResponse(candles, {
+                    {"interval", interval},
+                    {"requestId", getRequestId(message)}
+                });
                 
                 // Now subscribe to live updates (always 1m)
                 subscribeToLiveUpdates(symbol, "1m");
@@ -280,16 +713,17 @@ void ApiHandler::handleSubscribe(const json& message) {
     if (dataManager_) {
         // First load the 1m candles into DataManager memory
         // Then aggregate to the requested interval
+        dataManager_->loadCandles(symbol, std::move(candles1m));
         candles = dataManager_->aggregateToTimeframe(symbol, interval);
     }
     
     std::cout << "[ApiHandler] Sending " << candles.size() << " " << interval << " candles to frontend" << std::endl;
     
     // Send history from DB (aggregated) to frontend
-    auto historyResponse = buildHistoryResponse(candles);
-    historyResponse["interval"] = interval;
-    historyResponse["requestId"] = getRequestId(message);
-    broadcast(historyResponse);
+    sendHistoryResponse(candles, {
+        {"interval", interval},
+        {"requestId", getRequestId(message)}
+    });
     
     // === STEP 2: Subscribe to live updates ===
     subscribeToLiveUpdates(symbol, interval);
@@ -305,15 +739,9 @@ void ApiHandler::subscribeToLiveUpdates(const std::string& symbol, const std::st
             symbol,
             [this, symbol](const core::Tick& tick) {
                 // Broadcast tick to all clients
-                json tickMsg = {
-                    {"type", "tick"},
-                    {"symbol", symbol},
-                    {"time", tick.timestamp_ms},
-                    {"price", tick.price},
-                    {"quantity", tick.quantity},
-                    {"isBuyerMaker", tick.is_buyer_maker}
-                };
-                broadcast(tickMsg);
+                auto& tickMsg = jsonBuffer();
+                encodeTickMessage(tickMsg, symbol, tick);
+                broadcastStream(tickMsg);
                 
                 // Also pass to DataManager (converts ticks to candles)
                 if (dataManager_) {
@@ -389,7 +817,41 @@ void ApiHandler::handleGetStatus(const json& message) {
     broadcast(response);
 }
 
+void ApiHandler::handleGetMetrics(const json& message) {
+    json metrics = json::array();
+    for (const auto& sample : core::MetricsRegistry::getInstance().snapshot()) {
+        json entry = {
+            {"name", sample.name},
+            {"labels", sample.labels},
+            {"value", sample.value}
+        };
+        switch (sample.type) {
+            case core::MetricType::COUNTER:
+                entry["type"] = "counter";
+                break;
+            case core::MetricType::GAUGE:
+                entry["type"] = "gauge";
+                break;
+            case core::MetricType::HISTOGRAM:
+                entry["type"] = "histogram";
+                entry["sum"] = sample.sum;
+                entry["bounds"] = sample.bounds;
+                entry["buckets"] = sample.cumulative;  // Cumulative, last is +Inf
+                break;
+        }
+        metrics.push_back(std::move(entry));
+    }
+    
+    json response = {
+        {"type", "metrics"},
+        {"metrics", std::move(metrics)}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
 void ApiHandler::handleGetTicks(const json& message) {
+    GLORA_TRACE_SCOPE("api", "getTicks");
     std::string symbol = message.value("symbol", currentSymbol_);
     uint64_t startTime = message.value("startTime", 0);
     uint64_t endTime = message.value("endTime", 0);
@@ -406,29 +868,28 @@ void ApiHandler::handleGetTicks(const json& message) {
     std::cout << "[ApiHandler] Getting ticks for " << symbol 
               << " from " << startTime << " to " << endTime << std::endl;
     
-    std::vector<core::Tick> ticks;
+    std::pmr::vector<core::Tick> ticks(&requestArena());
     if (database_) {
-        ticks = database_->getTicks(symbol, startTime, endTime);
+        database_->getTicks(symbol, startTime, endTime, ticks);
     }
     
-    json response = {
+    json fields = {
         {"type", "ticks"},
         {"symbol", symbol},
-        {"count", ticks.size()}
+        {"count", ticks.size()},
+        {"requestId", getRequestId(message)}
     };
     
-    // Add tick data
-    json tickArray = json::array();
-    for (const auto& tick : ticks) {
-        tickArray.push_back({
-            {"t", tick.timestamp_ms},
-            {"p", tick.price},
-            {"q", tick.quantity},
-            {"m", tick.is_buyer_maker}
-        });
-    }
-    response["ticks"] = tickArray;
-    response["requestId"] = getRequestId(message);
+    // Tick array streamed straight into the buffer, no per-tick nodes
+    auto& response = jsonBuffer();
+    JsonWriter writer(response);
+    writer.objectWith(fields, "ticks", [&ticks](JsonWriter& w) {
+        w.beginArray();
+        for (const auto& tick : ticks) {
+            writeCompactTick(w, tick);
+        }
+        w.endArray();
+    });
     broadcast(response);
 }
 
@@ -438,10 +899,26 @@ void ApiHandler::broadcast(const json& message) {
     }
 }
 
+void ApiHandler::broadcast(const std::string& message) {
+    if (wsServer_ && wsServer_->isRunning()) {
+        wsServer_->broadcast(message);
+    }
+}
+
+void ApiHandler::broadcastStream(const std::string& message) {
+    if (wsServer_ && wsServer_->isRunning()) {
+        wsServer_->broadcastStream(message);
+    }
+}
+
 void ApiHandler::setOnTickCallback(std::function<void(const core::Tick&)> callback) {
     onTickCallback_ = std::move(callback);
 }
 
+void ApiHandler::setSyntheticTickSink(SyntheticTickSink sink) {
+    syntheticTickSink_ = std::move(sink);
+}
+
 void ApiHandler::setOnQuitCallback(std::function<void()> callback) {
     onQuitCallback_ = std::move(callback);
 }
@@ -453,66 +930,50 @@ void ApiHandler::updateSettings(const settings::AppSettings& settings) {
     }
 }
 
-json ApiHandler::buildHistoryResponse(const std::vector<core::Candle>& candles) {
-    json response = {
+void ApiHandler::sendHistoryResponse(const std::vector<core::Candle>& candles, const json& fields) {
+    GLORA_TRACE_SCOPE("api", "encodeHistory");
+    json header = {
         {"type", "history"},
         {"symbol", currentSymbol_},
         {"count", candles.size()}
     };
+    header.update(fields);
     
-    json candleArray = json::array();
-    for (const auto& candle : candles) {
-        json c = {
-            {"time", candle.start_time_ms},
-            {"open", candle.open},
-            {"high", candle.high},
-            {"low", candle.low},
-            {"close", candle.close},
-            {"volume", candle.volume}
-        };
-        
-        // Include footprint if available
-        if (!candle.footprint_profile.empty()) {
-            json footprint = json::object();
-            for (const auto& [price, node] : candle.footprint_profile) {
-                footprint[std::to_string(price)] = {
-                    {"bid", node.bid_volume},
-                    {"ask", node.ask_volume}
-                };
-            }
-            c["footprint"] = footprint;
+    // Candles go straight into the buffer instead of one json node per value
+    auto& response = jsonBuffer();
+    JsonWriter writer(response);
+    writer.objectWith(header, "candles", [&candles](JsonWriter& w) {
+        w.beginArray();
+        for (const auto& candle : candles) {
+            writeCandle(w, candle);
         }
-        
-        candleArray.push_back(c);
-    }
-    
-    response["candles"] = candleArray;
-    return response;
+        w.endArray();
+    });
+    broadcast(response);
 }
 
-json ApiHandler::buildFootprintResponse(const core::Candle& candle) {
-    json response = {
+void ApiHandler::sendFootprintResponse(const std::string& symbol, const std::string& interval,
+                                       const core::Candle& candle, const std::string& requestId) {
+    json header = {
         {"type", "footprint"},
-        {"symbol", currentSymbol_},
+        {"symbol", symbol},
+        {"interval", interval},
         {"time", candle.start_time_ms},
         {"open", candle.open},
         {"high", candle.high},
         {"low", candle.low},
         {"close", candle.close},
-        {"volume", candle.volume}
+        {"volume", candle.volume},
+        {"requestId", requestId}
     };
     
-    json footprint = json::object();
-    for (const auto& [price, node] : candle.footprint_profile) {
-        footprint[std::to_string(price)] = {
-            {"bid", node.bid_volume},
-            {"ask", node.ask_volume},
-            {"delta", node.ask_volume - node.bid_volume}
-        };
-    }
-    response["profile"] = footprint;
-    
-    return response;
+    // Price levels go straight into the buffer, keyed like history footprints
+    auto& response = jsonBuffer();
+    JsonWriter writer(response);
+    writer.objectWith(header, "profile", [&candle](JsonWriter& w) {
+        writeFootprint(w, candle.footprint_profile, true);
+    });
+    broadcast(response);
 }
 
 json ApiHandler::buildErrorResponse(const std::string& error) {
@@ -657,6 +1118,7 @@ void ApiHandler::handleDeleteCredentials(const json& message) {
 }
 
 void ApiHandler::handleGetSmartDOM(const json& message) {
+    GLORA_TRACE_SCOPE("api", "getSmartDOM");
     std::string symbol = message.value("symbol", currentSymbol_);
     int depth = message.value("depth", 25);
     
@@ -668,39 +1130,624 @@ void ApiHandler::handleGetSmartDOM(const json& message) {
         return;
     }
     
-    // Get Smart DOM data from DataManager
-    auto domData = dataManager_->getSmartDOM(symbol, depth);
-    double poc = dataManager_->getPointOfControl(symbol);
+    // One locked pass: window, POC and imbalance flags at the symbol's tick size
+    core::DomFrame frame = dataManager_->getSmartDOMFrame(symbol, depth);
     
     // Build response
-    json response = {
+    json fields = {
         {"type", "smartDOM"},
         {"symbol", symbol},
-        {"poc", poc},
-        {"count", domData.size()}
+        {"poc", frame.poc},
+        {"tickSize", frame.tickSize},
+        {"count", frame.levels.size()},
+        {"requestId", getRequestId(message)}
     };
     
-    json buckets = json::array();
-    for (const auto& bucket : domData) {
-        // Check for diagonal imbalances
-        bool hasImbalance = dataManager_->hasDiagonalImbalance(symbol, bucket.price, 0.01, 3.0);
+    auto& response = jsonBuffer();
+    JsonWriter writer(response);
+    writer.objectWith(fields, "buckets", [&frame](JsonWriter& w) {
+        w.beginArray();
+        for (const auto& level : frame.levels) {
+            DomStreamPublisher::writeLevel(w, level);
+        }
+        w.endArray();
+    });
+    broadcast(response);
+}
+
+void ApiHandler::handleSubscribeDOM(int clientId, const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    
+    if (!domPublisher_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    DomStreamPublisher::StreamConfig requested;
+    requested.depth = message.value("depth", requested.depth);
+    requested.intervalMs = message.value("intervalMs", requested.intervalMs);
+    requested.snapshotIntervalMs = message.value("snapshotIntervalMs", requested.snapshotIntervalMs);
+    
+    // Reply with what was applied; the first frame is a full snapshot. One
+    // stream per symbol goes to every client, so the applied settings are the
+    // merge of all subscribers' (deepest, fastest) and may exceed this request
+    auto applied = domPublisher_->subscribe(clientId, symbol, requested);
+    auto own = DomStreamPublisher::clampConfig(requested);
+    
+    json response = {
+        {"type", "domSubscribed"},
+        {"symbol", symbol},
+        {"depth", applied.depth},
+        {"intervalMs", applied.intervalMs},
+        {"snapshotIntervalMs", applied.snapshotIntervalMs},
+        {"merged", true},
+        {"requested", {
+            {"depth", own.depth},
+            {"intervalMs", own.intervalMs},
+            {"snapshotIntervalMs", own.snapshotIntervalMs}
+        }},
+        {"note", "Settings are shared by all subscribers of the symbol: the deepest depth and shortest intervals requested apply"}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleUnsubscribeDOM(int clientId, const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    bool removed = domPublisher_ && domPublisher_->unsubscribe(clientId, symbol);
+    
+    json response = {
+        {"type", "domUnsubscribed"},
+        {"symbol", symbol},
+        {"success", removed}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleSubscribeBookSignals(const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    
+    if (!bookSignalPublisher_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    bookSignalPublisher_->subscribe(symbol);
+    
+    // The latest sample lets the chart draw before the first binary batch
+    json response = {
+        {"type", "bookSignalsSubscribed"},
+        {"symbol", symbol},
+        {"levels", core::BookSignalEngine::kLevels},
+        {"flowWindowMs", core::BookSignalEngine::kFlowWindowMs},
+        {"batchIntervalMs", BookSignalPublisher::kBatchIntervalMs}
+    };
+    if (auto latest = dataManager_->bookSignals().latest(symbol)) {
+        response["latest"] = {
+            {"time", latest->timeMs},
+            {"bestBid", latest->bestBid},
+            {"bestAsk", latest->bestAsk},
+            {"microprice", latest->microprice},
+            {"weightedMid", latest->weightedMid},
+            {"imbalance", latest->imbalance},
+            {"spread", latest->spread}
+        };
+    }
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleUnsubscribeBookSignals(const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    bool removed = bookSignalPublisher_ && bookSignalPublisher_->unsubscribe(symbol);
+    
+    json response = {
+        {"type", "bookSignalsUnsubscribed"},
+        {"symbol", symbol},
+        {"success", removed}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleSubscribeCorrelation(int clientId, const json& message) {
+    if (!dataManager_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    // Benchmark first, then the rest in the order given
+    std::string benchmark = message.value("benchmark", kDefaultCorrelationBenchmark);
+    std::vector<std::string> symbols{benchmark};
+    if (message.contains("symbols") && message["symbols"].is_array()) {
+        for (const auto& symbol : message["symbols"]) {
+            if (symbol.is_string() && symbol.get<std::string>() != benchmark) {
+                symbols.push_back(symbol.get<std::string>());
+            }
+        }
+    }
+    
+    int interval = std::clamp(message.value("intervalMs", kDefaultCorrelationIntervalMs),
+                              static_cast<int>(core::CorrelationEngine::kDefaultStepMs), 60000);
+    {
+        std::lock_guard<std::mutex> lock(correlationMutex_);
+        correlationClients_[clientId] = CorrelationSubscription{std::move(symbols), static_cast<uint64_t>(interval)};
+        applyCorrelationSubscriptionsLocked();
+    }
+    
+    // Current state right away; empty until a couple of steps have closed
+    auto& response = jsonBuffer();
+    encodeCorrelationMatrix(response, dataManager_->correlation().snapshot());
+    broadcast(response);
+}
+
+void ApiHandler::handleUnsubscribeCorrelation(int clientId, const json& message) {
+    bool wasActive = false;
+    {
+        std::lock_guard<std::mutex> lock(correlationMutex_);
+        wasActive = correlationClients_.erase(clientId) > 0;
+        if (wasActive) {
+            applyCorrelationSubscriptionsLocked();
+        }
+    }
+    
+    json response = {
+        {"type", "correlationUnsubscribed"},
+        {"success", wasActive}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::applyCorrelationSubscriptionsLocked() {
+    if (!dataManager_) return;
+    
+    // Client ids grow with each connection, so the first entry is the oldest
+    std::vector<std::string> symbols;
+    uint64_t interval = 0;
+    for (const auto& [clientId, subscription] : correlationClients_) {
+        for (const auto& symbol : subscription.symbols) {
+            if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
+                symbols.push_back(symbol);
+            }
+        }
+        interval = interval == 0 ? subscription.intervalMs : std::min(interval, subscription.intervalMs);
+    }
+    
+    auto& engine = dataManager_->correlation();
+    if (symbols != engine.symbols()) {
+        engine.setSymbols(symbols);
+    }
+    correlationPublishMs_ = interval;
+}
+
+void ApiHandler::handleCreateSynthetic(const json& message) {
+    if (!dataManager_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    auto kind = core::parseSyntheticKind(message.value("kind", "ratio"));
+    if (!kind) {
+        auto response = buildErrorResponse("Unknown synthetic kind");
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
+    
+    core::SyntheticDefinition definition;
+    definition.name = message.value("name", "");
+    definition.kind = *kind;
+    definition.toleranceMs = message.value("toleranceMs", definition.toleranceMs);
+    if (message.contains("legs") && message["legs"].is_array()) {
+        for (const auto& leg : message["legs"]) {
+            if (!leg.is_object()) continue;
+            definition.legs.push_back({leg.value("symbol", ""), leg.value("weight", 1.0)});
+        }
+    }
+    
+    auto& synthetics = dataManager_->synthetics();
+    if (!synthetics.define(definition)) {
+        auto response = buildErrorResponse("Invalid synthetic legs");
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
+    if (definition.name.empty()) {
+        definition.name = core::syntheticName(definition);
+    }
+    definition = *synthetics.definition(definition.name);
+    updateSyntheticLegs();
+    
+    // History from the legs' stored ticks, built off the message thread; the
+    // reply goes out once it is stored
+    int days = std::clamp(message.value("days", 1), 1, 7);
+    uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    uint64_t startTime = now - (static_cast<uint64_t>(days) * 24 * 60 * 60 * 1000);
+    syntheticBuilder_->submit([this, definition, startTime, now, requestId = getRequestId(message)]() {
+        size_t candles = dataManager_->buildSyntheticHistory(definition.name, startTime, now);
+        
+        json legs = json::array();
+        for (const auto& leg : definition.legs) {
+            legs.push_back({{"symbol", leg.symbol}, {"weight", leg.weight}});
+        }
+        json response = {
+            {"type", "syntheticCreated"},
+            {"name", definition.name},
+            {"kind", core::syntheticKindName(definition.kind)},
+            {"legs", legs},
+            {"toleranceMs", definition.toleranceMs},
+            {"candles", candles}
+        };
+        response["requestId"] = requestId;
+        broadcast(response);
+    });
+}
+
+void ApiHandler::handleRemoveSynthetic(const json& message) {
+    std::string name = message.value("name", "");
+    bool removed = dataManager_ && dataManager_->synthetics().remove(name);
+    if (removed) {
+        updateSyntheticLegs();
+    }
+    
+    json response = {
+        {"type", "syntheticRemoved"},
+        {"name", name},
+        {"success", removed}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::updateSyntheticLegs() {
+    if (!binanceClient_ || !dataManager_) return;
+    
+    // Leg trades come in on the background socket and only feed the join;
+    // joined ticks take the main feed's queue
+    binanceClient_->setBackgroundAggTrades("synthetic", dataManager_->synthetics().legSymbols(),
+        [this](const std::string& symbol, const core::Tick& tick) {
+            for (const auto& [name, synthetic] : dataManager_->synthetics().onLegTick(symbol, tick)) {
+                if (syntheticTickSink_) {
+                    syntheticTickSink_(name, synthetic);
+                    continue;
+                }
+                dataManager_->addBackgroundTick(name, synthetic);
+                auto& tickMsg = jsonBuffer();
+                encodeTickMessage(tickMsg, name, synthetic);
+                broadcastStream(tickMsg);
+            }
+        });
+}
+
+void ApiHandler::handleSaveDrawing(const json& message) {
+    if (!drawings_) {
+        auto response = buildErrorResponse("Drawing store not available");
+        broadcast(response);
+        return;
+    }
+    
+    std::string symbol = getSymbol(message);
+    database::DrawingRecord drawing;
+    drawing.id = message.value("id", "");
+    drawing.layer = message.value("layer", drawing.layer);
+    drawing.startTime = message.value("startTime", drawing.startTime);
+    drawing.endTime = message.value("endTime", drawing.endTime);
+    if (message.contains("data")) {
+        drawing.data = message["data"].dump();
+    }
+    bool saved = drawings_->put(symbol, drawing);
+    
+    json response = {
+        {"type", "drawingSaved"},
+        {"symbol", symbol},
+        {"id", drawing.id},
+        {"success", saved}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleDeleteDrawing(const json& message) {
+    std::string symbol = getSymbol(message);
+    std::string id = message.value("id", "");
+    bool removed = drawings_ && drawings_->remove(symbol, id);
+    
+    json response = {
+        {"type", "drawingDeleted"},
+        {"symbol", symbol},
+        {"id", id},
+        {"success", removed}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleGetDrawings(const json& message) {
+    std::string symbol = getSymbol(message);
+    uint64_t startTime = message.value("startTime", static_cast<uint64_t>(0));
+    uint64_t endTime = message.value("endTime", std::numeric_limits<uint64_t>::max());
+    std::string layer = message.value("layer", "");
+    
+    std::vector<database::DrawingRecord> drawings;
+    if (drawings_) {
+        drawings = drawings_->load(symbol, startTime, endTime, layer);
+    }
+    
+    json fields = {
+        {"type", "drawings"},
+        {"symbol", symbol},
+        {"count", drawings.size()},
+        {"requestId", getRequestId(message)}
+    };
+    
+    // Stored drawing data is already JSON: copied through, not re-parsed
+    auto& response = jsonBuffer();
+    JsonWriter writer(response);
+    writer.objectWith(fields, "drawings", [&drawings](JsonWriter& w) {
+        w.beginArray();
+        for (const auto& drawing : drawings) {
+            w.beginObject();
+            w.key("data");
+            if (drawing.data.empty()) {
+                w.value(json());
+            } else {
+                w.raw(drawing.data);
+            }
+            w.field("endTime", drawing.endTime);
+            w.field("id", drawing.id);
+            w.field("layer", drawing.layer);
+            w.field("startTime", drawing.startTime);
+            w.endObject();
+        }
+        w.endArray();
+    });
+    broadcast(response);
+}
+
+void ApiHandler::handleStartTrace(const json& message) {
+    core::Tracer::getInstance().start();
+    
+    json response = {
+        {"type", "traceStarted"},
+        {"spansPerThread", core::Tracer::kSpansPerThread}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleStopTrace(const json& message) {
+    auto& tracer = core::Tracer::getInstance();
+    tracer.stop();
+    
+    // A bare file name only: no separators, no parent references
+    std::string file = message.value("path", kDefaultTraceFile);
+    bool validName = !file.empty() && file.size() <= 128 && file != "." &&
+                     file.find("..") == std::string::npos &&
+                     std::all_of(file.begin(), file.end(), [](char c) {
+                         return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_' || c == '-';
+                     });
+    if (!validName) {
+        auto response = buildErrorResponse("Invalid trace file name");
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
+    }
+    
+    std::error_code ec;
+    std::filesystem::create_directories(kTraceDirectory, ec);
+    if (ec) {
+        std::cerr << "[ApiHandler] Cannot create " << kTraceDirectory << ": " << ec.message() << std::endl;
+    }
+    std::string path = (std::filesystem::path(kTraceDirectory) / file).string();
+    core::Tracer::Summary summary;
+    bool written = !ec && tracer.writeChromeTrace(path, summary);
+    
+    json response = {
+        {"type", "traceStopped"},
+        {"path", path},
+        {"success", written},
+        {"spans", summary.spans},
+        {"dropped", summary.dropped},
+        {"threads", summary.threads},
+        {"durationMs", summary.durationMs}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+void ApiHandler::handleReplayStart(const json& message) {
+    std::string symbol = message.value("symbol", currentSymbol_);
+    std::string interval = message.value("interval", settings_.defaultInterval);
+    uint64_t startTime = message.value("startTime", 0ULL);
+    uint64_t endTime = message.value("endTime", 0ULL);
+    double speed = message.value("speed", 1.0);
+    
+    if (!replay_) {
+        auto response = buildErrorResponse("Database not available");
+        broadcast(response);
+        return;
+    }
+    
+    // Replayed trades feed a separate Smart DOM key so the live book of the
+    // same symbol is untouched; stream it with subscribeDOM
+    std::string domKey = "REPLAY:" + symbol;
+    
+    core::ReplayEngine::Callbacks callbacks;
+    callbacks.onTick = [this, symbol, domKey](const core::Tick& tick) {
+        json tickMsg = {
+            {"type", "replayTick"},
+            {"symbol", symbol},
+            {"time", tick.timestamp_ms},
+            {"price", tick.price},
+            {"quantity", tick.quantity},
+            {"isBuyerMaker", tick.is_buyer_maker},
+            {"id", tick.trade_id}
+        };
+        broadcastStream(tickMsg.dump());
         
-        json b = {
-            {"price", bucket.price},
-            {"restingBid", bucket.restingBidQty},
-            {"restingAsk", bucket.restingAskQty},
-            {"aggBuy", bucket.aggressiveBuyVol},
-            {"aggSell", bucket.aggressiveSellVol},
-            {"delta", bucket.getDelta()},
-            {"imbalance", hasImbalance}
+        if (dataManager_) {
+            dataManager_->processTradeForSmartDOM(domKey, tick);
+        }
+    };
+    callbacks.onCandle = [this, symbol, interval](const core::Candle& candle, bool closed) {
+        json candleMsg = {
+            {"type", "replayCandle"},
+            {"symbol", symbol},
+            {"interval", interval},
+            {"closed", closed},
+            {"time", candle.start_time_ms},
+            {"open", candle.open},
+            {"high", candle.high},
+            {"low", candle.low},
+            {"close", candle.close},
+            {"volume", candle.volume}
         };
-        buckets.push_back(b);
+        
+        // The bar's footprint so far, as in history candles
+        auto& response = jsonBuffer();
+        JsonWriter writer(response);
+        writer.objectWith(candleMsg, "footprint", [&candle](JsonWriter& w) {
+            writeFootprint(w, candle.footprint_profile);
+        });
+        broadcast(response);
+    };
+    callbacks.onState = [this](const core::ReplayEngine::State& state) {
+        broadcast(buildReplayStateResponse(state));
+    };
+    callbacks.onReset = [this, domKey]() {
+        if (dataManager_) {
+            dataManager_->clearSmartDOM(domKey);
+        }
+    };
+    
+    bool started = replay_->start(symbol, startTime, endTime, core::DataManager::intervalToMs(interval), speed,
+                                  std::move(callbacks));
+    if (!started) {
+        auto response = buildErrorResponse("Invalid replay range for " + symbol);
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+        return;
     }
     
-    response["buckets"] = buckets;
+    std::cout << "[ApiHandler] Replaying " << symbol << " from " << startTime << " to " << endTime
+              << " at " << speed << "x" << std::endl;
+    
+    // Playback starts paused once the seek index is built (state.ready)
+    auto response = buildReplayStateResponse(replay_->state());
+    response["domSymbol"] = domKey;
     response["requestId"] = getRequestId(message);
     broadcast(response);
 }
 
+void ApiHandler::handleReplayControl(const json& message) {
+    std::string action = message.value("action", "");
+    
+    if (!replay_) {
+        auto response = buildErrorResponse("Database not available");
+        broadcast(response);
+        return;
+    }
+    
+    if (action == "play") {
+        replay_->play();
+    } else if (action == "pause") {
+        replay_->pause();
+    } else if (action == "step") {
+        replay_->step(static_cast<size_t>(std::max(1, message.value("count", 1))));
+    } else if (action == "seek") {
+        replay_->seek(message.value("time", 0ULL));
+    } else if (action == "speed") {
+        replay_->setSpeed(message.value("speed", 1.0));
+    } else if (action == "stop") {
+        replay_->stop();
+        // The playback thread is gone, so report the final state from here
+        broadcast(buildReplayStateResponse(replay_->state()));
+    } else {
+        auto response = buildErrorResponse("Unknown replay action: " + action);
+        response["requestId"] = getRequestId(message);
+        broadcast(response);
+    }
+}
+
+void ApiHandler::handleGetSparklines(const json& message) {
+    if (!dataManager_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    std::vector<std::string> symbols;
+    if (message.contains("symbols") && message["symbols"].is_array()) {
+        for (const auto& symbol : message["symbols"]) {
+            if (symbol.is_string()) {
+                symbols.push_back(symbol.get<std::string>());
+            }
+        }
+    }
+    
+    auto snapshot = dataManager_->getSparklines(symbols);
+    
+    // One frame for the whole watchlist: a float per point instead of a JSON
+    // number keeps hundreds of symbols to a few hundred KB
+    if (wsServer_ && wsServer_->isRunning()) {
+        wsServer_->broadcastSparklines(snapshot.endTime, static_cast<uint32_t>(snapshot.bucketMs),
+                                       static_cast<uint16_t>(snapshot.points), snapshot.symbols,
+                                       snapshot.values);
+    }
+}
+
+void ApiHandler::handleSetWatchlist(const json& message) {
+    std::vector<std::string> symbols;
+    if (message.contains("symbols") && message["symbols"].is_array()) {
+        for (const auto& symbol : message["symbols"]) {
+            if (symbol.is_string()) {
+                symbols.push_back(symbol.get<std::string>());
+            }
+        }
+    }
+    
+    if (!prefetch_) {
+        auto response = buildErrorResponse("DataManager not available");
+        broadcast(response);
+        return;
+    }
+    
+    // Loading happens in the background; "warm" lists what is resident now
+    prefetch_->setWatchlist(symbols);
+    
+    json response = {
+        {"type", "watchlist"},
+        {"symbols", symbols},
+        {"warm", prefetch_->warmSymbols()}
+    };
+    response["requestId"] = getRequestId(message);
+    broadcast(response);
+}
+
+json ApiHandler::buildReplayStateResponse(const core::ReplayEngine::State& state) {
+    return {
+        {"type", "replayState"},
+        {"symbol", state.symbol},
+        {"startTime", state.startTime},
+        {"endTime", state.endTime},
+        {"time", state.time},
+        {"speed", state.speed},
+        {"active", state.active},
+        {"ready", state.ready},
+        {"paused", state.paused},
+        {"finished", state.finished},
+        {"ticksPlayed", state.ticksPlayed},
+        {"checkpoints", state.checkpoints}
+    };
+}
+
 } // namespace network
 } // namespace glora
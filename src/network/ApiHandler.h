@@ -2,11 +2,20 @@
 
 #include "../core/DataManager.h"
 #include "../database/Database.h"
+#include "../database/DrawingStore.h"
 #include "../network/BinanceClient.h"
 #include "../network/WebSocketServer.h"
+#include "../network/DomStreamPublisher.h"
+#include "../network/BookSignalPublisher.h"
+#include "../core/ReplayEngine.h"
+#include "../core/PrefetchManager.h"
 #include "../settings/Settings.h"
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <functional>
 #include <nlohmann/json.hpp>
 
@@ -19,14 +28,90 @@ using json = nlohmann::json;
  * ApiHandler - Handles incoming messages from frontend via WebSocket
  * 
  * Message Protocol:
- * - "getHistory": Fetch historical candles (with days or startTime/endTime)
- * - "getFootprint": Get footprint data for specific candle
- * - "subscribe": Subscribe to real-time updates for a symbol
+ * - "getHistory": Fetch historical candles (with days or startTime/endTime); with
+ *   maxPoints (and mode: ohlc | lttb) the range is downsampled and the reply
+ *   carries resolutionMs
+ * - "getHistoryPage": The page of candles before a time (symbol, interval, before,
+ *   limit), for loading older history as the chart scrolls back; an error
+ *   reply (not an empty page) when the exchange request fails
+ * - "getFootprint": Get footprint data for a candle of any interval; for the
+ *   replay's domSymbol (or replay: true) only up to the replay time. With
+ *   barType (time | tick | volume, barSize) or rowSize the range's stored
+ *   ticks are rebuilt into those bars, sent as "footprintBars"
+ * - "getTimeAndSales": Trades inside a candle, optionally only large ones (bubbles)
+ * - "subscribe": Subscribe to real-time updates for a symbol (served from memory
+ *   when the symbol is warm)
+ * - "setWatchlist": Symbols to keep warm for instant switches (symbols)
+ * - "createSynthetic": Define a ratio, spread or basket instrument (name, kind,
+ *   legs: [{symbol, weight}], toleranceMs, days of history to build); it is then
+ *   subscribed to and charted by name like any symbol
+ * - "removeSynthetic": Drop a synthetic instrument (name)
+ * - "saveDrawing": Store one drawing (symbol, id, layer, startTime, endTime, data)
+ * - "deleteDrawing": Remove a drawing (symbol, id)
+ * - "getDrawings": Drawings of a symbol overlapping a time window (symbol,
+ *   startTime, endTime, layer), read from the store on demand
  * - "setConfig": Configure data fetch parameters (days: 5-7)
  * - "getStatus": Get current backend status
+ * - "getMetrics": Snapshot of the internal metrics registry
+ * - "getSmartDOM": One-off Smart DOM snapshot
+ * - "subscribeDOM": Stream Smart DOM diffs for a symbol (depth, intervalMs, snapshotIntervalMs).
+ *   The stream is shared: it runs at the merge of every subscriber's settings,
+ *   which the reply returns (merged: true) next to this client's "requested"
+ * - "unsubscribeDOM": Stop a Smart DOM stream
+ * - "subscribeCorrelation": Rolling correlation and beta of symbols to a benchmark
+ *   (symbols, benchmark, intervalMs), pushed as "correlationMatrix". The matrix
+ *   covers every subscribed client's symbols, with the longest-subscribed
+ *   client's benchmark, at the shortest interval asked for
+ * - "unsubscribeCorrelation": Drop this client's correlation subscription
+ * - "subscribeBookSignals": Stream order book signals (microprice, imbalance,
+ *   slopes, depletion, spread stats) for a symbol as binary batches
+ * - "unsubscribeBookSignals": Stop a book signal stream
+ * - "replayStart": Replay stored ticks (symbol, startTime, endTime, interval, speed)
+ *   as replayTick and replayCandle (the bar in progress with its footprint)
+ * - "replayControl": play | pause | step (count) | seek (time) | speed (speed) | stop
+ * - "getSparklines": 24h sparklines for a watchlist (symbols; all tracked when
+ *   empty) as one binary frame
+ * - "startTrace": Start recording pipeline spans
+ * - "stopTrace": Stop and write the spans as Chrome trace JSON (path, a bare
+ *   file name inside the trace directory)
  */
 class ApiHandler {
 public:
+    /**
+     * Point budget bounds for downsampled history
+     */
+    static constexpr int kMinHistoryPoints = 16;
+    static constexpr int kMaxHistoryPoints = 20000;
+
+    /**
+     * Candles per history page (klines return at most 1000 per request)
+     */
+    static constexpr int kDefaultHistoryPage = 500;
+    static constexpr int kMaxHistoryPage = 1000;
+
+    /**
+     * Longest range getFootprint rebuilds into custom bars in one request
+     */
+    static constexpr uint64_t kMaxFootprintRebuildMs = 24ULL * 60 * 60 * 1000;
+
+    /**
+     * Correlation publishing defaults
+     */
+    static constexpr const char* kDefaultCorrelationBenchmark = "BTCUSDT";
+    static constexpr int kDefaultCorrelationIntervalMs = 5000;
+
+    /**
+     * Chrome trace output for stopTrace: clients only name a file, which is
+     * always written inside kTraceDirectory
+     */
+    static constexpr const char* kTraceDirectory = "traces";
+    static constexpr const char* kDefaultTraceFile = "glora_trace.json";
+
+    /**
+     * Drawing store file, next to the database
+     */
+    static constexpr const char* kDrawingStorePath = "glora_drawings.gldw";
+
     ApiHandler();
     ~ApiHandler();
 
@@ -43,20 +128,44 @@ public:
 
     /**
      * Process incoming message from frontend
+     * @param clientId Connection the message came from
      * @param message JSON message string from frontend
      */
-    void handleMessage(const std::string& message);
+    void handleMessage(int clientId, const std::string& message);
+
+    /**
+     * Drop a disconnected client's subscriptions
+     */
+    void handleClientDisconnected(int clientId);
 
     /**
      * Send a message to all connected frontend clients
      */
     void broadcast(const json& message);
 
+    /**
+     * Send already encoded JSON text to all connected frontend clients
+     */
+    void broadcast(const std::string& message);
+
+    /**
+     * Send a stream frame (tick, DOM update) that a lagging client may miss;
+     * replies always go through broadcast()
+     */
+    void broadcastStream(const std::string& message);
+
     /**
      * Set callback for real-time tick data
      */
     void setOnTickCallback(std::function<void(const core::Tick&)> callback);
 
+    /**
+     * Set where joined synthetic ticks go (the main tick queue); without one
+     * they are applied on the leg socket's thread
+     */
+    using SyntheticTickSink = std::function<void(const std::string& name, const core::Tick&)>;
+    void setSyntheticTickSink(SyntheticTickSink sink);
+
     /**
      * Set callback for quit request
      */
@@ -75,23 +184,53 @@ public:
 private:
     // Message handlers
     void handleGetHistory(const json& message);
+    void handleGetHistoryPage(const json& message);
     void handleGetFootprint(const json& message);
+    void handleGetTimeAndSales(const json& message);
     void handleSubscribe(const json& message);
     void subscribeToLiveUpdates(const std::string& symbol, const std::string& interval);
     void handleGetSmartDOM(const json& message);
+    void handleSubscribeDOM(int clientId, const json& message);
+    void handleUnsubscribeDOM(int clientId, const json& message);
+    void handleSubscribeCorrelation(int clientId, const json& message);
+    void handleUnsubscribeCorrelation(int clientId, const json& message);
+    // Point the shared engine at the union of client subscriptions
+    void applyCorrelationSubscriptionsLocked();
+    void handleSubscribeBookSignals(const json& message);
+    void handleUnsubscribeBookSignals(const json& message);
+    void handleReplayStart(const json& message);
+    void handleReplayControl(const json& message);
+    json buildReplayStateResponse(const core::ReplayEngine::State& state);
+    void handleGetSparklines(const json& message);
+    void handleSetWatchlist(const json& message);
+    void handleCreateSynthetic(const json& message);
+    void handleRemoveSynthetic(const json& message);
+    void updateSyntheticLegs();
+    void handleSaveDrawing(const json& message);
+    void handleDeleteDrawing(const json& message);
+    void handleGetDrawings(const json& message);
+    void handleStartTrace(const json& message);
+    void handleStopTrace(const json& message);
     void handleSetConfig(const json& message);
     void handleGetStatus(const json& message);
+    void handleGetMetrics(const json& message);
     void handleGetTicks(const json& message);
     void handleSaveCredentials(const json& message);
     void handleLoadCredentials(const json& message);
     void handleDeleteCredentials(const json& message);
 
     // Response builders
-    json buildHistoryResponse(const std::vector<core::Candle>& candles);
-    json buildFootprintResponse(const core::Candle& candle);
+    // History: type/symbol/count defaults overridden by `fields`, candles streamed
+    void sendHistoryResponse(const std::vector<core::Candle>& candles, const json& fields);
+    // Footprint: bar fields with the profile streamed
+    void sendFootprintResponse(const std::string& symbol, const std::string& interval, const core::Candle& candle,
+                               const std::string& requestId);
     json buildErrorResponse(const std::string& error);
     json buildStatusResponse();
 
+    // Bar span from candleTime + interval, or explicit startTime/endTime
+    bool getBarRange(const json& message, uint64_t& startTime, uint64_t& endTime, std::string& interval);
+
     // Helper to get response destination
     std::string getRequestId(const json& message);
     std::string getSymbol(const json& message);
@@ -102,12 +241,29 @@ private:
     std::shared_ptr<BinanceClient> binanceClient_;
     std::shared_ptr<WebSocketServer> wsServer_;
     settings::AppSettings settings_;
+    std::unique_ptr<DomStreamPublisher> domPublisher_;
+    std::unique_ptr<BookSignalPublisher> bookSignalPublisher_;
+    size_t liquidityListenerId_ = 0;
+    size_t correlationListenerId_ = 0;
+    struct CorrelationSubscription {
+        std::vector<std::string> symbols;  // Benchmark first
+        uint64_t intervalMs = 0;
+    };
+    std::mutex correlationMutex_;
+    std::map<int, CorrelationSubscription> correlationClients_;  // By client id, oldest first
+    std::atomic<uint64_t> correlationPublishMs_{0};      // 0 when nobody subscribed
+    std::atomic<uint64_t> lastCorrelationPublish_{0};    // Matrix end time last sent
+    std::unique_ptr<core::ReplayEngine> replay_;
+    std::unique_ptr<core::PrefetchManager> prefetch_;
+    std::unique_ptr<database::DrawingStore> drawings_;
 
     // State
     bool isInitialized_ = false;
     std::string currentSymbol_;
     std::string currentInterval_;
     std::function<void(const core::Tick&)> onTickCallback_;
+    SyntheticTickSink syntheticTickSink_;
+    std::unique_ptr<core::ThreadPool> syntheticBuilder_;  // History builds, one at a time
     std::function<void()> onQuitCallback_;
 };
 
@@ -1,5 +1,11 @@
 #include "BinanceClient.h"
+#include "RequestGovernor.h"
+#include "RestDecoders.h"
 #include "../settings/Settings.h"
+#include "../core/MemoryArena.h"
+#include "../core/ThreadAffinity.h"
+#include "../core/Metrics.h"
+#include "../core/Tracing.h"
 #include <iostream>
 #include <ixwebsocket/IXNetSystem.h>
 #include <ixwebsocket/IXWebSocket.h>
@@ -17,18 +23,66 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <map>
+#include <set>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory_resource>
+#include <algorithm>
+#include <cctype>
+#include <istream>
+#include <iterator>
+#include <streambuf>
 
 namespace glora {
 namespace network {
 
+// Feed and REST instrumentation, registered on first use
+struct FeedMetrics {
+  core::Counter& messages;
+  core::Counter& trades;
+  core::Counter& duplicates;
+  core::Counter& parseErrors;
+  core::Counter& socketErrors;
+  core::Counter& connects;
+  core::Histogram& latencyMs;
+  core::Counter& restRequests;
+  core::Counter& restFailures;
+  core::Histogram& restMs;
+};
+
+static FeedMetrics& feedMetrics() {
+  auto& registry = core::MetricsRegistry::getInstance();
+  static FeedMetrics metrics{
+    registry.counter("glora_feed_messages_total", "WebSocket messages received from the exchange"),
+    registry.counter("glora_feed_trades_total", "Trades delivered to the tick pipeline"),
+    registry.counter("glora_feed_duplicates_total", "Trades dropped by ID deduplication"),
+    registry.counter("glora_feed_errors_total", "Feed errors", "kind=\"parse\""),
+    registry.counter("glora_feed_errors_total", "Feed errors", "kind=\"socket\""),
+    registry.counter("glora_feed_connects_total", "Exchange WebSocket (re)connections"),
+    registry.histogram("glora_feed_latency_ms", "Exchange trade time to local receipt",
+                       core::MetricsRegistry::latencyBucketsMs()),
+    registry.counter("glora_rest_requests_total", "REST requests sent to the exchange"),
+    registry.counter("glora_rest_failures_total", "REST requests that returned no usable body"),
+    registry.histogram("glora_rest_request_ms", "REST request round trip",
+                       core::MetricsRegistry::latencyBucketsMs()),
+  };
+  return metrics;
+}
+
+// Parse a decimal string field ("123.45") without copying it out of the json node
+static double parseDecimal(const json& value) {
+  return parseDecimal(value.get_ref<const std::string&>());
+}
+
 // Interval mapping from frontend to Binance API format
 static const std::map<std::string, std::string> INTERVAL_MAP = {
   {"1s", "1s"},
   {"1m", "1m"},
   {"5m", "5m"},
   {"15m", "15m"},
+  {"30m", "30m"},
   {"1h", "1h"},
   {"4h", "4h"},
   {"1D", "1d"},
@@ -46,11 +100,124 @@ static std::string toBinanceInterval(const std::string& interval) {
   return "1m";
 }
 
+// Reads an HTTP/1.1 response from a TLS connection. Header lines are read
+// directly; the body is exposed as a streambuf (de-chunked if needed) whose
+// get area points into the receive buffer, so a decoder reading it works on
+// each TLS record as soon as it arrives.
+class HttpBodyReader : public std::streambuf {
+public:
+  explicit HttpBodyReader(SSL* ssl) : ssl_(ssl), buffer_(kBufferSize) {}
+
+  // One CRLF-terminated line, without the terminator
+  bool readLine(std::string& line) {
+    while (true) {
+      const char* begin = buffer_.data() + begin_;
+      const char* end = buffer_.data() + end_;
+      for (const char* p = begin; p + 1 < end; ++p) {
+        if (p[0] == '\r' && p[1] == '\n') {
+          line.assign(begin, p);
+          begin_ += static_cast<size_t>(p - begin) + 2;
+          return true;
+        }
+      }
+      if (!fill()) return false;
+    }
+  }
+
+  // Body framing from the headers; contentLength < 0 means read to close
+  void beginBody(bool chunked, int64_t contentLength) {
+    chunked_ = chunked;
+    remaining_ = contentLength;
+  }
+
+protected:
+  int_type underflow() override {
+    if (done_) return traits_type::eof();
+
+    if (chunked_ && remaining_ <= 0) {
+      // Chunk header: "<hex size>[;ext]", preceded by the previous chunk's CRLF
+      std::string line;
+      if (!readLine(line)) return finish();
+      if (line.empty() && !readLine(line)) return finish();
+      remaining_ = std::strtoll(line.c_str(), nullptr, 16);
+      if (remaining_ <= 0) return finish();
+    } else if (!chunked_ && remaining_ == 0) {
+      return finish();
+    }
+
+    if (begin_ == end_ && !fill()) return finish();
+
+    size_t available = end_ - begin_;
+    size_t n = remaining_ > 0 ? std::min(available, static_cast<size_t>(remaining_)) : available;
+    if (remaining_ > 0) remaining_ -= static_cast<int64_t>(n);
+
+    char* data = buffer_.data() + begin_;
+    begin_ += n;
+    setg(data, data, data + n);
+    return traits_type::to_int_type(*data);
+  }
+
+private:
+  static constexpr size_t kBufferSize = 64 * 1024;
+
+  int_type finish() {
+    done_ = true;
+    return traits_type::eof();
+  }
+
+  // Read more from the connection; unread bytes move to the front first
+  bool fill() {
+    if (begin_ > 0) {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    if (end_ == buffer_.size()) return false;
+    int bytesRead = SSL_read(ssl_, buffer_.data() + end_, static_cast<int>(buffer_.size() - end_));
+    if (bytesRead <= 0) return false;
+    end_ += static_cast<size_t>(bytesRead);
+    return true;
+  }
+
+  SSL* ssl_;
+  std::vector<char> buffer_;
+  size_t begin_ = 0;        // Unread data is [begin_, end_)
+  size_t end_ = 0;
+  bool chunked_ = false;
+  int64_t remaining_ = -1;  // Bytes left in the chunk or body; -1 until close
+  bool done_ = false;
+};
+
 struct BinanceClient::Impl {
   ix::WebSocket webSocket;
   std::string activeSymbol;
   OnTickCallback onTick;
   
+  // Order book diffs run on their own connection so a busy book never
+  // delays trades
+  ix::WebSocket depthSocket;
+  std::string depthSymbol;
+  OnDepthCallback onDepth;
+  
+  // All-symbol miniTicker batches, also on their own connection
+  ix::WebSocket tickerSocket;
+  OnMiniTickersCallback onMiniTickers;
+  
+  // Background aggTrades for prefetched symbols and synthetic legs on one
+  // combined stream
+  ix::WebSocket backgroundSocket;
+  std::mutex backgroundMutex;
+  std::vector<std::string> backgroundStreams;  // Sorted "<symbol>@aggTrade", union of consumers
+  bool backgroundStarted = false;
+  int backgroundRequestId = 0;
+  // Own lock: stop() joins the socket thread, which may be in the callback
+  std::mutex backgroundTickMutex;
+  struct BackgroundConsumer {
+    std::set<std::string> symbols;
+    OnSymbolTickCallback onTick;
+  };
+  std::map<std::string, BackgroundConsumer> backgroundConsumers;
+  
   // User API configuration
   std::string apiKey;
   std::string apiSecret;
@@ -64,6 +231,17 @@ struct BinanceClient::Impl {
     return useTestnet ? "wss://testnet.binance.vision/ws" : "wss://stream.binance.com:9443/ws";
   }
   
+  // Combined streams: /stream?streams=a@aggTrade/b@aggTrade
+  std::string getCombinedWsUrl(const std::vector<std::string>& streams) const {
+    std::string url = useTestnet ? "wss://testnet.binance.vision/stream?streams="
+                                 : "wss://stream.binance.com:9443/stream?streams=";
+    for (size_t i = 0; i < streams.size(); ++i) {
+      if (i > 0) url += "/";
+      url += streams[i];
+    }
+    return url;
+  }
+  
   // Generate HMAC SHA256 signature for API requests
   std::string generateSignature(const std::string& queryString) const {
     unsigned char digest[SHA256_DIGEST_LENGTH];
@@ -81,25 +259,91 @@ struct BinanceClient::Impl {
     return ss.str();
   }
   
-  // Simple HTTPS GET using OpenSSL
+  // Consumes the body of a 2xx response; false if it could not be decoded
+  using BodyParser = std::function<bool(std::istream&)>;
+  
+  struct HttpResponse {
+    int status = 0;                              // 0 when the request never completed
+    std::map<std::string, std::string> headers;  // Lower-case names
+    std::string body;                            // Error bodies only when a parser is given
+    bool parsed = false;
+  };
+  
+  // A throttled request is retried after the governor's backoff this many times
+  static constexpr int kMaxThrottleRetries = 3;
+  
+  // HTTPS GET through the request governor. The body of a 2xx response is
+  // handed to `parse` while it downloads. Returns true when it was parsed.
+  bool httpsFetch(const std::string& host, const std::string& path, const std::string& apiKeyHeader,
+                  const BodyParser& parse) {
+    GLORA_TRACE_SCOPE("rest", "httpsFetch");
+    auto& metrics = feedMetrics();
+    auto& governor = RequestGovernor::getInstance();
+    int weight = RequestGovernor::weightFor(path);
+    RequestPriority priority = ScopedRequestPriority::current();
+    
+    for (int attempt = 0; attempt <= kMaxThrottleRetries; ++attempt) {
+      governor.acquire(weight, priority);
+      metrics.restRequests.inc();
+      
+      HttpResponse response;
+      {
+        core::ScopedTimer timer(metrics.restMs);
+        response = httpsRequest(host, path, apiKeyHeader, parse);
+      }
+      bool retry = governor.complete(weight, response.status, response.headers);
+      
+      if (response.parsed) {
+        return true;
+      }
+      metrics.restFailures.inc();
+      if (response.status != 0) {
+        std::cerr << "[BinanceClient] HTTP " << response.status << " for "
+                  << path.substr(0, path.find('?')) << ": " << response.body.substr(0, 200) << std::endl;
+      }
+      if (!retry) break;
+    }
+    return false;
+  }
+  
+  // Whole body of a 2xx response, or an empty string
   std::string httpsGet(const std::string& host, const std::string& path, const std::string& apiKeyHeader = "") {
-    std::string response;
+    std::string body;
+    httpsFetch(host, path, apiKeyHeader, [&body](std::istream& in) {
+      body.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      return !body.empty();
+    });
+    return body;
+  }
+  
+  // SAX-decode a 2xx JSON body as it arrives
+  template <typename Decoder>
+  bool httpsGetJson(const std::string& host, const std::string& path, const std::string& apiKeyHeader,
+                    Decoder& decoder) {
+    return httpsFetch(host, path, apiKeyHeader, [&decoder](std::istream& in) {
+      return json::sax_parse(in, &decoder);
+    });
+  }
+  
+  HttpResponse httpsRequest(const std::string& host, const std::string& path, const std::string& apiKeyHeader,
+                            const BodyParser& parse) {
+    HttpResponse result;
     
     SSL_library_init();
     SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
-    if (!ctx) return response;
+    if (!ctx) return result;
     
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock < 0) {
       SSL_CTX_free(ctx);
-      return response;
+      return result;
     }
     
     struct hostent* server = gethostbyname(host.c_str());
     if (!server) {
       close(sock);
       SSL_CTX_free(ctx);
-      return response;
+      return result;
     }
     
     struct sockaddr_in serv_addr;
@@ -111,7 +355,7 @@ struct BinanceClient::Impl {
     if (connect(sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
       close(sock);
       SSL_CTX_free(ctx);
-      return response;
+      return result;
     }
     
     SSL* ssl = SSL_new(ctx);
@@ -121,7 +365,7 @@ struct BinanceClient::Impl {
       SSL_free(ssl);
       close(sock);
       SSL_CTX_free(ctx);
-      return response;
+      return result;
     }
     
     // Build HTTP request
@@ -138,24 +382,47 @@ struct BinanceClient::Impl {
     std::string requestStr = request.str();
     SSL_write(ssl, requestStr.c_str(), requestStr.length());
     
-    // Read response
-    char buffer[4096];
-    int bytesRead;
-    while ((bytesRead = SSL_read(ssl, buffer, sizeof(buffer) - 1)) > 0) {
-      buffer[bytesRead] = 0;
-      response += buffer;
-    }
+    readResponse(ssl, result, parse);
     
     SSL_free(ssl);
     close(sock);
     SSL_CTX_free(ctx);
+    return result;
+  }
+  
+  void readResponse(SSL* ssl, HttpResponse& result, const BodyParser& parse) {
+    HttpBodyReader reader(ssl);
     
-    // Extract body from HTTP response
-    size_t bodyStart = response.find("\r\n\r\n");
-    if (bodyStart != std::string::npos) {
-      return response.substr(bodyStart + 4);
+    // Status line: "HTTP/1.1 200 OK"
+    std::string line;
+    if (!reader.readLine(line)) return;
+    size_t statusStart = line.find(' ');
+    if (statusStart == std::string::npos) return;
+    int status = std::atoi(line.c_str() + statusStart + 1);
+    
+    // Headers, needed for the used-weight, Retry-After and body framing
+    while (reader.readLine(line) && !line.empty()) {
+      size_t colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      std::string name = line.substr(0, colon);
+      std::transform(name.begin(), name.end(), name.begin(),
+                     [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+      size_t valueStart = line.find_first_not_of(' ', colon + 1);
+      result.headers[name] = valueStart == std::string::npos ? "" : line.substr(valueStart);
+    }
+    result.status = status;
+    
+    auto encoding = result.headers.find("transfer-encoding");
+    auto length = result.headers.find("content-length");
+    reader.beginBody(encoding != result.headers.end() && encoding->second.find("chunked") != std::string::npos,
+                     length != result.headers.end() ? std::strtoll(length->second.c_str(), nullptr, 10) : -1);
+    
+    std::istream body(&reader);
+    if (status >= 200 && status < 300) {
+      result.parsed = parse(body);
+    } else {
+      result.body.assign(std::istreambuf_iterator<char>(body), std::istreambuf_iterator<char>());
     }
-    return response;
   }
 };
 
@@ -193,21 +460,77 @@ void BinanceClient::fetchHistoricalAggTrades(
     const std::string &symbol, uint64_t startTime, uint64_t endTime,
     std::function<void(const std::vector<core::Tick> &)> onDataCallback) {
   
+  const uint64_t chunkSize = 1000 * 1000; // ~16 minutes per time window
+  
+  // Windows are independent, so several run at once; the request governor
+  // keeps the combined rate inside the exchange's weight limit. Results are
+  // joined in window order.
+  size_t chunkCount = endTime > startTime ? (endTime - startTime + chunkSize - 1) / chunkSize : 0;
+  std::vector<std::vector<core::Tick>> chunks(chunkCount);
+  std::atomic<size_t> nextChunk{0};
+  RequestPriority priority = ScopedRequestPriority::current();
+  
+  auto worker = [&]() {
+    ScopedRequestPriority scopedPriority(priority);
+    for (size_t i = nextChunk++; i < chunkCount; i = nextChunk++) {
+      uint64_t chunkStart = startTime + i * chunkSize;
+      uint64_t chunkEnd = std::min(chunkStart + chunkSize - 1, endTime);
+      fetchAggTradesWindow(symbol, chunkStart, chunkEnd, chunks[i]);
+    }
+  };
+  
+  size_t workerCount = std::min(kBackfillWorkers, chunkCount);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < workerCount; ++i) {
+    workers.emplace_back([&worker]() {
+      core::applyThreadRole(settings::ThreadRole::BACKGROUND, "glora-backfill");
+      worker();
+    });
+  }
+  worker();
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  
   std::vector<core::Tick> allTicks;
-  uint64_t currentStart = startTime;
-  const uint64_t maxLimit = 1000; // Binance API limit per request
-  const uint64_t chunkSize = maxLimit * 1000; // ~1 second worth of trades
+  size_t total = 0;
+  for (const auto& chunk : chunks) total += chunk.size();
+  allTicks.reserve(total);
+  for (const auto& chunk : chunks) {
+    allTicks.insert(allTicks.end(), chunk.begin(), chunk.end());
+  }
+  
+  if (onDataCallback) {
+    onDataCallback(allTicks);
+  }
+}
+
+void BinanceClient::fetchAggTradesWindow(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                                         std::vector<core::Tick>& out) {
+  GLORA_TRACE_SCOPE("rest", "fetchAggTradesWindow");
+  const int64_t maxLimit = 1000; // Binance API limit per request
   
-  while (currentStart < endTime) {
-    uint64_t currentEnd = std::min(currentStart + chunkSize, endTime);
+  // Decoded trades for one page live here until they are appended to out;
+  // the arena is rewound for every page so its blocks are reused
+  core::ScratchArena pageArena(core::AllocSubsystem::RestPage, maxLimit * sizeof(core::Tick) + 1024);
+  
+  // The first page is by time. A full page means the window holds more
+  // trades than one request returns, so continue by ID until we pass the
+  // window end instead of silently dropping the rest.
+  int64_t nextId = -1;
+  while (true) {
+    core::ArenaScope pageScope(pageArena, core::AllocSubsystem::RestPage);
     
-    // Build query string
     std::stringstream ss;
     ss << "/api/v3/aggTrades?"
-       << "symbol=" << symbol 
-       << "&startTime=" << currentStart
-       << "&endTime=" << currentEnd
-       << "&limit=" << maxLimit;
+       << "symbol=" << symbol;
+    if (nextId < 0) {
+      ss << "&startTime=" << startTime
+         << "&endTime=" << endTime;
+    } else {
+      ss << "&fromId=" << nextId;
+    }
+    ss << "&limit=" << maxLimit;
     std::string queryStr = ss.str();
     
     std::string path = queryStr;
@@ -218,36 +541,79 @@ void BinanceClient::fetchHistoricalAggTrades(
       path = queryStr + "&signature=" + signature;
     }
     
-    // Make request using HTTPS
+    // Trades are decoded straight into the page while it downloads
+    std::pmr::vector<core::Tick> pageTicks(pageScope.resource());
+    pageTicks.reserve(maxLimit);
+    AggTradeDecoder decoder(pageTicks);
+    
     std::string apiKeyHeader = hasApiConfig_ ? pImpl->apiKey : "";
-    std::string response = pImpl->httpsGet(pImpl->getBaseUrl(), path, apiKeyHeader);
+    if (!pImpl->httpsGetJson(pImpl->getBaseUrl(), path, apiKeyHeader, decoder)) {
+      std::cerr << "Failed to fetch historical trades from " << startTime << " to " << endTime
+                << (decoder.error.empty() ? "" : ": " + decoder.error) << std::endl;
+      return;
+    }
     
-    if (!response.empty()) {
-      try {
-        auto j = json::parse(response);
-        
-        if (j.is_array()) {
-          for (const auto& trade : j) {
-            core::Tick tick;
-            tick.timestamp_ms = trade["T"].get<uint64_t>();
-            tick.price = std::stod(trade["p"].get<std::string>());
-            tick.quantity = std::stod(trade["q"].get<std::string>());
-            tick.is_buyer_maker = trade["m"].get<bool>();
-            allTicks.push_back(tick);
-          }
-          
-          std::cout << "Fetched " << j.size() << " trades from " 
-                    << currentStart << " to " << currentEnd << std::endl;
-        }
-        
-      } catch (const std::exception& e) {
-        std::cerr << "Error parsing historical trades: " << e.what() << std::endl;
-      }
-    } else {
-      std::cerr << "Failed to fetch historical trades (empty response)" << std::endl;
+    auto pastEnd = std::find_if(pageTicks.begin(), pageTicks.end(),
+                                [endTime](const core::Tick& tick) { return tick.timestamp_ms > endTime; });
+    out.insert(out.end(), pageTicks.begin(), pastEnd);
+    
+    if (pastEnd != pageTicks.end() || static_cast<int64_t>(decoder.count()) < maxLimit) {
+      std::cout << "Fetched " << out.size() << " trades from " 
+                << startTime << " to " << endTime << std::endl;
+      return;
+    }
+    nextId = decoder.lastId() + 1;
+  }
+}
+
+void BinanceClient::fetchAggTradesById(
+    const std::string &symbol, int64_t fromId, int64_t toId,
+    std::function<void(const std::vector<core::Tick> &)> onDataCallback) {
+  GLORA_TRACE_SCOPE("rest", "fetchAggTradesById");
+  
+  std::vector<core::Tick> allTicks;
+  const int64_t maxLimit = 1000; // Binance API limit per request
+  int64_t nextId = fromId;
+  
+  core::ScratchArena pageArena(core::AllocSubsystem::RestPage, maxLimit * sizeof(core::Tick) + 1024);
+  
+  while (nextId <= toId) {
+    core::ArenaScope pageScope(pageArena, core::AllocSubsystem::RestPage);
+    
+    // fromId pages are exact: no time window, no overlap between requests
+    int64_t limit = std::min(maxLimit, toId - nextId + 1);
+    std::stringstream ss;
+    ss << "/api/v3/aggTrades?"
+       << "symbol=" << symbol 
+       << "&fromId=" << nextId
+       << "&limit=" << limit;
+    std::string queryStr = ss.str();
+    
+    std::string path = queryStr;
+    if (hasApiConfig_) {
+      path = queryStr + "&signature=" + pImpl->generateSignature(queryStr);
+    }
+    
+    std::pmr::vector<core::Tick> pageTicks(pageScope.resource());
+    pageTicks.reserve(limit);
+    AggTradeDecoder decoder(pageTicks);
+    
+    std::string apiKeyHeader = hasApiConfig_ ? pImpl->apiKey : "";
+    if (!pImpl->httpsGetJson(pImpl->getBaseUrl(), path, apiKeyHeader, decoder)) {
+      std::cerr << "Failed to fetch trades from id " << nextId
+                << (decoder.error.empty() ? "" : ": " + decoder.error) << std::endl;
+      break;
+    }
+    if (decoder.count() == 0) {
+      break;
     }
     
-    currentStart = currentEnd + 1;
+    auto pastEnd = std::find_if(pageTicks.begin(), pageTicks.end(),
+                                [toId](const core::Tick& tick) { return tick.trade_id > toId; });
+    allTicks.insert(allTicks.end(), pageTicks.begin(), pastEnd);
+    
+    std::cout << "Fetched trades " << nextId << " - " << decoder.lastId() << std::endl;
+    nextId = decoder.lastId() + 1;
   }
   
   if (onDataCallback) {
@@ -255,13 +621,35 @@ void BinanceClient::fetchHistoricalAggTrades(
   }
 }
 
-void BinanceClient::fetchKlines(const std::string& symbol, const std::string& interval,
+int64_t BinanceClient::fetchLatestAggTradeId(const std::string &symbol) {
+  GLORA_TRACE_SCOPE("rest", "fetchLatestAggTradeId");
+  
+  std::string queryStr = "/api/v3/aggTrades?symbol=" + symbol + "&limit=1";
+  std::string path = queryStr;
+  if (hasApiConfig_) {
+    path = queryStr + "&signature=" + pImpl->generateSignature(queryStr);
+  }
+  
+  std::pmr::vector<core::Tick> ticks;
+  AggTradeDecoder decoder(ticks);
+  std::string apiKeyHeader = hasApiConfig_ ? pImpl->apiKey : "";
+  if (!pImpl->httpsGetJson(pImpl->getBaseUrl(), path, apiKeyHeader, decoder) || decoder.count() == 0) {
+    std::cerr << "Failed to fetch latest trade for " << symbol
+              << (decoder.error.empty() ? "" : ": " + decoder.error) << std::endl;
+    return 0;
+  }
+  return decoder.lastId();
+}
+
+bool BinanceClient::fetchKlines(const std::string& symbol, const std::string& interval,
                                  uint64_t startTime, uint64_t endTime,
                                  std::function<void(const std::vector<core::Candle>&)> onDataCallback) {
+  GLORA_TRACE_SCOPE("rest", "fetchKlines");
   
   // Convert interval to Binance format
   std::string binanceInterval = toBinanceInterval(interval);
   
+  core::ScopedAllocTag pageTag(core::AllocSubsystem::RestPage);
   std::vector<core::Candle> candles;
   
   // Build query string
@@ -281,45 +669,30 @@ void BinanceClient::fetchKlines(const std::string& symbol, const std::string& in
     path = queryStr + "&signature=" + signature;
   }
   
-  // Make request using HTTPS
-  std::string apiKeyHeader = hasApiConfig_ ? pImpl->apiKey : "";
-  std::string response = pImpl->httpsGet(pImpl->getBaseUrl(), path, apiKeyHeader);
+  // Candles are decoded while the response downloads
+  candles.reserve(1000);
+  KlineDecoder decoder(candles);
   
-  if (!response.empty()) {
-    try {
-      auto j = json::parse(response);
-      
-      if (j.is_array()) {
-        for (const auto& kline : j) {
-          core::Candle candle;
-          candle.start_time_ms = kline[0].get<uint64_t>();
-          candle.end_time_ms = kline[6].get<uint64_t>();
-          candle.open = std::stod(kline[1].get<std::string>());
-          candle.high = std::stod(kline[2].get<std::string>());
-          candle.low = std::stod(kline[3].get<std::string>());
-          candle.close = std::stod(kline[4].get<std::string>());
-          candle.volume = std::stod(kline[5].get<std::string>());
-          candles.push_back(candle);
-        }
-        
-        std::cout << "Fetched " << candles.size() << " klines" << std::endl;
-      }
-      
-    } catch (const std::exception& e) {
-      std::cerr << "Error parsing klines: " << e.what() << std::endl;
-    }
+  std::string apiKeyHeader = hasApiConfig_ ? pImpl->apiKey : "";
+  bool ok = pImpl->httpsGetJson(pImpl->getBaseUrl(), path, apiKeyHeader, decoder);
+  if (ok) {
+    std::cout << "Fetched " << candles.size() << " klines" << std::endl;
   } else {
-    std::cerr << "Failed to fetch klines (empty response)" << std::endl;
+    std::cerr << "Failed to fetch klines" << (decoder.error.empty() ? "" : ": " + decoder.error) << std::endl;
+    candles.clear();
   }
   
   if (onDataCallback) {
     onDataCallback(candles);
   }
+  return ok;
 }
 
 void BinanceClient::fetchDepth(const std::string& symbol, int limit,
                                std::function<void(const std::vector<std::pair<double, double>>& bids,
                                                  const std::vector<std::pair<double, double>>& asks)> onDataCallback) {
+  GLORA_TRACE_SCOPE("rest", "fetchDepth");
+  core::ScopedAllocTag pageTag(core::AllocSubsystem::RestPage);
   std::vector<std::pair<double, double>> bids;
   std::vector<std::pair<double, double>> asks;
   
@@ -345,8 +718,8 @@ void BinanceClient::fetchDepth(const std::string& symbol, int limit,
       // Parse bids
       if (j.contains("bids") && j["bids"].is_array()) {
         for (const auto& bid : j["bids"]) {
-          double price = std::stod(bid[0].get<std::string>());
-          double quantity = std::stod(bid[1].get<std::string>());
+          double price = parseDecimal(bid[0]);
+          double quantity = parseDecimal(bid[1]);
           bids.emplace_back(price, quantity);
         }
       }
@@ -354,8 +727,8 @@ void BinanceClient::fetchDepth(const std::string& symbol, int limit,
       // Parse asks
       if (j.contains("asks") && j["asks"].is_array()) {
         for (const auto& ask : j["asks"]) {
-          double price = std::stod(ask[0].get<std::string>());
-          double quantity = std::stod(ask[1].get<std::string>());
+          double price = parseDecimal(ask[0]);
+          double quantity = parseDecimal(ask[1]);
           asks.emplace_back(price, quantity);
         }
       }
@@ -400,7 +773,11 @@ void BinanceClient::subscribeAggTrades(const std::string &symbol,
   // Setup message handler with buffering and deduplication support
   pImpl->webSocket.setOnMessageCallback(
       [this](const ix::WebSocketMessagePtr &msg) {
+        core::applyThreadRoleOnce(settings::ThreadRole::FEED, "glora-feed");
+        auto& metrics = feedMetrics();
         if (msg->type == ix::WebSocketMessageType::Message) {
+          core::ScopedAllocTag tickTag(core::AllocSubsystem::Tick);
+          metrics.messages.inc();
           try {
             auto j = json::parse(msg->str);
 
@@ -421,10 +798,12 @@ void BinanceClient::subscribeAggTrades(const std::string &symbol,
               if (tradeId > 0) {
                 if (tradeId <= lastRestTradeId_) {
                   // Skip - this trade was already fetched via REST
+                  metrics.duplicates.inc();
                   return;
                 }
                 if (seenTradeIds_.count(tradeId) > 0) {
                   // Skip - duplicate
+                  metrics.duplicates.inc();
                   return;
                 }
                 seenTradeIds_.insert(tradeId);
@@ -432,31 +811,227 @@ void BinanceClient::subscribeAggTrades(const std::string &symbol,
 
               core::Tick tick;
               tick.timestamp_ms = j["T"].get<uint64_t>();
-              tick.price = std::stod(j["p"].get<std::string>());
-              tick.quantity = std::stod(j["q"].get<std::string>());
+              tick.price = parseDecimal(j["p"]);
+              tick.quantity = parseDecimal(j["q"]);
               tick.is_buyer_maker = j["m"].get<bool>();
+              tick.trade_id = tradeId;
+              
+              // Covered by the REST history the stream was bootstrapped from
+              if (tick.timestamp_ms <= lastRestTimeMs_) {
+                metrics.duplicates.inc();
+                return;
+              }
+
+              uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count();
+              if (nowMs >= tick.timestamp_ms) {
+                metrics.latencyMs.observe(static_cast<double>(nowMs - tick.timestamp_ms));
+              }
+              metrics.trades.inc();
 
               if (pImpl->onTick) {
                 pImpl->onTick(tick);
               }
             }
           } catch (const json::parse_error &e) {
+            metrics.parseErrors.inc();
             std::cerr << "JSON Parse error: " << e.what()
                       << "\nMessage: " << msg->str << std::endl;
           } catch (const std::exception &e) {
+            metrics.parseErrors.inc();
             std::cerr << "Error parsing tick: " << e.what() << std::endl;
           }
         } else if (msg->type == ix::WebSocketMessageType::Open) {
+          metrics.connects.inc();
           std::cout << "Connected to Binance Websocket: " << pImpl->activeSymbol
                     << std::endl;
         } else if (msg->type == ix::WebSocketMessageType::Error) {
+          metrics.socketErrors.inc();
           std::cerr << "Websocket Error: " << msg->errorInfo.reason
                     << std::endl;
         }
       });
 }
 
+void BinanceClient::subscribeDepth(const std::string& symbol, OnDepthCallback callback) {
+  pImpl->depthSymbol = symbol;
+  pImpl->onDepth = std::move(callback);
+  
+  // wss://stream.binance.com:9443/ws/<symbol>@depth@100ms
+  std::string lowerSymbol = symbol;
+  for (auto &c : lowerSymbol)
+    c = std::tolower(c);
+  
+  pImpl->depthSocket.setUrl(pImpl->getWsUrl() + "/" + lowerSymbol + "@depth@100ms");
+  
+  pImpl->depthSocket.setOnMessageCallback(
+      [this](const ix::WebSocketMessagePtr &msg) {
+        core::applyThreadRoleOnce(settings::ThreadRole::FEED, "glora-depth");
+        auto& metrics = feedMetrics();
+        if (msg->type == ix::WebSocketMessageType::Message) {
+          metrics.messages.inc();
+          try {
+            auto j = json::parse(msg->str);
+            if (!j.contains("e") || j["e"] != "depthUpdate") {
+              return;
+            }
+            
+            std::vector<std::pair<double, double>> bids;
+            std::vector<std::pair<double, double>> asks;
+            if (j.contains("b") && j["b"].is_array()) {
+              bids.reserve(j["b"].size());
+              for (const auto& level : j["b"]) {
+                bids.emplace_back(parseDecimal(level[0]), parseDecimal(level[1]));
+              }
+            }
+            if (j.contains("a") && j["a"].is_array()) {
+              asks.reserve(j["a"].size());
+              for (const auto& level : j["a"]) {
+                asks.emplace_back(parseDecimal(level[0]), parseDecimal(level[1]));
+              }
+            }
+            
+            if (pImpl->onDepth) {
+              pImpl->onDepth(bids, asks);
+            }
+          } catch (const std::exception &e) {
+            metrics.parseErrors.inc();
+            std::cerr << "Error parsing depth update: " << e.what() << std::endl;
+          }
+        } else if (msg->type == ix::WebSocketMessageType::Open) {
+          metrics.connects.inc();
+          std::cout << "Connected to Binance depth stream: " << pImpl->depthSymbol << std::endl;
+        } else if (msg->type == ix::WebSocketMessageType::Error) {
+          metrics.socketErrors.inc();
+          std::cerr << "Depth Websocket Error: " << msg->errorInfo.reason << std::endl;
+        }
+      });
+}
+
+void BinanceClient::setBackgroundAggTrades(const std::string& consumer, const std::vector<std::string>& symbols,
+                                           OnSymbolTickCallback callback) {
+  std::lock_guard<std::mutex> lock(pImpl->backgroundMutex);
+  
+  // The connection carries the union of every consumer's symbols
+  std::vector<std::string> streams;
+  {
+    std::lock_guard<std::mutex> tickLock(pImpl->backgroundTickMutex);
+    if (symbols.empty()) {
+      pImpl->backgroundConsumers.erase(consumer);
+    } else {
+      auto& entry = pImpl->backgroundConsumers[consumer];
+      entry.symbols = std::set<std::string>(symbols.begin(), symbols.end());
+      entry.onTick = std::move(callback);
+    }
+    for (const auto& [name, entry] : pImpl->backgroundConsumers) {
+      for (const auto& symbol : entry.symbols) {
+        std::string stream = symbol;
+        for (auto &c : stream)
+          c = std::tolower(c);
+        streams.push_back(stream + "@aggTrade");
+      }
+    }
+  }
+  std::sort(streams.begin(), streams.end());
+  streams.erase(std::unique(streams.begin(), streams.end()), streams.end());
+  
+  if (streams == pImpl->backgroundStreams) return;
+  
+  if (streams.empty()) {
+    pImpl->backgroundStreams.clear();
+    if (pImpl->backgroundStarted) {
+      pImpl->backgroundSocket.stop();
+      pImpl->backgroundStarted = false;
+    }
+    return;
+  }
+  
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  std::set_difference(streams.begin(), streams.end(), pImpl->backgroundStreams.begin(),
+                      pImpl->backgroundStreams.end(), std::back_inserter(added));
+  std::set_difference(pImpl->backgroundStreams.begin(), pImpl->backgroundStreams.end(),
+                      streams.begin(), streams.end(), std::back_inserter(removed));
+  pImpl->backgroundStreams = streams;
+  
+  // Reconnects use the URL, so it always carries the full set
+  pImpl->backgroundSocket.setUrl(pImpl->getCombinedWsUrl(streams));
+  
+  if (!pImpl->backgroundStarted) {
+    pImpl->backgroundSocket.setOnMessageCallback(
+        [this](const ix::WebSocketMessagePtr &msg) {
+          core::applyThreadRoleOnce(settings::ThreadRole::FEED, "glora-feed-bg");
+          auto& metrics = feedMetrics();
+          if (msg->type == ix::WebSocketMessageType::Message) {
+            core::ScopedAllocTag tickTag(core::AllocSubsystem::Tick);
+            metrics.messages.inc();
+            try {
+              // {"stream":"btcusdt@aggTrade","data":{...}}; SUBSCRIBE replies have no data
+              auto j = json::parse(msg->str);
+              if (!j.contains("data")) return;
+              const auto& data = j["data"];
+              if (!data.contains("e") || data["e"] != "aggTrade") return;
+              
+              core::Tick tick;
+              tick.timestamp_ms = data["T"].get<uint64_t>();
+              tick.price = parseDecimal(data["p"]);
+              tick.quantity = parseDecimal(data["q"]);
+              tick.is_buyer_maker = data["m"].get<bool>();
+              tick.trade_id = data.value("a", int64_t{0});
+              metrics.trades.inc();
+              
+              // Only the consumers that asked for the symbol
+              std::string symbol = data["s"].get<std::string>();
+              std::vector<OnSymbolTickCallback> targets;
+              {
+                std::lock_guard<std::mutex> lock(pImpl->backgroundTickMutex);
+                for (const auto& [name, entry] : pImpl->backgroundConsumers) {
+                  if (entry.onTick && entry.symbols.count(symbol)) {
+                    targets.push_back(entry.onTick);
+                  }
+                }
+              }
+              for (const auto& onTick : targets) {
+                onTick(symbol, tick);
+              }
+            } catch (const std::exception &e) {
+              metrics.parseErrors.inc();
+              std::cerr << "Error parsing background trade: " << e.what() << std::endl;
+            }
+          } else if (msg->type == ix::WebSocketMessageType::Open) {
+            metrics.connects.inc();
+            std::cout << "Connected to background trade stream" << std::endl;
+          } else if (msg->type == ix::WebSocketMessageType::Error) {
+            metrics.socketErrors.inc();
+            std::cerr << "Background Websocket Error: " << msg->errorInfo.reason << std::endl;
+          }
+        });
+    pImpl->backgroundSocket.start();
+    pImpl->backgroundStarted = true;
+    return;
+  }
+  
+  if (pImpl->backgroundSocket.getReadyState() == ix::ReadyState::Open) {
+    if (!removed.empty()) {
+      json request = {{"method", "UNSUBSCRIBE"}, {"params", removed}, {"id", ++pImpl->backgroundRequestId}};
+      pImpl->backgroundSocket.send(request.dump());
+    }
+    if (!added.empty()) {
+      json request = {{"method", "SUBSCRIBE"}, {"params", added}, {"id", ++pImpl->backgroundRequestId}};
+      pImpl->backgroundSocket.send(request.dump());
+    }
+  }
+}
+
 void BinanceClient::connectAndRun() {
+  if (!pImpl->depthSymbol.empty()) {
+    pImpl->depthSocket.start();
+  }
+  
+  if (pImpl->onMiniTickers) {
+    pImpl->tickerSocket.start();
+  }
+  
   if (!pImpl->activeSymbol.empty()) {
     std::cout << "Starting websocket connection..." << std::endl;
     // start() runs automatically in a background thread provided by ixwebsocket
@@ -471,6 +1046,18 @@ void BinanceClient::shutdown() {
   std::cout << "Shutting down Binance Client..." << std::endl;
   stopHeartbeat();  // Stop heartbeat on shutdown
   pImpl->webSocket.stop();
+  pImpl->depthSocket.stop();
+  pImpl->tickerSocket.stop();
+  {
+    std::lock_guard<std::mutex> lock(pImpl->backgroundMutex);
+    pImpl->backgroundSocket.stop();
+    pImpl->backgroundStarted = false;
+    pImpl->backgroundStreams.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(pImpl->backgroundTickMutex);
+    pImpl->backgroundConsumers.clear();
+  }
   ix::uninitNetSystem();
 }
 
@@ -504,9 +1091,13 @@ void BinanceClient::flushBuffer() {
       try {
         core::Tick tick;
         tick.timestamp_ms = msg["T"].get<uint64_t>();
-        tick.price = std::stod(msg["p"].get<std::string>());
-        tick.quantity = std::stod(msg["q"].get<std::string>());
+        tick.price = parseDecimal(msg["p"]);
+        tick.quantity = parseDecimal(msg["q"]);
         tick.is_buyer_maker = msg["m"].get<bool>();
+        tick.trade_id = msg.value("a", int64_t{0});
+        if (tick.timestamp_ms <= lastRestTimeMs_) {
+          continue;
+        }
         pImpl->onTick(tick);
       } catch (const std::exception& e) {
         std::cerr << "Error processing buffered tick: " << e.what() << std::endl;
@@ -534,6 +1125,7 @@ void BinanceClient::startHeartbeat(uint32_t intervalSeconds) {
   heartbeatRunning_ = true;
   
   heartbeatThread_ = std::thread([this, intervalSeconds]() {
+    core::applyThreadRole(settings::ThreadRole::BACKGROUND, "glora-heartbeat");
     std::cout << "[Heartbeat] Started with interval: " << intervalSeconds << "s" << std::endl;
     
     while (heartbeatRunning_) {
@@ -567,65 +1159,25 @@ bool BinanceClient::isConnected() const {
 }
 
 void BinanceClient::fetchExchangeInfo(OnSymbolsCallback onDataCallback) {
+  GLORA_TRACE_SCOPE("rest", "fetchExchangeInfo");
   std::vector<core::Symbol> symbols;
+  symbols.reserve(4096);
   
-  // Call the exchange info endpoint
+  // The document is several MB; symbols are decoded as it downloads rather
+  // than after parsing it into a DOM
   std::string path = "/api/v3/exchangeInfo";
-  std::string response = pImpl->httpsGet(pImpl->getBaseUrl(), path, "");
+  ExchangeInfoDecoder decoder(symbols);
   
-  if (!response.empty()) {
-    try {
-      auto j = json::parse(response);
-      
-      if (j.contains("symbols") && j["symbols"].is_array()) {
-        for (const auto& sym : j["symbols"]) {
-          core::Symbol symbol;
-          symbol.symbol = sym.value("symbol", "");
-          symbol.baseAsset = sym.value("baseAsset", "");
-          symbol.quoteAsset = sym.value("quoteAsset", "");
-          symbol.status = sym.value("status", "");
-          
-          // Get permissions as string
-          if (sym.contains("permissions") && sym["permissions"].is_array()) {
-            for (const auto& perm : sym["permissions"]) {
-              if (!symbol.permissions.empty()) symbol.permissions += ",";
-              symbol.permissions += perm.get<std::string>();
-            }
-          }
-          
-          // Parse filters
-          if (sym.contains("filters") && sym["filters"].is_array()) {
-            for (const auto& filter : sym["filters"]) {
-              std::string filterType = filter.value("filterType", "");
-              
-              if (filterType == "PRICE_FILTER") {
-                symbol.minPrice = std::stod(filter.value("minPrice", "0"));
-                symbol.maxPrice = std::stod(filter.value("maxPrice", "0"));
-                symbol.tickSize = std::stod(filter.value("tickSize", "0"));
-              } else if (filterType == "LOT_SIZE") {
-                symbol.minQty = std::stod(filter.value("minQty", "0"));
-                symbol.maxQty = std::stod(filter.value("maxQty", "0"));
-                symbol.stepSize = std::stod(filter.value("stepSize", "0"));
-              } else if (filterType == "MIN_NOTIONAL") {
-                symbol.minNotional = std::stod(filter.value("minNotional", "0"));
-              }
-            }
-          }
-          
-          // Only add trading symbols
-          if (symbol.isTrading() && !symbol.symbol.empty()) {
-            symbols.push_back(symbol);
-          }
-        }
-        
-        std::cout << "Fetched " << symbols.size() << " trading symbols from exchange info" << std::endl;
-      }
-      
-    } catch (const std::exception& e) {
-      std::cerr << "Error parsing exchange info: " << e.what() << std::endl;
+  if (pImpl->httpsGetJson(pImpl->getBaseUrl(), path, "", decoder)) {
+    // Size the request governor to the limit the exchange actually applies
+    if (decoder.weightLimit() > 0) {
+      RequestGovernor::getInstance().setWeightLimit(decoder.weightLimit());
     }
+    std::cout << "Fetched " << symbols.size() << " trading symbols from exchange info" << std::endl;
   } else {
-    std::cerr << "Failed to fetch exchange info (empty response)" << std::endl;
+    std::cerr << "Failed to fetch exchange info"
+              << (decoder.error.empty() ? "" : ": " + decoder.error) << std::endl;
+    symbols.clear();
   }
   
   if (onDataCallback) {
@@ -633,40 +1185,38 @@ void BinanceClient::fetchExchangeInfo(OnSymbolsCallback onDataCallback) {
   }
 }
 
-void BinanceClient::subscribeMiniTickers(OnTicksCallback callback) {
-  // Store the callback - we'll convert vector to single tick in the handler
-  pImpl->onTick = [callback](const core::Tick& tick) {
-    // Wrap single tick in vector and call the callback
-    callback(std::vector<core::Tick>{tick});
-  };
+void BinanceClient::subscribeMiniTickers(OnMiniTickersCallback callback) {
+  pImpl->onMiniTickers = std::move(callback);
   
-  // Use the combined stream for all mini tickers
-  // wss://stream.binance.com:9443/ws/!miniTicker@arr
-  std::string url = pImpl->getWsUrl() + "/!miniTicker@arr";
-  pImpl->webSocket.setUrl(url);
+  // All symbols on one stream: wss://stream.binance.com:9443/ws/!miniTicker@arr
+  pImpl->tickerSocket.setUrl(pImpl->getWsUrl() + "/!miniTicker@arr");
   
   // Setup message handler
-  pImpl->webSocket.setOnMessageCallback(
+  pImpl->tickerSocket.setOnMessageCallback(
       [this](const ix::WebSocketMessagePtr &msg) {
+        core::applyThreadRoleOnce(settings::ThreadRole::FEED, "glora-ticker");
         if (msg->type == ix::WebSocketMessageType::Message) {
           try {
             auto j = json::parse(msg->str);
             
-            // miniTicker@arr returns an array of mini tickers
-            if (j.is_array()) {
-              for (const auto& ticker : j) {
-                if (ticker.contains("s") && pImpl->onTick) {
-                  core::Tick tick;
-                  tick.timestamp_ms = ticker.value("E", 0);
-                  tick.price = std::stod(ticker.value("c", "0"));
-                  tick.quantity = std::stod(ticker.value("v", "0"));
-                  // is_buyer_maker indicates price movement direction
-                  double openPrice = std::stod(ticker.value("o", "0"));
-                  tick.is_buyer_maker = tick.price < openPrice;
-                  
-                  pImpl->onTick(tick);
-                }
+            // miniTicker@arr returns an array of the symbols that changed
+            if (j.is_array() && pImpl->onMiniTickers) {
+              std::vector<core::MiniTicker> tickers;
+              tickers.reserve(j.size());
+              for (const auto& entry : j) {
+                if (!entry.contains("s")) continue;
+                core::MiniTicker ticker;
+                ticker.symbol = entry["s"].get<std::string>();
+                ticker.eventTime = entry.value("E", uint64_t{0});
+                ticker.open = parseDecimal(entry.value("o", json("0")));
+                ticker.high = parseDecimal(entry.value("h", json("0")));
+                ticker.low = parseDecimal(entry.value("l", json("0")));
+                ticker.close = parseDecimal(entry.value("c", json("0")));
+                ticker.volume = parseDecimal(entry.value("v", json("0")));
+                ticker.quoteVolume = parseDecimal(entry.value("q", json("0")));
+                tickers.push_back(std::move(ticker));
               }
+              pImpl->onMiniTickers(tickers);
             }
           } catch (const json::parse_error &e) {
             std::cerr << "JSON Parse error in miniTicker: " << e.what() << std::endl;
@@ -699,11 +1249,24 @@ void BinanceClient::bootstrapHistoryThenStream(
       
       std::cout << "[Bootstrap] History fetch complete: " << candles.size() << " candles" << std::endl;
       
-      // Set last trade ID from the last candle for deduplication
-      if (!candles.empty()) {
-        // Use end time as reference for deduplication (trades after this time are new)
-        lastRestTradeId_ = static_cast<int64_t>(candles.back().end_time_ms);
-        std::cout << "[Bootstrap] Set last REST timestamp: " << lastRestTradeId_ << std::endl;
+      // Klines carry no trade IDs: live trades are deduplicated against the
+      // newest trade ID as of the fetch. Without it, fall back to the end of
+      // the last closed candle by time; the open candle ends in the future
+      // and would drop every live trade until it closed.
+      lastRestTradeId_ = fetchLatestAggTradeId(symbol);
+      lastRestTimeMs_ = 0;
+      if (lastRestTradeId_ > 0) {
+        std::cout << "[Bootstrap] Set last REST trade ID: " << lastRestTradeId_ << std::endl;
+      } else {
+        uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        for (auto it = candles.rbegin(); it != candles.rend(); ++it) {
+          if (it->end_time_ms <= nowMs) {
+            lastRestTimeMs_ = it->end_time_ms;
+            break;
+          }
+        }
+        std::cout << "[Bootstrap] Set last REST timestamp: " << lastRestTimeMs_ << std::endl;
       }
       
       // Send history to callback (frontend)
@@ -22,6 +22,8 @@ using json = nlohmann::json;
 using OnCandleCallback = std::function<void(const core::Candle &)>;
 using OnTickCallback = std::function<void(const core::Tick &)>;
 using OnTicksCallback = std::function<void(const std::vector<core::Tick> &)>;
+using OnSymbolTickCallback = std::function<void(const std::string &, const core::Tick &)>;
+using OnMiniTickersCallback = std::function<void(const std::vector<core::MiniTicker> &)>;
 using OnDepthCallback = std::function<void(const std::vector<std::pair<double, double>>& bids, const std::vector<std::pair<double, double>>& asks)>;
 using OnSymbolsCallback = std::function<void(const std::vector<core::Symbol> &)>;
 
@@ -37,13 +39,28 @@ public:
   void setApiConfig(const settings::ApiConfig& config);
 
   // --- REST API ---
-  // Fetch historical aggregated trades for footprint generation
+  // All REST calls go through the RequestGovernor and take the calling
+  // thread's RequestPriority (Interactive unless a ScopedRequestPriority
+  // says otherwise).
+
+  // Fetch historical aggregated trades for footprint generation. Time
+  // windows are fetched in parallel and returned in order.
   void fetchHistoricalAggTrades(
       const std::string &symbol, uint64_t startTime, uint64_t endTime,
       std::function<void(const std::vector<core::Tick> &)> onDataCallback);
 
-  // Fetch klines (candlesticks)
-  void fetchKlines(const std::string& symbol, const std::string& interval,
+  // Fetch aggregate trades by ID, inclusive [fromId, toId]. Used to fill
+  // gaps found by ID continuity; pages are exact, with no time overlap.
+  void fetchAggTradesById(
+      const std::string &symbol, int64_t fromId, int64_t toId,
+      std::function<void(const std::vector<core::Tick> &)> onDataCallback);
+
+  // ID of the newest aggregate trade, 0 if it cannot be fetched
+  int64_t fetchLatestAggTradeId(const std::string &symbol);
+
+  // Fetch klines (candlesticks); false when the request failed, as opposed
+  // to succeeding with no klines in the range
+  bool fetchKlines(const std::string& symbol, const std::string& interval,
                     uint64_t startTime, uint64_t endTime,
                     std::function<void(const std::vector<core::Candle>&)> onDataCallback);
 
@@ -59,11 +76,23 @@ public:
   // Subscribe to real-time aggTrade stream
   void subscribeAggTrades(const std::string &symbol, OnTickCallback callback);
 
-  // Subscribe to depth stream (order book updates)
+  // Subscribe to depth stream (order book updates, 100ms diffs on a separate
+  // socket). Quantities are absolute; 0 means the level was removed.
   void subscribeDepth(const std::string& symbol, OnDepthCallback callback);
 
-  // Subscribe to miniTicker for all symbols (real-time price updates)
-  void subscribeMiniTickers(OnTicksCallback callback);
+  // Keep aggTrades flowing for a consumer's set of background symbols
+  // (prefetched watchlist, synthetic legs) on one combined-stream connection,
+  // separate from the active symbol's socket. Each consumer gets ticks for
+  // its own symbols. Calling again replaces that consumer's set: the live
+  // connection is sent SUBSCRIBE/UNSUBSCRIBE for the difference of the union
+  // instead of reconnecting. An empty set drops the consumer; the connection
+  // closes when no symbols are left.
+  void setBackgroundAggTrades(const std::string& consumer, const std::vector<std::string>& symbols,
+                              OnSymbolTickCallback callback);
+
+  // Subscribe to miniTicker for all symbols (real-time price updates, one
+  // batch per second on a separate socket)
+  void subscribeMiniTickers(OnMiniTickersCallback callback);
 
   // Connect and start the ASIO event loop on the network thread
   void connectAndRun();
@@ -94,6 +123,9 @@ public:
   // Set the last trade ID from REST fetch for deduplication
   void setLastTradeId(int64_t lastId) { lastRestTradeId_ = lastId; }
   
+  // Set last timestamp covered by REST history (for sources without trade IDs)
+  void setLastRestTime(uint64_t timeMs) { lastRestTimeMs_ = timeMs; }
+  
   // Get buffered message count
   size_t getBufferSize() const;
 
@@ -108,6 +140,13 @@ public:
   bool isConnected() const;
 
 private:
+  // Parallel time windows for fetchHistoricalAggTrades
+  static constexpr size_t kBackfillWorkers = 4;
+
+  // All trades in [startTime, endTime], paging by ID past full pages
+  void fetchAggTradesWindow(const std::string& symbol, uint64_t startTime, uint64_t endTime,
+                            std::vector<core::Tick>& out);
+
   // Internal state (Boost Asio contexts, Websocket streams, etc) would go here
   struct Impl;
   std::unique_ptr<Impl> pImpl;
@@ -119,6 +158,7 @@ private:
   mutable std::mutex bufferMutex_;
   std::unordered_set<int64_t> seenTradeIds_;
   int64_t lastRestTradeId_ = 0;
+  uint64_t lastRestTimeMs_ = 0;
   
   // --- Rate Limit Fix Members ---
   bool heartbeatRunning_ = false;
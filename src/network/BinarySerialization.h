@@ -13,6 +13,8 @@
  * - 0x02: Trade
  * - 0x03: Order Book
  * - 0x04: Ticker
+ * - 0x07: Sparklines (many symbols, float32 closes)
+ * - 0x08: Book signals (order book microstructure time series)
  * 
  * Note: For full FlatBuffers support, use flatc to generate code from market_data.fbs
  * This header provides a lightweight fallback with custom binary format.
@@ -46,7 +48,9 @@ enum class BinaryMessageType : uint8_t {
   OrderBook = 0x03,
   OrderBookUpdate = 0x04,
   Ticker = 0x05,
-  AggTrade = 0x06
+  AggTrade = 0x06,
+  Sparklines = 0x07,
+  BookSignals = 0x08
 };
 
 // Binary message flags
@@ -111,6 +115,44 @@ struct BinaryOrderBook {
   // Followed by bidsCount + asksCount BinaryOrderBookEntry structs
 };
 
+// Sparklines binary format. Followed by symbolCount entries of
+// { uint8_t nameLength; char name[nameLength]; float closes[points]; },
+// closes oldest first and NaN where there is no data
+#pragma pack(push, 1)
+struct BinarySparklinesHeader {
+  uint64_t endTime;       // End of the newest bucket (ms)
+  uint32_t bucketMs;      // Bucket width
+  uint16_t points;        // Closes per symbol
+  uint16_t symbolCount;   // Number of symbols
+};
+#pragma pack(pop)
+
+// Book signals binary format: header, symbol name, then sampleCount samples
+// oldest first. Prices stay double; ratios, sizes and rates are float32.
+#pragma pack(push, 1)
+struct BinaryBookSignalsHeader {
+  uint16_t sampleCount;   // Number of samples
+  uint8_t  nameLength;    // Followed by the symbol name
+};
+
+struct BinaryBookSignal {
+  uint64_t time;          // Book update time (ms)
+  double   microprice;
+  double   weightedMid;
+  float    spread;
+  float    imbalance;
+  float    tradeImbalance;
+  float    bidSlope;
+  float    askSlope;
+  float    bidDepletionRate;
+  float    askDepletionRate;
+  float    spreadMean;
+  float    spreadStdDev;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(BinaryBookSignal) == 60, "BinaryBookSignal must be 60 bytes");
+
 // Binary serializer class
 class BinarySerializer {
 public:
@@ -208,6 +250,56 @@ public:
     return buildMessage(BinaryMessageType::OrderBook, buffer.data(), buffer.size());
   }
   
+  // Serialize sparklines to binary: `values` holds symbols.size() x points
+  // closes, one row per symbol
+  std::vector<uint8_t> serializeSparklines(
+    uint64_t endTime,
+    uint32_t bucketMs,
+    uint16_t points,
+    const std::vector<std::string>& symbols,
+    const std::vector<float>& values
+  ) {
+    size_t count = std::min<size_t>(symbols.size(), UINT16_MAX);
+    size_t totalSize = sizeof(BinarySparklinesHeader);
+    for (size_t i = 0; i < count; ++i) {
+      totalSize += 1 + std::min<size_t>(symbols[i].size(), UINT8_MAX) + points * sizeof(float);
+    }
+    
+    std::vector<uint8_t> buffer(totalSize);
+    BinarySparklinesHeader header{endTime, bucketMs, points, static_cast<uint16_t>(count)};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    
+    uint8_t* out = buffer.data() + sizeof(header);
+    for (size_t i = 0; i < count; ++i) {
+      uint8_t nameLength = static_cast<uint8_t>(std::min<size_t>(symbols[i].size(), UINT8_MAX));
+      *out++ = nameLength;
+      std::memcpy(out, symbols[i].data(), nameLength);
+      out += nameLength;
+      std::memcpy(out, values.data() + i * points, points * sizeof(float));
+      out += points * sizeof(float);
+    }
+    
+    return buildMessage(BinaryMessageType::Sparklines, buffer.data(), buffer.size());
+  }
+  
+  // Serialize one symbol's book signal samples to binary
+  std::vector<uint8_t> serializeBookSignals(
+    const std::string& symbol,
+    const std::vector<BinaryBookSignal>& samples
+  ) {
+    size_t count = std::min<size_t>(samples.size(), UINT16_MAX);
+    uint8_t nameLength = static_cast<uint8_t>(std::min<size_t>(symbol.size(), UINT8_MAX));
+    std::vector<uint8_t> buffer(sizeof(BinaryBookSignalsHeader) + nameLength + count * sizeof(BinaryBookSignal));
+    
+    BinaryBookSignalsHeader header{static_cast<uint16_t>(count), nameLength};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    uint8_t* out = buffer.data() + sizeof(header);
+    std::memcpy(out, symbol.data(), nameLength);
+    std::memcpy(out + nameLength, samples.data(), count * sizeof(BinaryBookSignal));
+    
+    return buildMessage(BinaryMessageType::BookSignals, buffer.data(), buffer.size());
+  }
+  
   // Deserialize binary message
   struct ParsedMessage {
     BinaryMessageType type;
@@ -0,0 +1,133 @@
+#include "BookSignalPublisher.h"
+#include "../core/Metrics.h"
+#include "../core/OverloadController.h"
+#include "../core/ThreadAffinity.h"
+#include <algorithm>
+#include <iostream>
+
+namespace glora {
+namespace network {
+
+namespace {
+
+core::Counter& framesCounter() {
+    static core::Counter& counter = core::MetricsRegistry::getInstance().counter(
+        "glora_book_signal_frames_total", "Book signal batches published to the chart");
+    return counter;
+}
+
+} // namespace
+
+BookSignalPublisher::BookSignalPublisher(std::shared_ptr<core::DataManager> dataManager,
+                                         std::shared_ptr<WebSocketServer> wsServer)
+    : dataManager_(std::move(dataManager))
+    , wsServer_(std::move(wsServer)) {
+    if (dataManager_) {
+        listenerId_ = dataManager_->bookSignals().addListener(
+            [this](const std::string& symbol, const core::BookSignals& signals) { onSample(symbol, signals); });
+    }
+    thread_ = std::thread(&BookSignalPublisher::run, this);
+}
+
+BookSignalPublisher::~BookSignalPublisher() {
+    if (dataManager_) {
+        dataManager_->bookSignals().removeListener(listenerId_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void BookSignalPublisher::subscribe(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_[symbol];
+    std::cout << "[BookSignals] Streaming " << symbol << std::endl;
+}
+
+bool BookSignalPublisher::unsubscribe(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_.erase(symbol) > 0;
+}
+
+BookSignalPublisher::Clock::duration BookSignalPublisher::batchInterval() {
+    return std::chrono::milliseconds(
+        kBatchIntervalMs * core::OverloadController::getInstance().publishIntervalScale());
+}
+
+void BookSignalPublisher::onSample(const std::string& symbol, const core::BookSignals& signals) {
+    Ready ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = batches_.find(symbol);
+        if (it == batches_.end()) {
+            return;
+        }
+
+        Batch& batch = it->second;
+        auto now = Clock::now();
+        if (batch.samples.empty()) {
+            batch.firstAt = now;
+        }
+        if (batch.samples.size() < kMaxBatch) {
+            batch.samples.push_back(signals);
+        } else {
+            batch.samples.back() = signals;  // Sender far behind: keep the newest
+        }
+
+        if (now - batch.firstAt < batchInterval()) {
+            return;
+        }
+        ready.emplace_back(symbol, std::move(batch.samples));
+        batch.samples.clear();
+    }
+    send(ready);
+}
+
+void BookSignalPublisher::run() {
+    core::applyThreadRole(settings::ThreadRole::PUBLISH, "glora-signals");
+
+    Ready ready;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        auto now = Clock::now();
+        auto interval = batchInterval();
+        auto wakeAt = now + interval;
+        for (auto& [symbol, batch] : batches_) {
+            if (batch.samples.empty()) {
+                continue;
+            }
+            if (now - batch.firstAt >= interval) {
+                ready.emplace_back(symbol, std::move(batch.samples));
+                batch.samples.clear();
+            } else {
+                wakeAt = std::min(wakeAt, batch.firstAt + interval);
+            }
+        }
+
+        if (!ready.empty()) {
+            lock.unlock();
+            send(ready);
+            lock.lock();
+            continue;
+        }
+        cv_.wait_until(lock, wakeAt);
+    }
+}
+
+void BookSignalPublisher::send(Ready& ready) {
+    if (wsServer_ && wsServer_->isRunning()) {
+        for (const auto& [symbol, samples] : ready) {
+            wsServer_->broadcastBookSignals(symbol, samples);
+            framesCounter().inc();
+        }
+    }
+    ready.clear();
+}
+
+} // namespace network
+} // namespace glora
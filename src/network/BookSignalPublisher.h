@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../core/DataManager.h"
+#include "WebSocketServer.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace glora {
+namespace network {
+
+/**
+ * BookSignalPublisher - Streams order book signal time series to the chart
+ *
+ * Listens to the DataManager's BookSignalEngine and collects every sample of
+ * the subscribed symbols. A batch goes out as one binary BookSignals frame
+ * (0x08) once its oldest sample is kBatchIntervalMs old, so the chart gets
+ * the full series at a bounded frame rate. A due batch is flushed on the
+ * thread that delivered the book update, or by the publisher's own timer
+ * when no further update arrives; the interval stretches while the live
+ * pipeline is overloaded (core::OverloadController).
+ */
+class BookSignalPublisher {
+public:
+    static constexpr int kBatchIntervalMs = 100;
+    static constexpr size_t kMaxBatch = 1024;
+
+    BookSignalPublisher(std::shared_ptr<core::DataManager> dataManager, std::shared_ptr<WebSocketServer> wsServer);
+    ~BookSignalPublisher();
+
+    void subscribe(const std::string& symbol);
+
+    /**
+     * @return true if the symbol was subscribed
+     */
+    bool unsubscribe(const std::string& symbol);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Batch {
+        std::vector<core::BookSignals> samples;
+        Clock::time_point firstAt;
+    };
+
+    using Ready = std::vector<std::pair<std::string, std::vector<core::BookSignals>>>;
+
+    void onSample(const std::string& symbol, const core::BookSignals& signals);
+    void run();
+    static Clock::duration batchInterval();
+    void send(Ready& ready);
+
+    std::shared_ptr<core::DataManager> dataManager_;
+    std::shared_ptr<WebSocketServer> wsServer_;
+    size_t listenerId_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, Batch> batches_;  // Subscribed symbols
+    bool running_ = true;
+    std::thread thread_;  // Flushes batches whose symbol went quiet
+};
+
+} // namespace network
+} // namespace glora
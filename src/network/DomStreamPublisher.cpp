@@ -0,0 +1,309 @@
+#include "DomStreamPublisher.h"
+#include "JsonWriter.h"
+#include "../core/Metrics.h"
+#include "../core/OverloadController.h"
+#include "../core/ThreadAffinity.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace glora {
+namespace network {
+
+namespace {
+
+struct DomMetrics {
+    core::Counter& snapshots;
+    core::Counter& diffs;
+    core::Counter& levelsSent;
+    core::Histogram& buildUs;
+};
+
+DomMetrics& domMetrics() {
+    auto& registry = core::MetricsRegistry::getInstance();
+    static DomMetrics metrics{
+        registry.counter("glora_dom_frames_total", "Smart DOM frames published", "kind=\"snapshot\""),
+        registry.counter("glora_dom_frames_total", "Smart DOM frames published", "kind=\"diff\""),
+        registry.counter("glora_dom_levels_sent_total", "Smart DOM levels sent, including removals"),
+        registry.histogram("glora_dom_frame_build_us", "Time to take and diff one Smart DOM frame",
+                           core::MetricsRegistry::durationBucketsUs()),
+    };
+    return metrics;
+}
+
+/**
+ * True when a level differs in anything the frontend renders
+ */
+bool levelChanged(const core::DomLevel& a, const core::DomLevel& b) {
+    return a.bucket.restingBidQty != b.bucket.restingBidQty ||
+           a.bucket.restingAskQty != b.bucket.restingAskQty ||
+           a.bucket.aggressiveBuyVol != b.bucket.aggressiveBuyVol ||
+           a.bucket.aggressiveSellVol != b.bucket.aggressiveSellVol ||
+           a.imbalance != b.imbalance;
+}
+
+} // namespace
+
+DomStreamPublisher::DomStreamPublisher(std::shared_ptr<core::DataManager> dataManager, Sink sink)
+    : dataManager_(std::move(dataManager))
+    , sink_(std::move(sink)) {
+}
+
+DomStreamPublisher::~DomStreamPublisher() {
+    stop();
+}
+
+void DomStreamPublisher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&DomStreamPublisher::run, this);
+}
+
+void DomStreamPublisher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+DomStreamPublisher::StreamConfig DomStreamPublisher::mergeConfigs(const std::map<int, StreamConfig>& clients) {
+    StreamConfig merged;
+    merged.depth = 1;
+    merged.intervalMs = kMaxIntervalMs;
+    merged.snapshotIntervalMs = std::numeric_limits<int>::max();
+    for (const auto& [clientId, config] : clients) {
+        merged.depth = std::max(merged.depth, config.depth);
+        merged.intervalMs = std::min(merged.intervalMs, config.intervalMs);
+        merged.snapshotIntervalMs = std::min(merged.snapshotIntervalMs, config.snapshotIntervalMs);
+    }
+    return merged;
+}
+
+DomStreamPublisher::StreamConfig DomStreamPublisher::clampConfig(const StreamConfig& requested) {
+    StreamConfig config;
+    config.depth = std::clamp(requested.depth, 1, kMaxDepth);
+    config.intervalMs = std::clamp(requested.intervalMs, kMinIntervalMs, kMaxIntervalMs);
+    config.snapshotIntervalMs = std::max(requested.snapshotIntervalMs, config.intervalMs);
+    return config;
+}
+
+DomStreamPublisher::StreamConfig DomStreamPublisher::subscribe(int clientId, const std::string& symbol,
+                                                               const StreamConfig& requested) {
+    StreamConfig config = clampConfig(requested);
+
+    StreamConfig applied;
+    size_t clients = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stream& stream = streams_[symbol];
+        stream.clients[clientId] = config;
+        stream.config = mergeConfigs(stream.clients);
+        stream.forceSnapshot = true;
+        stream.nextPublish = Clock::now();
+        applied = stream.config;
+        clients = stream.clients.size();
+    }
+    cv_.notify_all();
+
+    std::cout << "[DomStream] " << symbol << ": depth " << applied.depth << ", every "
+              << applied.intervalMs << "ms, snapshot every " << applied.snapshotIntervalMs << "ms ("
+              << clients << " clients)" << std::endl;
+    return applied;
+}
+
+bool DomStreamPublisher::unsubscribe(int clientId, const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(symbol);
+    if (it == streams_.end() || it->second.clients.erase(clientId) == 0) {
+        return false;
+    }
+    if (it->second.clients.empty()) {
+        streams_.erase(it);
+    } else {
+        it->second.config = mergeConfigs(it->second.clients);
+    }
+    return true;
+}
+
+void DomStreamPublisher::removeClient(int clientId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        Stream& stream = it->second;
+        if (stream.clients.erase(clientId) == 0) {
+            ++it;
+        } else if (stream.clients.empty()) {
+            it = streams_.erase(it);
+        } else {
+            stream.config = mergeConfigs(stream.clients);
+            ++it;
+        }
+    }
+}
+
+void DomStreamPublisher::resync() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        for (auto& [symbol, stream] : streams_) {
+            stream.forceSnapshot = true;
+            stream.nextPublish = now;
+        }
+    }
+    cv_.notify_all();
+}
+
+void DomStreamPublisher::writeLevel(JsonWriter& writer, const core::DomLevel& level) {
+    writer.beginObject();
+    writer.field("aggBuy", level.bucket.aggressiveBuyVol);
+    writer.field("aggSell", level.bucket.aggressiveSellVol);
+    writer.field("delta", level.bucket.getDelta());
+    writer.field("imbalance", level.imbalance);
+    writer.field("price", level.bucket.price);
+    writer.field("restingAsk", level.bucket.restingAskQty);
+    writer.field("restingBid", level.bucket.restingBidQty);
+    writer.endObject();
+}
+
+void DomStreamPublisher::run() {
+    core::applyThreadRole(settings::ThreadRole::PUBLISH, "glora-dom");
+
+    auto& overload = core::OverloadController::getInstance();
+    // Encoded frames of one cycle; the strings are reused so steady-state
+    // cycles don't allocate
+    std::vector<std::string> frames;
+    size_t frameCount = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        auto now = Clock::now();
+        auto wakeAt = now + std::chrono::milliseconds(kMaxIntervalMs);
+
+        // Under load the DOM is the first thing to slow down
+        int scale = overload.publishIntervalScale();
+        for (auto& [symbol, stream] : streams_) {
+            if (stream.nextPublish <= now) {
+                if (frameCount == frames.size()) {
+                    frames.emplace_back();
+                }
+                if (buildFrame(symbol, stream, now, frames[frameCount])) {
+                    ++frameCount;
+                }
+                stream.nextPublish = now + std::chrono::milliseconds(stream.config.intervalMs * scale);
+                if (scale > 1) {
+                    overload.countShed(core::OverloadController::Shed::DOM_FRAME, scale - 1);
+                }
+            }
+            wakeAt = std::min(wakeAt, stream.nextPublish);
+        }
+
+        // Send without holding the lock so subscribe() never waits on the socket
+        if (frameCount > 0) {
+            lock.unlock();
+            for (size_t i = 0; i < frameCount; ++i) {
+                sink_(frames[i]);
+            }
+            frameCount = 0;
+            lock.lock();
+            continue;
+        }
+
+        cv_.wait_until(lock, wakeAt);
+    }
+}
+
+bool DomStreamPublisher::buildFrame(const std::string& symbol, Stream& stream,
+                                    Clock::time_point now, std::string& out) {
+    bool snapshot = stream.forceSnapshot || now >= stream.nextSnapshot;
+
+    // Nothing traded or moved in the book since the last frame
+    if (!snapshot && dataManager_->getSmartDOMVersion(symbol) == stream.lastVersion) {
+        return false;
+    }
+
+    auto& metrics = domMetrics();
+    auto buildStart = Clock::now();
+
+    core::DomFrame frame = dataManager_->getSmartDOMFrame(symbol, stream.config.depth);
+
+    // "levels" sorts first, so the header follows once the levels are written
+    out.clear();
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("levels");
+    writer.beginArray();
+    size_t levelCount = 0;
+    if (snapshot) {
+        for (const auto& level : frame.levels) {
+            writeLevel(writer, level);
+        }
+        levelCount = frame.levels.size();
+    } else {
+        // Both sides are ordered high to low: merge to find changes and removals
+        auto prev = stream.lastSent.begin();
+        auto next = frame.levels.begin();
+        while (prev != stream.lastSent.end() || next != frame.levels.end()) {
+            if (next == frame.levels.end() ||
+                (prev != stream.lastSent.end() && prev->bucket.price > next->bucket.price)) {
+                writer.beginObject();
+                writer.field("price", prev->bucket.price);
+                writer.field("removed", true);
+                writer.endObject();
+                ++levelCount;
+                ++prev;
+            } else if (prev == stream.lastSent.end() || next->bucket.price > prev->bucket.price) {
+                writeLevel(writer, *next);
+                ++levelCount;
+                ++next;
+            } else {
+                if (levelChanged(*prev, *next)) {
+                    writeLevel(writer, *next);
+                    ++levelCount;
+                }
+                ++prev;
+                ++next;
+            }
+        }
+    }
+
+    bool pocChanged = frame.poc != stream.lastPoc;
+    stream.lastVersion = frame.version;
+    stream.lastPoc = frame.poc;
+    stream.lastSent = std::move(frame.levels);
+
+    if (!snapshot && levelCount == 0 && !pocChanged) {
+        return false;
+    }
+
+    if (snapshot) {
+        stream.forceSnapshot = false;
+        stream.nextSnapshot = now + std::chrono::milliseconds(stream.config.snapshotIntervalMs);
+        metrics.snapshots.inc();
+    } else {
+        metrics.diffs.inc();
+    }
+    metrics.levelsSent.inc(levelCount);
+
+    writer.endArray();
+    writer.field("poc", frame.poc);
+    writer.field("seq", ++stream.seq);
+    writer.field("snapshot", snapshot);
+    writer.field("symbol", symbol);
+    writer.field("tickSize", frame.tickSize);
+    writer.field("type", "smartDOMUpdate");
+    writer.endObject();
+
+    metrics.buildUs.observe(std::chrono::duration<double, std::micro>(Clock::now() - buildStart).count());
+    return true;
+}
+
+} // namespace network
+} // namespace glora
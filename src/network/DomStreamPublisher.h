@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../core/DataManager.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace glora {
+namespace network {
+
+class JsonWriter;
+
+using json = nlohmann::json;
+
+/**
+ * DomStreamPublisher - Pushes Smart DOM updates to the frontend
+ *
+ * Each subscribed symbol is published at its own negotiated interval. A cycle
+ * takes one DomFrame from the DataManager (POC and imbalance flags computed
+ * once) and sends only the levels that changed since the previous cycle, plus
+ * removals for levels that left the window. A full snapshot goes out on
+ * subscribe and every snapshot interval so clients can resync; the "seq"
+ * field lets a client detect a missed frame and re-subscribe.
+ *
+ * Wire format:
+ *   { type: "smartDOMUpdate", symbol, seq, snapshot, poc, tickSize,
+ *     levels: [{ price, restingBid, restingAsk, aggBuy, aggSell, delta, imbalance }
+ *              | { price, removed: true }] }
+ *
+ * Frames go to all clients, so each symbol has one stream. Subscriptions are
+ * kept per client and the stream runs at the tightest settings any of them
+ * asked for (deepest book, shortest intervals); it stops when the last
+ * client unsubscribes or disconnects. Intervals stretch while the live
+ * pipeline is overloaded (core::OverloadController).
+ */
+class DomStreamPublisher {
+public:
+    /**
+     * Receives each encoded frame
+     */
+    using Sink = std::function<void(const std::string&)>;
+
+    static constexpr int kMinIntervalMs = 50;
+    static constexpr int kMaxIntervalMs = 5000;
+    static constexpr int kDefaultIntervalMs = 250;
+    static constexpr int kDefaultSnapshotIntervalMs = 5000;
+    static constexpr int kMaxDepth = 500;
+
+    /**
+     * Effective stream settings after clamping
+     */
+    struct StreamConfig {
+        int depth = 25;
+        int intervalMs = kDefaultIntervalMs;
+        int snapshotIntervalMs = kDefaultSnapshotIntervalMs;
+    };
+
+    DomStreamPublisher(std::shared_ptr<core::DataManager> dataManager, Sink sink);
+    ~DomStreamPublisher();
+
+    void start();
+    void stop();
+
+    /**
+     * A request's settings clamped to the supported ranges
+     */
+    static StreamConfig clampConfig(const StreamConfig& requested);
+
+    /**
+     * Start or renegotiate a client's subscription to a symbol. The next
+     * frame is a full snapshot.
+     * @return The stream's settings after merging with other clients'; every
+     *         subscriber of the symbol receives frames at these settings
+     */
+    StreamConfig subscribe(int clientId, const std::string& symbol, const StreamConfig& requested);
+
+    /**
+     * Drop a client's subscription; the stream stops with the last one
+     * @return true if the client was subscribed
+     */
+    bool unsubscribe(int clientId, const std::string& symbol);
+
+    /**
+     * Drop every subscription of a disconnected client
+     */
+    void removeClient(int clientId);
+
+    /**
+     * Send a full snapshot on every stream next, after frames were lost
+     */
+    void resync();
+
+    /**
+     * One level streamed into a writer, shared with the getSmartDOM response
+     */
+    static void writeLevel(JsonWriter& writer, const core::DomLevel& level);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stream {
+        std::map<int, StreamConfig> clients;  // Requested (clamped) settings by client
+        StreamConfig config;                  // Tightest of the clients'
+        Clock::time_point nextPublish;
+        Clock::time_point nextSnapshot;
+        uint64_t seq = 0;
+        uint64_t lastVersion = 0;
+        double lastPoc = 0.0;
+        bool forceSnapshot = true;
+        std::vector<core::DomLevel> lastSent;  // Highest price first
+    };
+
+    void run();
+
+    /**
+     * Deepest depth and shortest intervals across a stream's clients
+     */
+    static StreamConfig mergeConfigs(const std::map<int, StreamConfig>& clients);
+
+    /**
+     * Encode the frame for one stream into `out` (cleared first) if anything
+     * changed
+     * @return false when there is nothing to send
+     */
+    bool buildFrame(const std::string& symbol, Stream& stream, Clock::time_point now, std::string& out);
+
+    std::shared_ptr<core::DataManager> dataManager_;
+    Sink sink_;
+
+    std::map<std::string, Stream> streams_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+} // namespace network
+} // namespace glora
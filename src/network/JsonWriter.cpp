@@ -0,0 +1,217 @@
+#include "JsonWriter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace glora {
+namespace network {
+
+void JsonWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (!first_.empty()) {
+        if (!first_.back()) {
+            out_ += ',';
+        }
+        first_.back() = false;
+    }
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    out_ += '{';
+    first_.push_back(true);
+}
+
+void JsonWriter::endObject() {
+    out_ += '}';
+    first_.pop_back();
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    out_ += '[';
+    first_.push_back(true);
+}
+
+void JsonWriter::endArray() {
+    out_ += ']';
+    first_.pop_back();
+}
+
+void JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    out_ += ':';
+    afterKey_ = true;
+}
+
+void JsonWriter::value(double v) {
+    separate();
+    appendDouble(out_, v);
+}
+
+void JsonWriter::value(bool v) {
+    separate();
+    out_ += v ? "true" : "false";
+}
+
+void JsonWriter::value(std::string_view v) {
+    separate();
+    appendEscaped(v);
+}
+
+void JsonWriter::value(const json& v) {
+    separate();
+    out_ += v.dump();
+}
+
+void JsonWriter::raw(std::string_view encoded) {
+    separate();
+    out_ += encoded;
+}
+
+void JsonWriter::fixed(double v, int decimals) {
+    separate();
+    if (!std::isfinite(v)) {
+        out_ += "null";
+        return;
+    }
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::fixed, decimals);
+    out_.append(buf, result.ptr);
+}
+
+void JsonWriter::objectWith(const json& fields, std::string_view memberKey,
+                            const std::function<void(JsonWriter&)>& writeMember) {
+    beginObject();
+    bool written = false;
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+        if (!written && memberKey < std::string_view(it.key())) {
+            key(memberKey);
+            writeMember(*this);
+            written = true;
+        }
+        if (it.key() == memberKey) continue;
+        key(it.key());
+        value(it.value());
+    }
+    if (!written) {
+        key(memberKey);
+        writeMember(*this);
+    }
+    endObject();
+}
+
+void JsonWriter::appendEscaped(std::string_view s) {
+    static const char* kHex = "0123456789abcdef";
+    out_ += '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out_ += "\\u00";
+                    out_ += kHex[(c >> 4) & 0xF];
+                    out_ += kHex[c & 0xF];
+                } else {
+                    out_ += c;
+                }
+        }
+    }
+    out_ += '"';
+}
+
+void JsonWriter::appendDouble(std::string& out, double v) {
+    if (!std::isfinite(v)) {
+        out += "null";
+        return;
+    }
+    // The same Grisu2 digits and layout dump() uses, written in place;
+    // std::to_chars picks different digits for a few values in a thousand
+    char buf[64];
+    char* end = nlohmann::detail::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, end);
+}
+
+void JsonWriter::appendPriceKey(std::string& out, double price) {
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), price, std::chars_format::fixed, 6);
+    out.append(buf, result.ptr);
+}
+
+void writeFootprint(JsonWriter& writer, const core::Candle::Footprint& footprint, bool withDelta) {
+    // Keys are "%f" prices, so sorted as text like dump() does
+    std::vector<std::pair<std::string, const core::PriceNode*>> levels;
+    levels.reserve(footprint.size());
+    for (const auto& [price, node] : footprint) {
+        std::string priceKey;
+        JsonWriter::appendPriceKey(priceKey, price);
+        levels.emplace_back(std::move(priceKey), &node);
+    }
+    std::sort(levels.begin(), levels.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    writer.beginObject();
+    for (size_t i = 0; i < levels.size(); ++i) {
+        // Equal keys collapse to the last one written, as with operator[]
+        if (i + 1 < levels.size() && levels[i + 1].first == levels[i].first) continue;
+        writer.key(levels[i].first);
+        writer.beginObject();
+        writer.field("ask", levels[i].second->ask_volume);
+        writer.field("bid", levels[i].second->bid_volume);
+        if (withDelta) {
+            writer.field("delta", levels[i].second->ask_volume - levels[i].second->bid_volume);
+        }
+        writer.endObject();
+    }
+    writer.endObject();
+}
+
+void writeCandle(JsonWriter& writer, const core::Candle& candle) {
+    writer.beginObject();
+    writer.field("close", candle.close);
+    if (!candle.footprint_profile.empty()) {
+        writer.key("footprint");
+        writeFootprint(writer, candle.footprint_profile);
+    }
+    writer.field("high", candle.high);
+    writer.field("low", candle.low);
+    writer.field("open", candle.open);
+    writer.field("time", candle.start_time_ms);
+    writer.field("volume", candle.volume);
+    writer.endObject();
+}
+
+void writeCompactTick(JsonWriter& writer, const core::Tick& tick) {
+    writer.beginObject();
+    writer.field("m", tick.is_buyer_maker);
+    writer.field("p", tick.price);
+    writer.field("q", tick.quantity);
+    writer.field("t", tick.timestamp_ms);
+    writer.endObject();
+}
+
+void encodeTickMessage(std::string& out, const std::string& symbol, const core::Tick& tick) {
+    out.clear();
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.field("id", tick.trade_id);
+    writer.field("isBuyerMaker", tick.is_buyer_maker);
+    writer.field("price", tick.price);
+    writer.field("quantity", tick.quantity);
+    writer.field("symbol", symbol);
+    writer.field("time", tick.timestamp_ms);
+    writer.field("type", "tick");
+    writer.endObject();
+}
+
+} // namespace network
+} // namespace glora
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../core/DataModels.h"
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace glora {
+namespace network {
+
+using json = nlohmann::json;
+
+/**
+ * JsonWriter - Streams JSON text straight into a caller-owned buffer
+ *
+ * For the large responses (history, ticks, DOM) that would otherwise build a
+ * nlohmann tree with one node per element and then dump() it. The output is
+ * byte-identical to dump(): no whitespace, object keys in sorted order (the
+ * caller writes them that way), doubles with dump()'s digits and layout ("1.0",
+ * "0.0001", "1e-05", non-finite as null).
+ *
+ * The buffer is appended to, never shrunk, so a thread_local string reused
+ * across messages stops allocating once it has grown to the largest one.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * Object key; the next value or begin* call is its value
+     */
+    void key(std::string_view name);
+
+    void value(double v);
+    void value(bool v);
+    void value(std::string_view v);
+    void value(const char* v) { value(std::string_view(v)); }
+    void value(const std::string& v) { value(std::string_view(v)); }
+    void value(const json& v);
+
+    /**
+     * Text that is already JSON (e.g. stored drawings), copied as is
+     */
+    void raw(std::string_view encoded);
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    void value(T v) {
+        separate();
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), v);
+        out_.append(buf, result.ptr);
+    }
+
+    /**
+     * Fixed number of decimals, for prices at a symbol's precision
+     */
+    void fixed(double v, int decimals);
+
+    template <typename T>
+    void field(std::string_view name, const T& v) {
+        key(name);
+        value(v);
+    }
+
+    /**
+     * An object made of the small `fields` (any JSON object) plus one large
+     * member streamed by `writeMember`, placed where dump() would sort it
+     */
+    void objectWith(const json& fields, std::string_view memberKey,
+                    const std::function<void(JsonWriter&)>& writeMember);
+
+    /**
+     * Append a double exactly as nlohmann::json::dump() prints it
+     */
+    static void appendDouble(std::string& out, double v);
+
+    /**
+     * Append "%f" text of a price (footprint keys), without snprintf
+     */
+    static void appendPriceKey(std::string& out, double price);
+
+private:
+    void separate();
+    void appendEscaped(std::string_view s);
+
+    std::string& out_;
+    std::vector<bool> first_;  // Per open container: nothing written yet
+    bool afterKey_ = false;
+};
+
+/**
+ * Footprint as in history responses: "%f" price -> {ask, bid}, plus delta
+ * (ask - bid) for footprint responses
+ */
+void writeFootprint(JsonWriter& writer, const core::Candle::Footprint& footprint, bool withDelta = false);
+
+/**
+ * Candle as in history responses: close, footprint (when present), high,
+ * low, open, time, volume
+ */
+void writeCandle(JsonWriter& writer, const core::Candle& candle);
+
+/**
+ * Tick as in "ticks" responses: m, p, q, t
+ */
+void writeCompactTick(JsonWriter& writer, const core::Tick& tick);
+
+/**
+ * Live "tick" broadcast for a symbol into `out` (cleared first)
+ */
+void encodeTickMessage(std::string& out, const std::string& symbol, const core::Tick& tick);
+
+} // namespace network
+} // namespace glora
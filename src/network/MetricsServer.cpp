@@ -0,0 +1,71 @@
+#include "MetricsServer.h"
+#include "../core/Metrics.h"
+#include "../core/ThreadAffinity.h"
+#include <ixwebsocket/IXHttpServer.h>
+#include <iostream>
+
+namespace glora {
+namespace network {
+
+MetricsServer::MetricsServer(int port, const std::string& host)
+    : port_(port)
+    , host_(host) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (isRunning_) {
+        return true;
+    }
+
+    server_ = std::make_unique<ix::HttpServer>(port_, host_);
+
+    server_->setOnConnectionCallback(
+        [](ix::HttpRequestPtr request, std::shared_ptr<ix::ConnectionState>) -> ix::HttpResponsePtr {
+            core::applyThreadRoleOnce(settings::ThreadRole::BACKGROUND, "glora-metrics");
+
+            ix::WebSocketHttpHeaders headers;
+            if (request->method == "GET" && (request->uri == "/metrics" || request->uri.rfind("/metrics?", 0) == 0)) {
+                headers["Content-Type"] = "text/plain; version=0.0.4; charset=utf-8";
+                return std::make_shared<ix::HttpResponse>(
+                    200, "OK", ix::HttpErrorCode::Ok, headers,
+                    core::MetricsRegistry::getInstance().renderPrometheus());
+            }
+
+            headers["Content-Type"] = "text/plain";
+            return std::make_shared<ix::HttpResponse>(
+                404, "Not Found", ix::HttpErrorCode::Ok, headers, "Not Found\n");
+        });
+
+    auto result = server_->listen();
+    if (!result.first) {
+        std::cerr << "[MetricsServer] Failed to listen on " << host_ << ":" << port_
+                  << ": " << result.second << std::endl;
+        server_.reset();
+        return false;
+    }
+
+    server_->start();
+    isRunning_ = true;
+    std::cout << "[MetricsServer] Serving http://" << host_ << ":" << port_ << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!isRunning_) {
+        return;
+    }
+
+    if (server_) {
+        server_->stop();
+        server_.reset();
+    }
+    isRunning_ = false;
+    std::cout << "[MetricsServer] Stopped" << std::endl;
+}
+
+} // namespace network
+} // namespace glora
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace ix {
+class HttpServer;
+}
+
+namespace glora {
+namespace network {
+
+/**
+ * MetricsServer - Local HTTP endpoint for Prometheus scraping
+ *
+ * Serves GET /metrics from core::MetricsRegistry in the Prometheus text
+ * exposition format. Binds to loopback by default; put a reverse proxy in
+ * front of it to expose it beyond the host.
+ */
+class MetricsServer {
+public:
+    /**
+     * @param port Port to listen on
+     * @param host Interface to bind (default: loopback only)
+     */
+    explicit MetricsServer(int port = 9464, const std::string& host = "127.0.0.1");
+    ~MetricsServer();
+
+    /**
+     * Start serving
+     * @return true if the listening socket was created
+     */
+    bool start();
+
+    /**
+     * Stop serving
+     */
+    void stop();
+
+    bool isRunning() const { return isRunning_; }
+
+private:
+    int port_;
+    std::string host_;
+    std::unique_ptr<ix::HttpServer> server_;
+    bool isRunning_ = false;
+};
+
+} // namespace network
+} // namespace glora
@@ -0,0 +1,223 @@
+#include "RequestGovernor.h"
+#include "../core/Metrics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace glora {
+namespace network {
+
+namespace {
+
+thread_local RequestPriority tlsPriority = RequestPriority::Interactive;
+
+struct GovernorMetrics {
+  core::Gauge& usedWeight;
+  core::Gauge& weightLimit;
+  core::Gauge& orderCount10s;
+  core::Counter& waits;
+  core::Histogram& waitMs;
+  core::Counter& rateLimited;
+  core::Counter& banned;
+};
+
+GovernorMetrics& governorMetrics() {
+  auto& registry = core::MetricsRegistry::getInstance();
+  static GovernorMetrics metrics{
+    registry.gauge("glora_rest_used_weight", "REST weight used in the current minute (exchange-reported)"),
+    registry.gauge("glora_rest_weight_limit", "REST weight allowed per minute"),
+    registry.gauge("glora_rest_order_count_10s", "Order count reported by the exchange over 10s"),
+    registry.counter("glora_rest_governor_waits_total", "Requests that had to wait for budget"),
+    registry.histogram("glora_rest_governor_wait_ms", "Time spent waiting for REST budget",
+                       core::MetricsRegistry::latencyBucketsMs()),
+    registry.counter("glora_rest_throttled_total", "Rate limit responses (429) and bans (418)", "status=\"429\""),
+    registry.counter("glora_rest_throttled_total", "Rate limit responses (429) and bans (418)", "status=\"418\""),
+  };
+  return metrics;
+}
+
+int64_t currentMinute() {
+  return std::chrono::duration_cast<std::chrono::minutes>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Value of a query parameter, or an empty string
+std::string queryParam(const std::string& path, const std::string& name) {
+  size_t query = path.find('?');
+  if (query == std::string::npos) return "";
+  std::string key = name + "=";
+  size_t pos = query + 1;
+  while (pos < path.size()) {
+    size_t end = path.find('&', pos);
+    if (end == std::string::npos) end = path.size();
+    if (path.compare(pos, key.size(), key) == 0) {
+      return path.substr(pos + key.size(), end - pos - key.size());
+    }
+    pos = end + 1;
+  }
+  return "";
+}
+
+} // namespace
+
+ScopedRequestPriority::ScopedRequestPriority(RequestPriority priority) : previous_(tlsPriority) {
+  tlsPriority = priority;
+}
+
+ScopedRequestPriority::~ScopedRequestPriority() {
+  tlsPriority = previous_;
+}
+
+RequestPriority ScopedRequestPriority::current() {
+  return tlsPriority;
+}
+
+RequestGovernor& RequestGovernor::getInstance() {
+  static RequestGovernor instance;
+  return instance;
+}
+
+RequestGovernor::RequestGovernor() : windowMinute_(currentMinute()) {
+  governorMetrics().weightLimit.set(weightLimit_);
+}
+
+int RequestGovernor::weightFor(const std::string& path) {
+  // Spot API weights (GET /api/v3/...)
+  if (path.rfind("/api/v3/aggTrades", 0) == 0) return 4;
+  if (path.rfind("/api/v3/klines", 0) == 0) return 2;
+  if (path.rfind("/api/v3/exchangeInfo", 0) == 0) return 20;
+  if (path.rfind("/api/v3/depth", 0) == 0) {
+    int limit = std::atoi(queryParam(path, "limit").c_str());
+    if (limit <= 0) limit = 100;
+    if (limit <= 100) return 5;
+    if (limit <= 500) return 25;
+    if (limit <= 1000) return 50;
+    return 250;
+  }
+  if (path.rfind("/api/v3/ticker/24hr", 0) == 0) {
+    return queryParam(path, "symbol").empty() ? 80 : 2;
+  }
+  return 2;
+}
+
+void RequestGovernor::rollWindow() {
+  int64_t minute = currentMinute();
+  if (minute != windowMinute_) {
+    windowMinute_ = minute;
+    // Requests still in flight may land in the new window
+    used_ = inFlight_;
+  }
+}
+
+bool RequestGovernor::canAdmit(int weight) const {
+  if (Clock::now() < blockedUntil_) return false;
+  // A single request heavier than the whole budget can only go in an empty window
+  if (weight > weightLimit_ - kSafetyMargin) return used_ == 0;
+  return used_ + weight <= weightLimit_ - kSafetyMargin;
+}
+
+void RequestGovernor::acquire(int weight, RequestPriority priority) {
+  auto& metrics = governorMetrics();
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  auto ticket = std::make_pair(static_cast<int>(priority), nextTicket_++);
+  waiters_.insert(ticket);
+
+  auto waitStart = Clock::now();
+  bool waited = false;
+  while (true) {
+    rollWindow();
+    if (*waiters_.begin() == ticket && canAdmit(weight)) break;
+
+    waited = true;
+    // Wake when a ban ends, at the next minute boundary, or when a response
+    // changes the budget
+    auto now = Clock::now();
+    auto wakeAt = blockedUntil_ > now
+        ? blockedUntil_
+        : now + std::chrono::milliseconds(60000 - std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count() % 60000);
+    cv_.wait_until(lock, wakeAt);
+  }
+
+  waiters_.erase(ticket);
+  used_ += weight;
+  inFlight_ += weight;
+
+  if (waited) {
+    metrics.waits.inc();
+    metrics.waitMs.observe(std::chrono::duration<double, std::milli>(Clock::now() - waitStart).count());
+  }
+
+  // The next waiter may fit as well
+  lock.unlock();
+  cv_.notify_all();
+}
+
+bool RequestGovernor::complete(int weight, int status, const std::map<std::string, std::string>& headers) {
+  auto& metrics = governorMetrics();
+  bool retry = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inFlight_ = std::max(0, inFlight_ - weight);
+    rollWindow();
+
+    // The exchange's count includes this request; requests still in flight
+    // are not in it yet
+    auto used = headers.find("x-mbx-used-weight-1m");
+    if (used != headers.end()) {
+      int reported = std::atoi(used->second.c_str());
+      used_ = std::max(used_, reported + inFlight_);
+      metrics.usedWeight.set(reported);
+    }
+
+    auto orders = headers.find("x-mbx-order-count-10s");
+    if (orders != headers.end()) {
+      metrics.orderCount10s.set(std::atoi(orders->second.c_str()));
+    }
+
+    if (status == 429 || status == 418) {
+      // 429: over the limit, back off as told. 418: IP ban for repeat
+      // offenders; the ban length comes in Retry-After as well.
+      int retryAfter = 0;
+      auto header = headers.find("retry-after");
+      if (header != headers.end()) {
+        retryAfter = std::atoi(header->second.c_str());
+      }
+      if (retryAfter <= 0) {
+        retryAfter = status == 418 ? 120 : 60;
+      }
+      blockedUntil_ = std::max(blockedUntil_, Clock::now() + std::chrono::seconds(retryAfter));
+
+      (status == 429 ? metrics.rateLimited : metrics.banned).inc();
+      std::cerr << "[RequestGovernor] HTTP " << status << ", pausing REST for " << retryAfter
+                << "s" << std::endl;
+      retry = true;
+    }
+  }
+  cv_.notify_all();
+  return retry;
+}
+
+void RequestGovernor::setWeightLimit(int perMinute) {
+  if (perMinute <= 0) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    weightLimit_ = perMinute;
+  }
+  governorMetrics().weightLimit.set(perMinute);
+  cv_.notify_all();
+}
+
+int RequestGovernor::weightLimit() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return weightLimit_;
+}
+
+int RequestGovernor::usedWeight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return used_;
+}
+
+} // namespace network
+} // namespace glora
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace glora {
+namespace network {
+
+// Who is waiting on a REST call. Interactive requests (history the user is
+// looking at) are always admitted before background work (gap fills,
+// backfills, symbol refresh).
+enum class RequestPriority { Interactive = 0, Background = 1 };
+
+// Sets the priority of REST calls made on this thread for the scope
+class ScopedRequestPriority {
+public:
+  explicit ScopedRequestPriority(RequestPriority priority);
+  ~ScopedRequestPriority();
+
+  ScopedRequestPriority(const ScopedRequestPriority&) = delete;
+  ScopedRequestPriority& operator=(const ScopedRequestPriority&) = delete;
+
+  static RequestPriority current();
+
+private:
+  RequestPriority previous_;
+};
+
+// Process-wide REST weight budget for the exchange.
+//
+// Every request reserves its endpoint weight before it is sent. The budget
+// is the exchange's REQUEST_WEIGHT limit per minute, tracked locally and
+// corrected from the X-MBX-USED-WEIGHT-1M header of each response, so
+// concurrent callers can use the whole allowance without overshooting it.
+// Waiters are admitted strictly by priority, then FIFO. A 429 or 418 blocks
+// all requests until its Retry-After has passed.
+class RequestGovernor {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int kDefaultWeightLimit = 6000;  // Spot REQUEST_WEIGHT per minute
+  static constexpr int kSafetyMargin = 50;          // Headroom for requests we don't see (other processes, WS API)
+
+  static RequestGovernor& getInstance();
+
+  // Weight of a REST path such as "/api/v3/depth?symbol=X&limit=500"
+  static int weightFor(const std::string& path);
+
+  // Block until `weight` fits in the current window and no higher-priority
+  // request is waiting
+  void acquire(int weight, RequestPriority priority);
+
+  // Report the outcome of an acquired request. Headers are lower-case.
+  // Returns true when the caller should retry (429/418 after the backoff).
+  bool complete(int weight, int status, const std::map<std::string, std::string>& headers);
+
+  // Limit from exchangeInfo rateLimits (REQUEST_WEIGHT, 1 MINUTE)
+  void setWeightLimit(int perMinute);
+
+  int weightLimit() const;
+  int usedWeight() const;
+
+private:
+  RequestGovernor();
+  RequestGovernor(const RequestGovernor&) = delete;
+  RequestGovernor& operator=(const RequestGovernor&) = delete;
+
+  // Start a new window when the wall-clock minute rolls over (the exchange
+  // counts per calendar minute)
+  void rollWindow();
+  bool canAdmit(int weight) const;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+
+  int weightLimit_ = kDefaultWeightLimit;
+  int used_ = 0;           // Weight spent in this window, including in flight
+  int inFlight_ = 0;       // Reserved but not yet reported by the exchange
+  int64_t windowMinute_ = 0;
+  Clock::time_point blockedUntil_{};
+
+  // Waiting requests ordered by (priority, arrival)
+  std::set<std::pair<int, uint64_t>> waiters_;
+  uint64_t nextTicket_ = 0;
+};
+
+} // namespace network
+} // namespace glora
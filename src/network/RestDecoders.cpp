@@ -0,0 +1,209 @@
+#include "RestDecoders.h"
+#include <charconv>
+
+namespace glora {
+namespace network {
+
+double parseDecimal(const std::string& text) {
+  double value = 0.0;
+  std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
+}
+
+// --- AggTradeDecoder ---
+
+bool AggTradeDecoder::key(string_t& name) {
+  field_ = (depth == 2 && name.size() == 1) ? name[0] : 0;
+  return true;
+}
+
+bool AggTradeDecoder::start_object(std::size_t) {
+  if (++depth == 2) {
+    current_ = core::Tick{};
+  }
+  return true;
+}
+
+bool AggTradeDecoder::end_object() {
+  if (depth-- == 2) {
+    out_.push_back(current_);
+    lastId_ = current_.trade_id;
+    ++count_;
+  }
+  field_ = 0;
+  return true;
+}
+
+bool AggTradeDecoder::number_unsigned(number_unsigned_t value) {
+  switch (field_) {
+    case 'a': current_.trade_id = static_cast<int64_t>(value); break;
+    case 'T': current_.timestamp_ms = value; break;
+    default: break;
+  }
+  return true;
+}
+
+bool AggTradeDecoder::boolean(bool value) {
+  if (field_ == 'm') {
+    current_.is_buyer_maker = value;
+  }
+  return true;
+}
+
+bool AggTradeDecoder::string(string_t& value) {
+  switch (field_) {
+    case 'p': current_.price = parseDecimal(value); break;
+    case 'q': current_.quantity = parseDecimal(value); break;
+    default: break;
+  }
+  return true;
+}
+
+// --- KlineDecoder ---
+
+bool KlineDecoder::start_array(std::size_t) {
+  if (++depth == 2) {
+    current_ = core::Candle{};
+    field_ = 0;
+  }
+  return true;
+}
+
+bool KlineDecoder::end_array() {
+  if (depth-- == 2) {
+    out_.push_back(std::move(current_));
+  }
+  return true;
+}
+
+bool KlineDecoder::value() {
+  ++field_;
+  return true;
+}
+
+bool KlineDecoder::number_unsigned(number_unsigned_t value) {
+  if (depth != 2) return true;
+  switch (field_) {
+    case 0: current_.start_time_ms = value; break;
+    case 6: current_.end_time_ms = value; break;
+    default: break;
+  }
+  return this->value();
+}
+
+bool KlineDecoder::string(string_t& value) {
+  if (depth != 2) return true;
+  switch (field_) {
+    case 1: current_.open = parseDecimal(value); break;
+    case 2: current_.high = parseDecimal(value); break;
+    case 3: current_.low = parseDecimal(value); break;
+    case 4: current_.close = parseDecimal(value); break;
+    case 5: current_.volume = parseDecimal(value); break;
+    default: break;
+  }
+  return this->value();
+}
+
+// --- ExchangeInfoDecoder ---
+
+bool ExchangeInfoDecoder::key(string_t& name) {
+  if (depth == 1) {
+    section_ = name == "symbols" ? Section::SYMBOLS
+             : name == "rateLimits" ? Section::RATE_LIMITS
+             : Section::OTHER;
+  } else if (depth == kEntryDepth) {
+    entryKey_ = name;
+  } else if (depth == kFilterDepth) {
+    filterKey_ = name;
+  }
+  return true;
+}
+
+bool ExchangeInfoDecoder::start_object(std::size_t) {
+  ++depth;
+  if (depth == kEntryDepth) {
+    symbol_ = core::Symbol{};
+    rateLimit_ = RateLimit{};
+    entryKey_.clear();
+  } else if (depth == kFilterDepth && section_ == Section::SYMBOLS && entryKey_ == "filters") {
+    filter_ = Filter{};
+    filterKey_.clear();
+  }
+  return true;
+}
+
+bool ExchangeInfoDecoder::end_object() {
+  if (depth == kFilterDepth && section_ == Section::SYMBOLS && entryKey_ == "filters") {
+    applyFilter();
+  } else if (depth == kEntryDepth) {
+    if (section_ == Section::SYMBOLS) {
+      // Only add trading symbols
+      if (symbol_.isTrading() && !symbol_.symbol.empty()) {
+        out_.push_back(std::move(symbol_));
+      }
+    } else if (section_ == Section::RATE_LIMITS) {
+      if (rateLimit_.type == "REQUEST_WEIGHT" && rateLimit_.interval == "MINUTE" &&
+          rateLimit_.intervalNum == 1) {
+        weightLimit_ = static_cast<int>(rateLimit_.limit);
+      }
+    }
+  }
+  --depth;
+  return true;
+}
+
+bool ExchangeInfoDecoder::number_unsigned(number_unsigned_t value) {
+  if (section_ == Section::RATE_LIMITS && depth == kEntryDepth) {
+    if (entryKey_ == "intervalNum") rateLimit_.intervalNum = value;
+    else if (entryKey_ == "limit") rateLimit_.limit = value;
+  }
+  return true;
+}
+
+bool ExchangeInfoDecoder::string(string_t& value) {
+  if (section_ == Section::RATE_LIMITS && depth == kEntryDepth) {
+    if (entryKey_ == "rateLimitType") rateLimit_.type = std::move(value);
+    else if (entryKey_ == "interval") rateLimit_.interval = std::move(value);
+    return true;
+  }
+  if (section_ != Section::SYMBOLS) return true;
+
+  if (depth == kEntryDepth) {
+    if (entryKey_ == "symbol") symbol_.symbol = std::move(value);
+    else if (entryKey_ == "baseAsset") symbol_.baseAsset = std::move(value);
+    else if (entryKey_ == "quoteAsset") symbol_.quoteAsset = std::move(value);
+    else if (entryKey_ == "status") symbol_.status = std::move(value);
+  } else if (depth == kEntryDepth + 1 && entryKey_ == "permissions") {
+    // Permissions as a comma-separated string
+    if (!symbol_.permissions.empty()) symbol_.permissions += ",";
+    symbol_.permissions += value;
+  } else if (depth == kFilterDepth && entryKey_ == "filters") {
+    // Filter fields can come in any order, so keep them until the filter closes
+    if (filterKey_ == "filterType") filter_.type = std::move(value);
+    else if (filterKey_ == "minPrice") filter_.minPrice = std::move(value);
+    else if (filterKey_ == "maxPrice") filter_.maxPrice = std::move(value);
+    else if (filterKey_ == "tickSize") filter_.tickSize = std::move(value);
+    else if (filterKey_ == "minQty") filter_.minQty = std::move(value);
+    else if (filterKey_ == "maxQty") filter_.maxQty = std::move(value);
+    else if (filterKey_ == "stepSize") filter_.stepSize = std::move(value);
+    else if (filterKey_ == "minNotional") filter_.minNotional = std::move(value);
+  }
+  return true;
+}
+
+void ExchangeInfoDecoder::applyFilter() {
+  if (filter_.type == "PRICE_FILTER") {
+    symbol_.minPrice = parseDecimal(filter_.minPrice);
+    symbol_.maxPrice = parseDecimal(filter_.maxPrice);
+    symbol_.tickSize = parseDecimal(filter_.tickSize);
+  } else if (filter_.type == "LOT_SIZE") {
+    symbol_.minQty = parseDecimal(filter_.minQty);
+    symbol_.maxQty = parseDecimal(filter_.maxQty);
+    symbol_.stepSize = parseDecimal(filter_.stepSize);
+  } else if (filter_.type == "MIN_NOTIONAL") {
+    symbol_.minNotional = parseDecimal(filter_.minNotional);
+  }
+}
+
+} // namespace network
+} // namespace glora
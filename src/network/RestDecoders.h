@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../core/DataModels.h"
+#include <cstdint>
+#include <memory_resource>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace glora {
+namespace network {
+
+// Streaming decoders for the large REST responses.
+//
+// Each decoder is a SAX handler for json::sax_parse that recognises one
+// response schema and appends finished records to the caller's (reserved)
+// output as soon as their closing brace arrives. Nothing is materialised as
+// a json DOM, and decimal strings are converted in place with from_chars.
+// Fed from the HTTP body stream, decoding overlaps the download.
+//
+// Values outside the schema are skipped. A malformed document stops the
+// parse; records decoded before the error stay in the output.
+
+// Accepts every SAX event; decoders hide the ones they care about
+struct SaxDecoderBase {
+  using number_integer_t = nlohmann::json::number_integer_t;
+  using number_unsigned_t = nlohmann::json::number_unsigned_t;
+  using number_float_t = nlohmann::json::number_float_t;
+  using string_t = nlohmann::json::string_t;
+  using binary_t = nlohmann::json::binary_t;
+
+  bool null() { return true; }
+  bool boolean(bool) { return true; }
+  bool number_integer(number_integer_t) { return true; }
+  bool number_unsigned(number_unsigned_t) { return true; }
+  bool number_float(number_float_t, const string_t&) { return true; }
+  bool string(string_t&) { return true; }
+  bool binary(binary_t&) { return true; }
+  bool key(string_t&) { return true; }
+  bool start_object(std::size_t) { ++depth; return true; }
+  bool end_object() { --depth; return true; }
+  bool start_array(std::size_t) { ++depth; return true; }
+  bool end_array() { --depth; return true; }
+  bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e) {
+    error = e.what();
+    return false;
+  }
+
+  int depth = 0;       // Open objects and arrays
+  std::string error;   // Set when the document was malformed
+};
+
+// "123.45" -> 123.45 without allocating; 0 when the text is not a number
+double parseDecimal(const std::string& text);
+
+// GET /api/v3/aggTrades: [{"a":1,"p":"..","q":"..","f":..,"l":..,"T":..,"m":true,"M":true}, ...]
+class AggTradeDecoder : public SaxDecoderBase {
+public:
+  explicit AggTradeDecoder(std::pmr::vector<core::Tick>& out) : out_(out) {}
+
+  bool number_integer(number_integer_t value) { return number_unsigned(static_cast<uint64_t>(value)); }
+  bool number_unsigned(number_unsigned_t value);
+  bool boolean(bool value);
+  bool string(string_t& value);
+  bool key(string_t& name);
+  bool start_object(std::size_t);
+  bool end_object();
+
+  // Trades in the response, and the aggTrade ID of the last one
+  size_t count() const { return count_; }
+  int64_t lastId() const { return lastId_; }
+
+private:
+  std::pmr::vector<core::Tick>& out_;
+  core::Tick current_;
+  char field_ = 0;
+  size_t count_ = 0;
+  int64_t lastId_ = 0;
+};
+
+// GET /api/v3/klines: [[openTime,"open","high","low","close","volume",closeTime,...], ...]
+class KlineDecoder : public SaxDecoderBase {
+public:
+  explicit KlineDecoder(std::vector<core::Candle>& out) : out_(out) {}
+
+  bool number_integer(number_integer_t value) { return number_unsigned(static_cast<uint64_t>(value)); }
+  bool number_unsigned(number_unsigned_t value);
+  bool string(string_t& value);
+  bool start_array(std::size_t);
+  bool end_array();
+
+private:
+  bool value();  // Advance past the current field
+
+  std::vector<core::Candle>& out_;
+  core::Candle current_;
+  int field_ = 0;
+};
+
+// GET /api/v3/exchangeInfo: the trading symbols and the REQUEST_WEIGHT limit
+class ExchangeInfoDecoder : public SaxDecoderBase {
+public:
+  explicit ExchangeInfoDecoder(std::vector<core::Symbol>& out) : out_(out) {}
+
+  bool number_integer(number_integer_t value) { return number_unsigned(static_cast<uint64_t>(value)); }
+  bool number_unsigned(number_unsigned_t value);
+  bool string(string_t& value);
+  bool key(string_t& name);
+  bool start_object(std::size_t);
+  bool end_object();
+
+  // Requests weight allowed per minute, 0 when the response had none
+  int weightLimit() const { return weightLimit_; }
+
+private:
+  enum class Section { OTHER, RATE_LIMITS, SYMBOLS };
+
+  // Depths of the objects we decode, with the root object at 1
+  static constexpr int kEntryDepth = 3;   // rateLimits[i] and symbols[i]
+  static constexpr int kFilterDepth = 5;  // symbols[i].filters[j]
+
+  struct Filter {
+    std::string type;
+    std::string minPrice, maxPrice, tickSize;
+    std::string minQty, maxQty, stepSize;
+    std::string minNotional;
+  };
+
+  struct RateLimit {
+    std::string type;
+    std::string interval;
+    uint64_t intervalNum = 0;
+    uint64_t limit = 0;
+  };
+
+  void applyFilter();
+
+  std::vector<core::Symbol>& out_;
+  Section section_ = Section::OTHER;
+  std::string entryKey_;   // Key inside the current symbol or rate limit
+  std::string filterKey_;  // Key inside the current filter
+  core::Symbol symbol_;
+  Filter filter_;
+  RateLimit rateLimit_;
+  int weightLimit_ = 0;
+};
+
+} // namespace network
+} // namespace glora
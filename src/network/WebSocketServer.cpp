@@ -1,14 +1,83 @@
 #include "WebSocketServer.h"
 #include "BinarySerialization.h"
+#include "../core/ThreadAffinity.h"
+#include "../core/Metrics.h"
+#include "../core/Tracing.h"
+#include <chrono>
 #include <iostream>
 #include <algorithm>
 
 namespace glora {
 namespace network {
 
-WebSocketServer::WebSocketServer(int port)
+namespace {
+
+/**
+ * Fan-out instrumentation, one set per frame kind
+ */
+struct SendMetrics {
+    core::Counter& messages;
+    core::Counter& bytes;
+    core::Counter& sends;
+    core::Histogram& broadcastUs;
+};
+
+SendMetrics makeSendMetrics(const std::string& kind) {
+    auto& registry = core::MetricsRegistry::getInstance();
+    std::string labels = "kind=\"" + kind + "\"";
+    return SendMetrics{
+        registry.counter("glora_ws_messages_total", "Messages broadcast to frontend clients", labels),
+        registry.counter("glora_ws_bytes_total", "Payload bytes broadcast (before fan-out)", labels),
+        registry.counter("glora_ws_sends_total", "Per-client sends (messages x clients)", labels),
+        registry.histogram("glora_ws_broadcast_us", "Time to hand a message to the sender shards",
+                           core::MetricsRegistry::durationBucketsUs(), labels),
+    };
+}
+
+SendMetrics& textMetrics() {
+    static SendMetrics metrics = makeSendMetrics("text");
+    return metrics;
+}
+
+SendMetrics& binaryMetrics() {
+    static SendMetrics metrics = makeSendMetrics("binary");
+    return metrics;
+}
+
+core::Gauge& clientsGauge() {
+    static core::Gauge& gauge = core::MetricsRegistry::getInstance().gauge(
+        "glora_ws_clients", "Connected frontend clients");
+    return gauge;
+}
+
+core::Counter& droppedCounter() {
+    static core::Counter& counter = core::MetricsRegistry::getInstance().counter(
+        "glora_ws_dropped_frames_total", "Frames dropped by a sender shard that fell kMaxQueuedFrames behind");
+    return counter;
+}
+
+core::Histogram& shardSendHistogram() {
+    static core::Histogram& histogram = core::MetricsRegistry::getInstance().histogram(
+        "glora_ws_shard_send_us", "Time for a sender shard to send one frame to its clients",
+        core::MetricsRegistry::durationBucketsUs());
+    return histogram;
+}
+
+core::Counter& receivedCounter() {
+    static core::Counter& counter = core::MetricsRegistry::getInstance().counter(
+        "glora_ws_received_total", "Messages received from frontend clients");
+    return counter;
+}
+
+} // namespace
+
+WebSocketServer::WebSocketServer(int port, size_t senderThreads)
     : port_(port)
-    , isRunning_(false) {
+    , senderThreads_(senderThreads) {
+    if (senderThreads_ == 0) {
+        senderThreads_ = std::max<size_t>(std::thread::hardware_concurrency() / 2, 1);
+    }
+    senderThreads_ = std::min(senderThreads_, kMaxSenderThreads);
 }
 
 WebSocketServer::~WebSocketServer() {
@@ -23,6 +92,9 @@ bool WebSocketServer::start() {
     
     std::cout << "[WebSocketServer] Starting server on port " << port_ << "..." << std::endl;
     
+    // Senders first: clients are handed to a shard as they connect
+    startSenders();
+    
     // Create WebSocket server
     server_ = std::make_unique<ix::WebSocketServer>(port_);
     
@@ -36,10 +108,12 @@ bool WebSocketServer::start() {
             
             // Set message handler for this connection
             ws->setOnMessageCallback([self, clientId, ws](const ix::WebSocketMessagePtr& msg) {
+                // ixwebsocket runs one thread per connection
+                core::applyThreadRoleOnce(settings::ThreadRole::PUBLISH, "glora-publish");
                 self->onMessage(clientId, *ws, msg);
             });
             
-            self->onConnection(clientId, *ws);
+            self->onConnection(clientId, ws);
         }
     });
     
@@ -47,18 +121,22 @@ bool WebSocketServer::start() {
     bool success = server_->listenAndStart();
     if (!success) {
         std::cerr << "[WebSocketServer] Failed to start server" << std::endl;
+        server_.reset();
+        stopSenders();
         return false;
     }
     
     isRunning_ = true;
-    std::cout << "[WebSocketServer] Server started successfully on port " << port_ << std::endl;
+    std::cout << "[WebSocketServer] Server started successfully on port " << port_
+              << " (" << shards_.size() << " sender threads)" << std::endl;
     std::cout << "[WebSocketServer] Frontend should connect to: ws://localhost:" << port_ << std::endl;
     
     return true;
 }
 
 void WebSocketServer::stop() {
-    if (!isRunning_) {
+    // Flipped first so new broadcasts stop before anything is torn down
+    if (!isRunning_.exchange(false)) {
         return;
     }
     
@@ -68,27 +146,39 @@ void WebSocketServer::stop() {
         server_->stop();
         server_.reset();
     }
+    stopSenders();
     
     {
         std::lock_guard<std::mutex> lock(clientsMutex_);
         clients_.clear();
     }
     
-    isRunning_ = false;
     std::cout << "[WebSocketServer] Server stopped" << std::endl;
 }
 
 void WebSocketServer::broadcast(const std::string& message) {
-    if (!isRunning_ || !server_) {
+    broadcastText(message, false);
+}
+
+void WebSocketServer::broadcastStream(const std::string& message) {
+    broadcastText(message, true);
+}
+
+void WebSocketServer::broadcastText(const std::string& message, bool droppable) {
+    if (!isRunning_) {
         return;
     }
     
-    auto clients = server_->getClients();
-    for (auto& client : clients) {
-        if (client) {
-            client->send(message);
-        }
-    }
+    auto& metrics = textMetrics();
+    auto start = std::chrono::steady_clock::now();
+    
+    size_t clients = enqueue({std::make_shared<const std::string>(message), false, droppable});
+    
+    metrics.messages.inc();
+    metrics.bytes.inc(message.size());
+    metrics.sends.inc(clients);
+    metrics.broadcastUs.observe(std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count());
 }
 
 void WebSocketServer::broadcast(const json& message) {
@@ -103,6 +193,14 @@ void WebSocketServer::setMessageCallback(MessageCallback callback) {
     messageCallback_ = std::move(callback);
 }
 
+void WebSocketServer::setDisconnectCallback(DisconnectCallback callback) {
+    disconnectCallback_ = std::move(callback);
+}
+
+void WebSocketServer::setDropCallback(DropCallback callback) {
+    dropCallback_ = std::move(callback);
+}
+
 size_t WebSocketServer::getClientCount() const {
     if (!server_) return 0;
     return server_->getClients().size();
@@ -110,49 +208,185 @@ size_t WebSocketServer::getClientCount() const {
 
 void WebSocketServer::onMessage(int clientId, const ix::WebSocket& webSocket, const ix::WebSocketMessagePtr& msg) {
     if (msg->type == ix::WebSocketMessageType::Message) {
+        receivedCounter().inc();
         if (messageCallback_) {
-            messageCallback_(msg->str);
+            messageCallback_(clientId, msg->str);
         }
+    } else if (msg->type == ix::WebSocketMessageType::Close) {
+        onDisconnection(clientId, webSocket, msg->closeInfo.code, msg->closeInfo.reason);
     } else if (msg->type == ix::WebSocketMessageType::Error) {
         std::cerr << "[WebSocketServer] Error for client " << clientId << ": " << msg->errorInfo.reason << std::endl;
     }
 }
 
-void WebSocketServer::onConnection(int clientId, const ix::WebSocket& webSocket) {
+void WebSocketServer::onConnection(int clientId, const std::shared_ptr<ix::WebSocket>& webSocket) {
+    if (!shards_.empty()) {
+        auto& shard = *shards_[static_cast<size_t>(clientId) % shards_.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.clients.emplace_back(clientId, webSocket);
+    }
+    
     std::lock_guard<std::mutex> lock(clientsMutex_);
     clients_.push_back(clientId);
+    clientsGauge().set(static_cast<double>(clients_.size()));
     std::cout << "[WebSocketServer] Client " << clientId << " connected. Total clients: " << clients_.size() << std::endl;
 }
 
 void WebSocketServer::onDisconnection(int clientId, const ix::WebSocket& webSocket, int code, const std::string& reason) {
-    std::lock_guard<std::mutex> lock(clientsMutex_);
-    clients_.erase(std::remove(clients_.begin(), clients_.end(), clientId), clients_.end());
-    std::cout << "[WebSocketServer] Client " << clientId << " disconnected. Total clients: " << clients_.size() << std::endl;
+    if (!shards_.empty()) {
+        auto& shard = *shards_[static_cast<size_t>(clientId) % shards_.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.clients.erase(std::remove_if(shard.clients.begin(), shard.clients.end(),
+                                           [clientId](const auto& client) { return client.first == clientId; }),
+                            shard.clients.end());
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        clients_.erase(std::remove(clients_.begin(), clients_.end(), clientId), clients_.end());
+        clientsGauge().set(static_cast<double>(clients_.size()));
+        std::cout << "[WebSocketServer] Client " << clientId << " disconnected. Total clients: " << clients_.size() << std::endl;
+    }
+    
+    if (disconnectCallback_) {
+        disconnectCallback_(clientId);
+    }
+}
+
+// --- Sender shards ---
+
+void WebSocketServer::startSenders() {
+    // Created once; a restart reuses the stopped shards
+    if (shards_.empty()) {
+        for (size_t i = 0; i < senderThreads_; ++i) {
+            shards_.push_back(std::make_unique<SenderShard>());
+        }
+    }
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->stopping = false;
+        }
+        shard->thread = std::thread(&WebSocketServer::senderLoop, this, std::ref(*shard));
+    }
+}
+
+void WebSocketServer::stopSenders() {
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->stopping = true;
+        }
+        shard->wake.notify_one();
+    }
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->frames.clear();
+        shard->clients.clear();
+    }
+}
+
+size_t WebSocketServer::enqueue(Frame frame) {
+    GLORA_TRACE_SCOPE("ws", "enqueue");
+    size_t clients = 0;
+    size_t dropped = 0;
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            if (shard->clients.empty()) continue;
+            clients += shard->clients.size();
+            if (shard->frames.size() >= kMaxQueuedFrames) {
+                // Shed the oldest stream frame; replies are never dropped
+                auto oldest = std::find_if(shard->frames.begin(), shard->frames.end(),
+                                           [](const Frame& queued) { return queued.droppable; });
+                if (oldest != shard->frames.end()) {
+                    shard->frames.erase(oldest);
+                    ++dropped;
+                } else if (frame.droppable) {
+                    ++dropped;
+                    continue;
+                }
+            }
+            shard->frames.push_back(frame);
+        }
+        shard->wake.notify_one();
+    }
+    if (dropped > 0) {
+        droppedCounter().inc(dropped);
+        if (dropCallback_) {
+            dropCallback_();
+        }
+    }
+    return clients;
+}
+
+void WebSocketServer::senderLoop(SenderShard& shard) {
+    core::applyThreadRole(settings::ThreadRole::PUBLISH, "glora-ws-send");
+    auto& sendUs = shardSendHistogram();
+    
+    std::deque<Frame> frames;
+    std::vector<std::shared_ptr<ix::WebSocket>> clients;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.wake.wait(lock, [&shard] { return shard.stopping || !shard.frames.empty(); });
+            if (shard.stopping) return;
+            frames.swap(shard.frames);
+            
+            // Sockets the server has already dropped fall out here
+            clients.clear();
+            for (const auto& [id, client] : shard.clients) {
+                if (auto socket = client.lock()) {
+                    clients.push_back(std::move(socket));
+                }
+            }
+        }
+        
+        // Everything queued goes out without taking the lock again
+        GLORA_TRACE_SCOPE("ws", "sendFrames");
+        for (const auto& frame : frames) {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& client : clients) {
+                client->send(*frame.payload, frame.binary);
+            }
+            sendUs.observe(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+        frames.clear();
+    }
 }
 
 // --- Binary Serialization Methods ---
 
 void WebSocketServer::broadcastBinary(const std::vector<uint8_t>& data) {
+    broadcastBinaryFrame(data, false);
+}
+
+void WebSocketServer::broadcastBinaryFrame(const std::vector<uint8_t>& data, bool droppable) {
     if (!isRunning_ || !server_) {
         return;
     }
     
-    auto clients = server_->getClients();
-    for (auto& client : clients) {
-        if (client) {
-            // Send binary message
-            client->sendBinary(data);
-        }
-    }
+    auto& metrics = binaryMetrics();
+    auto start = std::chrono::steady_clock::now();
     
-    // Update metrics
-    auto metrics = binarySerializer_.getMetrics();
-    metrics.totalBytesOut += data.size();
+    auto payload = std::make_shared<const std::string>(data.begin(), data.end());
+    size_t clients = enqueue({std::move(payload), true, droppable});
+    
+    metrics.messages.inc();
+    metrics.bytes.inc(data.size());
+    metrics.sends.inc(clients);
+    metrics.broadcastUs.observe(std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count());
 }
 
 void WebSocketServer::broadcastCandle(uint64_t openTime, uint64_t closeTime,
                                      double open, double high, double low, double close,
                                      double volume, uint32_t trades, bool closed) {
+    std::lock_guard<std::mutex> lock(serializerMutex_);
     auto binaryData = binarySerializer_.serializeCandle(
         openTime, closeTime, open, high, low, close, volume, trades, closed
     );
@@ -162,17 +396,44 @@ void WebSocketServer::broadcastCandle(uint64_t openTime, uint64_t closeTime,
 
 void WebSocketServer::broadcastTrade(int64_t tradeId, double price, double quantity,
                                     uint64_t tradeTime, bool isBuyerMaker) {
+    std::lock_guard<std::mutex> lock(serializerMutex_);
     auto binaryData = binarySerializer_.serializeTrade(
         tradeId, price, quantity, tradeTime, isBuyerMaker
     );
+    broadcastBinaryFrame(binaryData, true);
+}
+
+void WebSocketServer::broadcastSparklines(uint64_t endTime, uint32_t bucketMs, uint16_t points,
+                                         const std::vector<std::string>& symbols,
+                                         const std::vector<float>& values) {
+    std::lock_guard<std::mutex> lock(serializerMutex_);
+    auto binaryData = binarySerializer_.serializeSparklines(endTime, bucketMs, points, symbols, values);
     broadcastBinary(binaryData);
 }
 
+void WebSocketServer::broadcastBookSignals(const std::string& symbol,
+                                           const std::vector<core::BookSignals>& samples) {
+    std::vector<BinaryBookSignal> packed;
+    packed.reserve(samples.size());
+    for (const auto& s : samples) {
+        packed.push_back(BinaryBookSignal{
+            s.timeMs, s.microprice, s.weightedMid,
+            static_cast<float>(s.spread), static_cast<float>(s.imbalance), static_cast<float>(s.tradeImbalance),
+            static_cast<float>(s.bidSlope), static_cast<float>(s.askSlope),
+            static_cast<float>(s.bidDepletionRate), static_cast<float>(s.askDepletionRate),
+            static_cast<float>(s.spreadMean), static_cast<float>(s.spreadStdDev)
+        });
+    }
+    std::lock_guard<std::mutex> lock(serializerMutex_);
+    broadcastBinaryFrame(binarySerializer_.serializeBookSignals(symbol, packed), true);
+}
+
 void WebSocketServer::broadcastOrderBook(uint64_t lastUpdateId,
                                         const std::vector<std::pair<double, double>>& bids,
                                         const std::vector<std::pair<double, double>>& asks) {
+    std::lock_guard<std::mutex> lock(serializerMutex_);
     auto binaryData = binarySerializer_.serializeOrderBook(lastUpdateId, bids, asks);
-    broadcastBinary(binaryData);
+    broadcastBinaryFrame(binaryData, true);
 }
 
 } // namespace network
@@ -2,12 +2,18 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 #include <functional>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <ixwebsocket/IXWebSocketServer.h>
 #include <ixwebsocket/IXWebSocket.h>
 #include <nlohmann/json.hpp>
 #include "BinarySerialization.h"
+#include "../core/BookSignalEngine.h"
 
 namespace glora {
 namespace network {
@@ -18,15 +24,38 @@ using json = nlohmann::json;
  * WebSocketServer - Simple WebSocket server for broadcasting market data to frontend
  * 
  * Listens on specified port and broadcasts messages to all connected clients.
+ * 
+ * Sends run on a small pool of sender threads, each owning a shard of the
+ * clients (assigned round robin on connect). A broadcast encodes nothing per
+ * client: the frame is copied once into a refcounted buffer and queued on
+ * every shard, so the caller (often the ingestion thread) pays the same
+ * whether 1 or 100 clients are connected, and a slow TLS/compression send
+ * only holds up the clients in its own shard. Each shard sends frames in
+ * order; a shard more than kMaxQueuedFrames behind drops its oldest stream
+ * frames (broadcastStream, trades, book signals, order books) and the drop
+ * callback runs, so diff streams can resync with a snapshot. Replies and
+ * other one-off messages are always queued.
+ *
+ * Shards live until the server is destroyed: stop() only joins their
+ * threads, so a broadcast racing stop() never touches a freed shard.
  */
 class WebSocketServer {
 public:
-    using MessageCallback = std::function<void(const std::string& message)>;
+    using MessageCallback = std::function<void(int clientId, const std::string& message)>;
+    using DisconnectCallback = std::function<void(int clientId)>;
+    using DropCallback = std::function<void()>;
+    
+    /**
+     * Sender pool bounds and per-shard backlog limit
+     */
+    static constexpr size_t kMaxSenderThreads = 8;
+    static constexpr size_t kMaxQueuedFrames = 4096;
     
     /**
      * @param port Port to listen on (default: 8080)
+     * @param senderThreads Sender shards, 0 = half the cores (1..kMaxSenderThreads)
      */
-    explicit WebSocketServer(int port = 8080);
+    explicit WebSocketServer(int port = 8080, size_t senderThreads = 0);
     ~WebSocketServer();
     
     /**
@@ -52,6 +81,12 @@ public:
      */
     void broadcast(const json& message);
     
+    /**
+     * Broadcast a frame of a continuous stream (ticks, DOM updates), which a
+     * lagging shard may drop
+     */
+    void broadcastStream(const std::string& message);
+    
     // --- Binary Serialization Support ---
     /**
      * Broadcast binary market data using BinarySerialization
@@ -73,6 +108,18 @@ public:
     void broadcastTrade(int64_t tradeId, double price, double quantity,
                        uint64_t tradeTime, bool isBuyerMaker);
     
+    /**
+     * Broadcast a block of sparklines as one binary frame
+     * @param values symbols.size() x points closes, one row per symbol
+     */
+    void broadcastSparklines(uint64_t endTime, uint32_t bucketMs, uint16_t points,
+                             const std::vector<std::string>& symbols, const std::vector<float>& values);
+    
+    /**
+     * Broadcast a batch of one symbol's book signal samples as one binary frame
+     */
+    void broadcastBookSignals(const std::string& symbol, const std::vector<core::BookSignals>& samples);
+    
     /**
      * Broadcast order book as binary
      */
@@ -92,6 +139,18 @@ public:
      */
     void setMessageCallback(MessageCallback callback);
     
+    /**
+     * Set callback for clients going away, so per-client state can be dropped
+     * @param callback Called with the id the client's messages carried
+     */
+    void setDisconnectCallback(DisconnectCallback callback);
+    
+    /**
+     * Set callback for frames dropped by a lagging shard, run on the
+     * broadcasting thread after the frame is queued
+     */
+    void setDropCallback(DropCallback callback);
+    
     /**
      * Get the number of connected clients
      * @return Number of connected clients
@@ -99,19 +158,59 @@ public:
     size_t getClientCount() const;
 
 private:
+    /**
+     * One encoded message shared by every shard that sends it
+     */
+    struct Frame {
+        std::shared_ptr<const std::string> payload;
+        bool binary = false;
+        bool droppable = false;  // Stream frame a lagging shard may shed
+    };
+    
+    /**
+     * A sender thread with its clients and pending frames
+     */
+    struct SenderShard {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<Frame> frames;
+        std::vector<std::pair<int, std::weak_ptr<ix::WebSocket>>> clients;
+        bool stopping = false;
+        std::thread thread;
+    };
+    
     void onMessage(int clientId, const ix::WebSocket& webSocket, const ix::WebSocketMessagePtr& msg);
-    void onConnection(int clientId, const ix::WebSocket& webSocket);
+    void onConnection(int clientId, const std::shared_ptr<ix::WebSocket>& webSocket);
     void onDisconnection(int clientId, const ix::WebSocket& webSocket, int code, const std::string& reason);
+    
+    void startSenders();
+    void stopSenders();
+    void senderLoop(SenderShard& shard);
+    
+    void broadcastText(const std::string& message, bool droppable);
+    void broadcastBinaryFrame(const std::vector<uint8_t>& data, bool droppable);
+    
+    /**
+     * Queue one frame on every shard; returns the client count it goes to
+     */
+    size_t enqueue(Frame frame);
 
     int port_;
+    size_t senderThreads_;
+    std::vector<std::unique_ptr<SenderShard>> shards_;
     std::unique_ptr<ix::WebSocketServer> server_;
     std::vector<int> clients_;
     mutable std::mutex clientsMutex_;
     MessageCallback messageCallback_;
-    bool isRunning_;
-    int lastClientId_ = 0;
+    DisconnectCallback disconnectCallback_;
+    DropCallback dropCallback_;
+    std::atomic<bool> isRunning_{false};
+    std::atomic<int> lastClientId_{0};  // Incremented on per-connection threads
     
-    // Binary serializer for efficient market data transmission
+    // Binary serializer for efficient market data transmission. Callers run
+    // on several threads; the mutex covers serializing and queueing, so
+    // sequence numbers are unique and go out in order.
+    std::mutex serializerMutex_;
     BinarySerializer binarySerializer_;
 };
 
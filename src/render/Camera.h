@@ -98,6 +98,15 @@ public:
   // Fit only price range
   void fitPriceRange(double minPrice, double maxPrice, double basePrice = 0);
   
+  // === History Paging ===
+  
+  // The view starts within `screens` visible widths of the oldest loaded
+  // candle: time to request the next older page
+  bool nearOldestData(uint64_t oldestLoaded, double screens = 1.0) const;
+  
+  // Data starting before this is more than `screens` widths left of the view
+  uint64_t evictionHorizon(double screens = 4.0) const;
+  
   // === Scale Conversion ===
   
   // Convert price based on scale type
@@ -387,5 +396,17 @@ inline void Camera::fitPriceRange(double minPrice, double maxPrice, double baseP
   maxPrice_ = inversePriceScale(scaledMax, basePrice);
 }
 
+inline bool Camera::nearOldestData(uint64_t oldestLoaded, double screens) const {
+  if (endTime_ <= startTime_) return false;
+  uint64_t lookahead = static_cast<uint64_t>((endTime_ - startTime_) * screens);
+  return startTime_ < oldestLoaded + lookahead;
+}
+
+inline uint64_t Camera::evictionHorizon(double screens) const {
+  if (endTime_ <= startTime_) return 0;
+  uint64_t margin = static_cast<uint64_t>((endTime_ - startTime_) * screens);
+  return startTime_ > margin ? startTime_ - margin : 0;
+}
+
 } // namespace render
 } // namespace glora
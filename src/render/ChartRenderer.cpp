@@ -32,9 +32,11 @@ void ChartRenderer::render(int width, int height, const Camera &camera) {
   if (!initialized_ || !dataManager_)
     return;
 
-  auto candles = dataManager_->getCandles();
-  if (candles.empty() && dataManager_->getCurrentCandle().volume == 0)
-    return;
+  {
+    auto lock = dataManager_->lockCandles();
+    if (dataManager_->getCandles().empty() && dataManager_->getCurrentCandle().volume == 0)
+      return;
+  }
 
   // Get chart area from camera
   auto [chartX, chartY] = camera.getChartOrigin();
@@ -143,7 +145,8 @@ void ChartRenderer::renderCandlesticks(int width, int height,
   float volumeHeight = chartH * volumeHeightRatio_;
   float chartAreaHeight = chartH - volumeHeight;
 
-  auto candles = dataManager_->getCandles();
+  auto lock = dataManager_->lockCandles();
+  const auto &candles = dataManager_->getCandles();
   const auto &currentCandle = dataManager_->getCurrentCandle();
 
   auto [minTime, maxTime] = camera.getTimeRange();
@@ -188,7 +191,8 @@ void ChartRenderer::renderVolume(int width, int height, const Camera &camera) {
   float volumeHeight = chartH * volumeHeightRatio_;
   float volumeY = chartY + chartH - volumeHeight;
 
-  auto candles = dataManager_->getCandles();
+  auto lock = dataManager_->lockCandles();
+  const auto &candles = dataManager_->getCandles();
   const auto &currentCandle = dataManager_->getCurrentCandle();
 
   auto [minTime, maxTime] = camera.getTimeRange();
@@ -263,7 +267,8 @@ void ChartRenderer::renderFootprint(int width, int height,
   float volumeHeight = chartH * volumeHeightRatio_;
   float chartAreaHeight = chartH - volumeHeight;
 
-  auto candles = dataManager_->getCandles();
+  auto lock = dataManager_->lockCandles();
+  const auto &candles = dataManager_->getCandles();
   const auto &currentCandle = dataManager_->getCurrentCandle();
 
   auto [minPrice, maxPrice] = camera.getPriceRange();
@@ -5,6 +5,9 @@
 #include "WebViewManager.h"
 #include "../network/WebSocketServer.h"
 #include "../core/ChartDataManager.h"
+#include "../core/HistoryPager.h"
+#include "../core/MemoryArena.h"
+#include "../core/Metrics.h"
 #include "../network/BinanceClient.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -21,6 +24,9 @@
 #include <limits>
 #include <filesystem>
 #include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <algorithm>
 
 namespace glora {
 namespace render {
@@ -39,6 +45,7 @@ struct MainWindow::Impl {
   std::shared_ptr<Camera> camera;
   std::shared_ptr<ChartInteractionHandler> interactionHandler;
   ChartData chartData;  // For interaction handler
+  std::unique_ptr<core::HistoryPager> historyPager;  // Older pages as the view pans left
 
   // WebView component
   std::shared_ptr<WebViewManager> webViewManager;
@@ -72,7 +79,7 @@ struct MainWindow::Impl {
 
   // Hover state for tooltip
   bool showTooltip = false;
-  core::Candle hoveredCandle;
+  core::Candle hoveredCandle;  // OHLCV copied out under the candle lock
   double hoveredPrice = 0;
   uint64_t hoveredTime = 0;
 
@@ -86,8 +93,26 @@ struct MainWindow::Impl {
   double dayHigh = 0;
   double dayLow = 0;
   double dayOpen = 0;
+
+  // Scratch memory for per-frame temporaries (labels, status text), rewound
+  // every frame so the steady-state frame loop doesn't hit the heap
+  core::ScratchArena frameArena{core::AllocSubsystem::Frame, 64 * 1024};
+  uint64_t lastFrameHeapAllocs = 0;
 };
 
+// Kline interval name for a chart timeframe
+static const char* klineInterval(uint64_t intervalMs) {
+  switch (static_cast<core::Timeframe>(intervalMs)) {
+    case core::Timeframe::M5: return "5m";
+    case core::Timeframe::M15: return "15m";
+    case core::Timeframe::M30: return "30m";
+    case core::Timeframe::H1: return "1h";
+    case core::Timeframe::H4: return "4h";
+    case core::Timeframe::D1: return "1D";
+    default: return "1m";
+  }
+}
+
 MainWindow::MainWindow(int width, int height, const std::string &title)
     : pImpl(std::make_unique<Impl>()) {
   pImpl->width = width;
@@ -110,6 +135,20 @@ MainWindow::MainWindow(int width, int height, const std::string &title)
   // Initialize Binance client
   pImpl->binanceClient = std::make_shared<network::BinanceClient>();
   pImpl->binanceClient->initialize();
+  
+  // Older history comes from klines; the chart holds no database
+  pImpl->historyPager = std::make_unique<core::HistoryPager>(
+      [client = pImpl->binanceClient](const std::string& symbol, uint64_t intervalMs, uint64_t before,
+                                      size_t count) -> std::optional<std::vector<core::Candle>> {
+        std::vector<core::Candle> candles;
+        uint64_t span = intervalMs * count;
+        uint64_t startTime = before > span ? before - span : 0;
+        if (!client->fetchKlines(symbol, klineInterval(intervalMs), startTime, before - 1,
+                                 [&candles](const std::vector<core::Candle>& fetched) { candles = fetched; })) {
+          return std::nullopt;
+        }
+        return candles;
+      });
 }
 
 MainWindow::~MainWindow() {
@@ -247,35 +286,45 @@ bool MainWindow::initialize() {
   return true;
 }
 
-// Helper function to format timestamp
-std::string formatTime(uint64_t timestamp_ms) {
+// Helper function to format timestamp into a caller-provided buffer
+static const char* formatTime(uint64_t timestamp_ms, char* buf, size_t size) {
   std::time_t time = static_cast<std::time_t>(timestamp_ms / 1000);
   std::tm *tm = std::localtime(&time);
-  std::stringstream ss;
-  ss << std::put_time(tm, "%Y-%m-%d %H:%M");
-  return ss.str();
+  if (!tm || std::strftime(buf, size, "%Y-%m-%d %H:%M", tm) == 0) {
+    buf[0] = '\0';
+  }
+  return buf;
 }
 
 // Helper function to format price with appropriate precision
-std::string formatPrice(double price) {
+static const char* formatPrice(double price, char* buf, size_t size) {
   if (price >= 1000) {
-    return std::to_string(static_cast<int>(price));
+    std::snprintf(buf, size, "%d", static_cast<int>(price));
   } else if (price >= 1) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << price;
-    return ss.str();
+    std::snprintf(buf, size, "%.2f", price);
   } else {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(6) << price;
-    return ss.str();
+    std::snprintf(buf, size, "%.6f", price);
   }
+  return buf;
 }
 
 void MainWindow::run() {
   ImGuiIO &io = ImGui::GetIO();
   pImpl->done = false;
 
+  auto& registry = core::MetricsRegistry::getInstance();
+  core::Counter& framesTotal = registry.counter("glora_render_frames_total", "Frames rendered");
+  core::Histogram& frameMs = registry.histogram(
+      "glora_render_frame_ms", "Frame build and draw time, excluding the swap/vsync wait",
+      core::MetricsRegistry::latencyBucketsMs());
+
   while (!pImpl->done) {
+    auto frameStart = std::chrono::steady_clock::now();
+    // Everything allocated from the frame arena is released at the end of the frame
+    core::ArenaScope frameScope(pImpl->frameArena, core::AllocSubsystem::Frame);
+    uint64_t frameStartHeapAllocs = core::allocStats(core::AllocSubsystem::Frame).heapAllocs;
+    char labelBuf[64];
+
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
       ImGui_ImplSDL2_ProcessEvent(&event);
@@ -570,6 +619,25 @@ void MainWindow::run() {
       }
     }
 
+    // ===== HISTORY PAGING =====
+    // Older pages are prepended as the view nears the oldest candle; history
+    // far left of the view is released again
+    if (auto page = pImpl->historyPager->poll()) {
+      if (page->symbol == pImpl->currentSymbol &&
+          page->intervalMs == pImpl->chartDataManager->getTimeframeMs()) {
+        pImpl->chartDataManager->prependHistory(std::move(page->candles));
+      }
+    }
+    uint64_t oldestLoaded = pImpl->chartDataManager->getOldestTime();
+    if (oldestLoaded > 0) {
+      if (pImpl->camera->nearOldestData(oldestLoaded)) {
+        pImpl->historyPager->request(pImpl->currentSymbol, pImpl->chartDataManager->getTimeframeMs(),
+                                     oldestLoaded);
+      } else {
+        pImpl->chartDataManager->evictBefore(pImpl->camera->evictionHorizon());
+      }
+    }
+
     // Update chart type
     pImpl->chartRenderer->setChartType(
         static_cast<ChartType>(pImpl->selectedChartType));
@@ -607,20 +675,20 @@ void MainWindow::run() {
 
         // Draw price label on right side
         auto [time, price] = pImpl->camera->screenToChart(mousePos.x, mousePos.y, 1, 1);
-        std::string priceLabel = formatPrice(price);
         drawList->AddRectFilled(ImVec2(chartMin.x + chartWidth - 70, mousePos.y - 10),
                                 ImVec2(chartMin.x + chartWidth, mousePos.y + 10),
                                 IM_COL32(50, 50, 70, 200), 2.0f);
         drawList->AddText(ImVec2(chartMin.x + chartWidth - 65, mousePos.y - 7),
-                         IM_COL32(200, 200, 200, 255), priceLabel.c_str());
+                         IM_COL32(200, 200, 200, 255),
+                         formatPrice(price, labelBuf, sizeof(labelBuf)));
 
         // Draw time label at bottom
-        std::string timeLabel = formatTime(time);
         drawList->AddRectFilled(ImVec2(mousePos.x - 50, chartMin.y + chartHeight - 20),
                                 ImVec2(mousePos.x + 50, chartMin.y + chartHeight),
                                 IM_COL32(50, 50, 70, 200), 2.0f);
         drawList->AddText(ImVec2(mousePos.x - 40, chartMin.y + chartHeight - 17),
-                         IM_COL32(200, 200, 200, 255), timeLabel.c_str());
+                         IM_COL32(200, 200, 200, 255),
+                         formatTime(time, labelBuf, sizeof(labelBuf)));
       }
     }
 
@@ -628,14 +696,16 @@ void MainWindow::run() {
     {
       ImDrawList *drawList = ImGui::GetWindowDrawList();
       
-      const auto& currentCandle = pImpl->chartDataManager->getCurrentCandle();
-      auto candles = pImpl->chartDataManager->getCandles();
-      
       double currentPrice = 0;
-      if (currentCandle.volume > 0) {
-        currentPrice = currentCandle.close;
-      } else if (!candles.empty()) {
-        currentPrice = candles.back().close;
+      {
+        auto candleLock = pImpl->chartDataManager->lockCandles();
+        const auto& currentCandle = pImpl->chartDataManager->getCurrentCandle();
+        const auto& candles = pImpl->chartDataManager->getCandles();
+        if (currentCandle.volume > 0) {
+          currentPrice = currentCandle.close;
+        } else if (!candles.empty()) {
+          currentPrice = candles.back().close;
+        }
       }
       
       if (currentPrice > 0) {
@@ -652,13 +722,13 @@ void MainWindow::run() {
                            priceLineColor, 1.5f);
           
           // Draw price label box
-          std::string priceLabel = formatPrice(currentPrice);
           float labelWidth = 75;
           drawList->AddRectFilled(ImVec2(chartMin.x + chartWidth - labelWidth, priceY - 10),
                                   ImVec2(chartMin.x + chartWidth, priceY + 10),
                                   IM_COL32(255, 200, 50, 200), 2.0f);
           drawList->AddText(ImVec2(chartMin.x + chartWidth - labelWidth + 5, priceY - 7),
-                           IM_COL32(0, 0, 0, 255), priceLabel.c_str());
+                           IM_COL32(0, 0, 0, 255),
+                           formatPrice(currentPrice, labelBuf, sizeof(labelBuf)));
         }
       }
     }
@@ -676,26 +746,35 @@ void MainWindow::run() {
         auto [time, price] = pImpl->camera->screenToChart(mousePos.x, mousePos.y, 1, 1);
         
         // Find the candle at this position
-        auto candles = pImpl->chartDataManager->getCandles();
-        const auto& currentCandle = pImpl->chartDataManager->getCurrentCandle();
-        
-        for (const auto& candle : candles) {
-          if (time >= candle.start_time_ms && time <= candle.end_time_ms) {
+        {
+          auto candleLock = pImpl->chartDataManager->lockCandles();
+          const auto& candles = pImpl->chartDataManager->getCandles();
+          const auto& currentCandle = pImpl->chartDataManager->getCurrentCandle();
+          
+          // Candles are time-ordered: first candle that hasn't ended yet
+          const core::Candle* hovered = nullptr;
+          auto it = std::partition_point(candles.begin(), candles.end(),
+                                         [time](const core::Candle& c) { return c.end_time_ms < time; });
+          if (it != candles.end() && time >= it->start_time_ms) {
+            hovered = &*it;
+          } else if (currentCandle.volume > 0 &&
+                     time >= currentCandle.start_time_ms && time <= currentCandle.end_time_ms) {
+            // Check current candle if no historical candle found
+            hovered = &currentCandle;
+          }
+          
+          // Copy the OHLCV only; the footprint isn't shown
+          if (hovered) {
             pImpl->showTooltip = true;
-            pImpl->hoveredCandle = candle;
-            pImpl->hoveredTime = candle.start_time_ms;
-            break;
+            pImpl->hoveredTime = hovered->start_time_ms;
+            pImpl->hoveredCandle.open = hovered->open;
+            pImpl->hoveredCandle.high = hovered->high;
+            pImpl->hoveredCandle.low = hovered->low;
+            pImpl->hoveredCandle.close = hovered->close;
+            pImpl->hoveredCandle.volume = hovered->volume;
           }
         }
         
-        // Check current candle if no historical candle found
-        if (!pImpl->showTooltip && currentCandle.volume > 0 && 
-            time >= currentCandle.start_time_ms && time <= currentCandle.end_time_ms) {
-          pImpl->showTooltip = true;
-          pImpl->hoveredCandle = currentCandle;
-          pImpl->hoveredTime = currentCandle.start_time_ms;
-        }
-        
         if (pImpl->showTooltip) {
           // Draw tooltip window
           ImGui::SetNextWindowPos(ImVec2(mousePos.x + 15, mousePos.y + 15));
@@ -704,13 +783,14 @@ void MainWindow::run() {
                        ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoMove | 
                        ImGuiWindowFlags_NoResize | ImGuiWindowFlags_Tooltip);
           
-          ImGui::Text("Time: %s", formatTime(pImpl->hoveredTime).c_str());
+          const core::Candle& hovered = pImpl->hoveredCandle;
+          ImGui::Text("Time: %s", formatTime(pImpl->hoveredTime, labelBuf, sizeof(labelBuf)));
           ImGui::Separator();
-          ImGui::Text("Open:  %s", formatPrice(pImpl->hoveredCandle.open).c_str());
-          ImGui::Text("High:  %s", formatPrice(pImpl->hoveredCandle.high).c_str());
-          ImGui::Text("Low:   %s", formatPrice(pImpl->hoveredCandle.low).c_str());
-          ImGui::Text("Close: %s", formatPrice(pImpl->hoveredCandle.close).c_str());
-          ImGui::Text("Volume: %.4f", pImpl->hoveredCandle.volume);
+          ImGui::Text("Open:  %s", formatPrice(hovered.open, labelBuf, sizeof(labelBuf)));
+          ImGui::Text("High:  %s", formatPrice(hovered.high, labelBuf, sizeof(labelBuf)));
+          ImGui::Text("Low:   %s", formatPrice(hovered.low, labelBuf, sizeof(labelBuf)));
+          ImGui::Text("Close: %s", formatPrice(hovered.close, labelBuf, sizeof(labelBuf)));
+          ImGui::Text("Volume: %.4f", hovered.volume);
           
           ImGui::End();
         }
@@ -728,35 +808,54 @@ void MainWindow::run() {
     ImGui::SetCursorScreenPos(ImVec2(chartMin.x, chartMax.y - 25));
     ImGui::Separator();
     
-    // Calculate 24h statistics
-    auto allCandles = pImpl->chartDataManager->getCandles();
-    const auto& currentCandle = pImpl->chartDataManager->getCurrentCandle();
-    
+    // Calculate 24h statistics, copying out the latest and current candles'
+    // OHLCV for the tick window below
     double lastClose = 0;
     double day24hChange = 0;
     double high24h = 0;
     double low24h = std::numeric_limits<double>::max();
+    core::Candle latestCandle;
+    core::Candle currentCandle;
+    bool hasLatestCandle = false;
     
-    if (!allCandles.empty()) {
-      lastClose = allCandles.back().close;
+    {
+      auto candleLock = pImpl->chartDataManager->lockCandles();
+      const auto& allCandles = pImpl->chartDataManager->getCandles();
+      const auto& liveCandle = pImpl->chartDataManager->getCurrentCandle();
+      auto copyBar = [](core::Candle& to, const core::Candle& from) {
+        to.start_time_ms = from.start_time_ms;
+        to.end_time_ms = from.end_time_ms;
+        to.open = from.open;
+        to.high = from.high;
+        to.low = from.low;
+        to.close = from.close;
+        to.volume = from.volume;
+      };
+      copyBar(currentCandle, liveCandle);
+    
+      if (!allCandles.empty()) {
+        hasLatestCandle = true;
+        copyBar(latestCandle, allCandles.back());
+        lastClose = allCandles.back().close;
       
-      // Find 24h high/low (assuming M1 candles, last 1440 candles = 24 hours)
-      size_t startIdx = allCandles.size() > 1440 ? allCandles.size() - 1440 : 0;
-      for (size_t i = startIdx; i < allCandles.size(); i++) {
-        if (allCandles[i].high > high24h) high24h = allCandles[i].high;
-        if (allCandles[i].low < low24h) low24h = allCandles[i].low;
-      }
+        // Find 24h high/low (assuming M1 candles, last 1440 candles = 24 hours)
+        size_t startIdx = allCandles.size() > 1440 ? allCandles.size() - 1440 : 0;
+        for (size_t i = startIdx; i < allCandles.size(); i++) {
+          if (allCandles[i].high > high24h) high24h = allCandles[i].high;
+          if (allCandles[i].low < low24h) low24h = allCandles[i].low;
+        }
       
-      // Calculate 24h change
-      if (allCandles.size() >= 1440 && allCandles[allCandles.size() - 1440].close > 0) {
-        day24hChange = ((lastClose - allCandles[allCandles.size() - 1440].close) / allCandles[allCandles.size() - 1440].close) * 100;
-      } else if (allCandles.size() >= 2) {
-        // Use first candle of the day if less than 24h of data
-        day24hChange = ((lastClose - allCandles.front().open) / allCandles.front().open) * 100;
-      }
+        // Calculate 24h change
+        if (allCandles.size() >= 1440 && allCandles[allCandles.size() - 1440].close > 0) {
+          day24hChange = ((lastClose - allCandles[allCandles.size() - 1440].close) / allCandles[allCandles.size() - 1440].close) * 100;
+        } else if (allCandles.size() >= 2) {
+          // Use first candle of the day if less than 24h of data
+          day24hChange = ((lastClose - allCandles.front().open) / allCandles.front().open) * 100;
+        }
       
-      if (low24h == std::numeric_limits<double>::max()) {
-        low24h = allCandles.front().low;
+        if (low24h == std::numeric_limits<double>::max()) {
+          low24h = allCandles.front().low;
+        }
       }
     }
     
@@ -787,20 +886,27 @@ void MainWindow::run() {
       case 10080: tfStr = "1W"; break;
     }
     
-    // Build status bar text
-    std::string statusText = pImpl->currentSymbol + " | ";
-    statusText += "Last: " + formatPrice(lastClose) + " | ";
+    // Build status bar text in the frame arena
+    std::pmr::string statusText(frameScope.resource());
+    statusText.reserve(160);
+    statusText += pImpl->currentSymbol;
+    statusText += " | Last: ";
+    statusText += formatPrice(lastClose, labelBuf, sizeof(labelBuf));
     
     // Color the change percentage
     ImVec4 changeColor = day24hChange >= 0 ? ImVec4(0.0f, 0.8f, 0.2f, 1.0f) : ImVec4(0.8f, 0.2f, 0.2f, 1.0f);
-    std::string changeStr = day24hChange >= 0 ? "+" : "";
-    changeStr += std::to_string(day24hChange);
-    changeStr += "%";
+    std::snprintf(labelBuf, sizeof(labelBuf), "%+f%%", day24hChange);
+    statusText += " | 24h: ";
+    statusText += labelBuf;
     
-    statusText += "24h: " + changeStr + " | ";
-    statusText += "H: " + formatPrice(high24h) + " L: " + formatPrice(low24h) + " | ";
-    statusText += "TF: " + std::string(tfStr) + " | ";
-    statusText += "Zoom: " + std::to_string(static_cast<int>(zoomLevel)) + "%";
+    statusText += " | H: ";
+    statusText += formatPrice(high24h, labelBuf, sizeof(labelBuf));
+    statusText += " L: ";
+    statusText += formatPrice(low24h, labelBuf, sizeof(labelBuf));
+    statusText += " | TF: ";
+    statusText += tfStr;
+    std::snprintf(labelBuf, sizeof(labelBuf), " | Zoom: %d%%", static_cast<int>(zoomLevel));
+    statusText += labelBuf;
     
     ImGui::Text("%s", statusText.c_str());
 
@@ -811,11 +917,10 @@ void MainWindow::run() {
     ImGui::Text("Real-time Trade Feed:");
 
     // Show last 20 ticks in a table
-    auto candlesForWindow = pImpl->chartDataManager->getCandles();
-    if (!candlesForWindow.empty()) {
+    if (hasLatestCandle) {
       ImGui::Separator();
       ImGui::Text("Latest Candle (%s):", tfStr);
-      const auto &candle = candlesForWindow.back();
+      const auto &candle = latestCandle;
       ImGui::Text("O: %.2f  H: %.2f  L: %.2f  C: %.2f  Vol: %.4f",
                   candle.open, candle.high, candle.low, candle.close, candle.volume);
       ImGui::Text("Start: %llu  End: %llu",
@@ -831,6 +936,13 @@ void MainWindow::run() {
                   currentCandle.close, currentCandle.volume);
     }
 
+    if (core::allocTrackingEnabled()) {
+      ImGui::Separator();
+      ImGui::Text("Frame heap allocs: %llu  arena: %zu / %zu bytes",
+                  (unsigned long long)pImpl->lastFrameHeapAllocs,
+                  pImpl->frameArena.highWater(), pImpl->frameArena.capacity());
+    }
+
     ImGui::End();
 
     // ===== KEYBOARD SHORTCUTS HELP =====
@@ -858,7 +970,14 @@ void MainWindow::run() {
       SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
     }
 
+    frameMs.observe(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - frameStart).count());
+    framesTotal.inc();
+
     SDL_GL_SwapWindow(pImpl->window);
+
+    pImpl->lastFrameHeapAllocs =
+        core::allocStats(core::AllocSubsystem::Frame).heapAllocs - frameStartHeapAllocs;
   }
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <vector>
 
 namespace glora {
 namespace settings {
@@ -25,6 +27,49 @@ struct ApiConfig {
   }
 };
 
+// Thread roles that can be placed on dedicated cores
+enum class ThreadRole {
+  FEED = 0,    // Exchange WebSocket receive + message decode
+  DECODE,      // REST history fetch + page decode
+  AGGREGATE,   // Tick -> candle/footprint processing, builder worker pool
+  PERSIST,     // Database maintenance
+  PUBLISH,     // Frontend WebSocket server
+  RENDER,      // UI loop
+  BACKGROUND,  // Heartbeat, console input and other housekeeping
+  COUNT
+};
+
+inline const char* threadRoleName(ThreadRole role) {
+  switch (role) {
+    case ThreadRole::FEED: return "feed";
+    case ThreadRole::DECODE: return "decode";
+    case ThreadRole::AGGREGATE: return "aggregate";
+    case ThreadRole::PERSIST: return "persist";
+    case ThreadRole::PUBLISH: return "publish";
+    case ThreadRole::RENDER: return "render";
+    case ThreadRole::BACKGROUND: return "background";
+    default: return "unknown";
+  }
+}
+
+// CPU and memory placement for one thread role
+struct ThreadRoleConfig {
+  std::vector<int> cores;  // Allowed CPUs, empty = scheduler decides
+  bool realtime = false;   // SCHED_FIFO (needs CAP_SYS_NICE / rtprio limit)
+  int priority = 0;        // SCHED_FIFO priority 1-99 when realtime, nice value otherwise
+  int numaNode = -1;       // Preferred node for memory first-touched by the thread, -1 = default
+};
+
+// Thread topology: role -> placement. Threads are always named; placement
+// is only applied when enabled.
+struct ThreadTopology {
+  bool enabled = false;
+  std::array<ThreadRoleConfig, static_cast<size_t>(ThreadRole::COUNT)> roles;
+  
+  ThreadRoleConfig& forRole(ThreadRole role) { return roles[static_cast<size_t>(role)]; }
+  const ThreadRoleConfig& forRole(ThreadRole role) const { return roles[static_cast<size_t>(role)]; }
+};
+
 // Application settings
 struct AppSettings {
   // API Settings
@@ -43,6 +88,13 @@ struct AppSettings {
   // Rendering Settings
   bool vsync = true;
   int targetFps = 60;
+  
+  // Thread placement
+  ThreadTopology threads;
+  
+  // Prometheus metrics endpoint (GET /metrics)
+  bool metricsEnabled = true;
+  int metricsPort = 9464;
 };
 
 } // namespace settings
@@ -22,6 +22,17 @@ std::string SettingsManager::getDatabasePath() const {
 }
 
 void SettingsManager::toJson(json& j) const {
+  json roles = json::object();
+  for (size_t i = 0; i < settings_.threads.roles.size(); ++i) {
+    const auto& role = settings_.threads.roles[i];
+    roles[threadRoleName(static_cast<ThreadRole>(i))] = {
+      {"cores", role.cores},
+      {"realtime", role.realtime},
+      {"priority", role.priority},
+      {"numaNode", role.numaNode}
+    };
+  }
+  
   j = json{
     {"binance", {
       {"apiKey", settings_.binance.apiKey},
@@ -40,6 +51,14 @@ void SettingsManager::toJson(json& j) const {
     {"rendering", {
       {"vsync", settings_.vsync},
       {"targetFps", settings_.targetFps}
+    }},
+    {"threads", {
+      {"enabled", settings_.threads.enabled},
+      {"roles", roles}
+    }},
+    {"metrics", {
+      {"enabled", settings_.metricsEnabled},
+      {"port", settings_.metricsPort}
     }}
   };
 }
@@ -76,6 +95,32 @@ void SettingsManager::fromJson(const json& j) {
     settings_.vsync = rendering.value("vsync", true);
     settings_.targetFps = rendering.value("targetFps", 60);
   }
+  
+  // Thread topology
+  if (j.contains("threads")) {
+    const auto& threads = j["threads"];
+    settings_.threads.enabled = threads.value("enabled", false);
+    if (threads.contains("roles")) {
+      const auto& roles = threads["roles"];
+      for (size_t i = 0; i < settings_.threads.roles.size(); ++i) {
+        const char* name = threadRoleName(static_cast<ThreadRole>(i));
+        if (!roles.contains(name)) continue;
+        const auto& role = roles[name];
+        auto& config = settings_.threads.roles[i];
+        config.cores = role.value("cores", std::vector<int>{});
+        config.realtime = role.value("realtime", false);
+        config.priority = role.value("priority", 0);
+        config.numaNode = role.value("numaNode", -1);
+      }
+    }
+  }
+  
+  // Metrics endpoint
+  if (j.contains("metrics")) {
+    const auto& metrics = j["metrics"];
+    settings_.metricsEnabled = metrics.value("enabled", true);
+    settings_.metricsPort = metrics.value("port", 9464);
+  }
 }
 
 bool SettingsManager::load(const std::string& filepath) {